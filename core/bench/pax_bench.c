@@ -0,0 +1,510 @@
+// SPDX-License-Identifier: MIT
+
+#include "pax_gfx.h"
+#include "pax_internal.h"
+#include "pax_renderer.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Width and height of the buffers used for benchmarking.
+#define BENCH_SIZE       256
+// Minimum time to spend on each benchmark, in seconds.
+#define BENCH_MIN_SEC    0.2
+// Minimum time to spend on each render function benchmark, in seconds; there are a lot of them.
+#define BENCH_DRAW_SEC   0.05
+// Number of draw calls made between joins in the render function benchmarks.
+#define BENCH_DRAW_BATCH 16
+
+// Optional filter from the command line; only benchmarks with it in their name, type or implementation run.
+static char const *bench_filter;
+
+// Whether a benchmark is selected by the filter.
+static bool bench_selected(char const *bench, char const *type, char const *impl) {
+    return !bench_filter || strstr(bench, bench_filter) || strstr(type, bench_filter) || strstr(impl, bench_filter);
+}
+
+// Get the current time in seconds.
+static double bench_now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Print one benchmark result as a line of JSON.
+static void
+    bench_report(char const *bench, char const *type, char const *impl, double pixels, double calls, double sec) {
+    printf(
+        "{\"bench\":\"%s\",\"type\":\"%s\",\"impl\":\"%s\",\"mpixels_per_sec\":%.3f,\"calls_per_sec\":%.1f}\n",
+        bench,
+        type,
+        impl,
+        pixels / sec * 1e-6,
+        calls / sec
+    );
+}
+
+// Time a range setter or merger on every row of a buffer with a translucent color.
+static void bench_range(
+    pax_buf_t *buf, char const *bench, char const *type, char const *impl, pax_range_setter_t func
+) {
+    if (!bench_selected(bench, type, impl)) {
+        return;
+    }
+    double start = bench_now();
+    double calls = 0;
+    double now;
+    do {
+        for (int y = 0; y < buf->height; y++) {
+            func(buf, 0x7f3f7fbf + y, y * buf->width, buf->width);
+        }
+        calls += buf->height;
+        now    = bench_now();
+    } while (now - start < BENCH_MIN_SEC);
+    bench_report(bench, type, impl, calls * buf->width, calls, now - start);
+}
+
+#if CONFIG_PAX_RANGE_MERGER
+// Compare the scalar and vectorized range mergers.
+// These are the innermost loop of translucent rects and triangles.
+static void bench_range_mergers() {
+    static struct {
+        pax_buf_type_t     type;
+        char const        *name;
+        pax_range_setter_t scalar;
+    #if PAX_SIMD_X86 || PAX_SIMD_NEON
+        pax_range_setter_t v16;
+    #endif
+    } const types[] = {
+    #if PAX_SIMD_X86 || PAX_SIMD_NEON
+        {PAX_BUF_32_8888ARGB, "PAX_BUF_32_8888ARGB", pax_range_merger_8888argb, pax_range_merger_8888argb_v16},
+        {PAX_BUF_24_888RGB, "PAX_BUF_24_888RGB", pax_range_merger_888rgb, pax_range_merger_888rgb_v16},
+        {PAX_BUF_16_565RGB, "PAX_BUF_16_565RGB", pax_range_merger_565rgb, pax_range_merger_565rgb_v16},
+    #else
+        {PAX_BUF_32_8888ARGB, "PAX_BUF_32_8888ARGB", pax_range_merger_8888argb},
+        {PAX_BUF_24_888RGB, "PAX_BUF_24_888RGB", pax_range_merger_888rgb},
+        {PAX_BUF_16_565RGB, "PAX_BUF_16_565RGB", pax_range_merger_565rgb},
+    #endif
+    };
+    for (size_t i = 0; i < sizeof(types) / sizeof(*types); i++) {
+        pax_buf_t buf;
+        pax_buf_init(&buf, NULL, BENCH_SIZE, BENCH_SIZE, types[i].type);
+        bench_range(&buf, "range_merger", types[i].name, "scalar", types[i].scalar);
+    #if PAX_SIMD_X86 || PAX_SIMD_NEON
+        bench_range(&buf, "range_merger", types[i].name, "v16", types[i].v16);
+        // The widest implementation this CPU supports; the one `pax_get_setters` picks.
+        bench_range(&buf, "range_merger", types[i].name, "simd", pax_get_simd_range_merger(types[i].type));
+    #endif
+        pax_buf_destroy(&buf);
+    }
+}
+#endif
+
+#if CONFIG_PAX_RANGE_SETTER
+// Compare the scalar and vectorized range setters.
+// These are the innermost loop of opaque rects and triangles.
+static void bench_range_setters() {
+    static struct {
+        pax_buf_type_t     type;
+        char const        *name;
+        pax_range_setter_t scalar;
+    #if PAX_SIMD_X86 || PAX_SIMD_NEON
+        pax_range_setter_t v16;
+    #endif
+    } const types[] = {
+    #if PAX_SIMD_X86 || PAX_SIMD_NEON
+        {PAX_BUF_32_8888ARGB, "PAX_BUF_32_8888ARGB", pax_range_setter_32bpp, pax_range_setter_32bpp_v16},
+        {PAX_BUF_24_888RGB, "PAX_BUF_24_888RGB", pax_range_setter_24bpp, pax_range_setter_24bpp_v16},
+        {PAX_BUF_16_565RGB, "PAX_BUF_16_565RGB", pax_range_setter_16bpp, pax_range_setter_16bpp_v16},
+    #else
+        {PAX_BUF_32_8888ARGB, "PAX_BUF_32_8888ARGB", pax_range_setter_32bpp},
+        {PAX_BUF_24_888RGB, "PAX_BUF_24_888RGB", pax_range_setter_24bpp},
+        {PAX_BUF_16_565RGB, "PAX_BUF_16_565RGB", pax_range_setter_16bpp},
+    #endif
+    };
+    for (size_t i = 0; i < sizeof(types) / sizeof(*types); i++) {
+        pax_buf_t buf;
+        pax_buf_init(&buf, NULL, BENCH_SIZE, BENCH_SIZE, types[i].type);
+        bench_range(&buf, "range_setter", types[i].name, "scalar", types[i].scalar);
+    #if PAX_SIMD_X86 || PAX_SIMD_NEON
+        bench_range(&buf, "range_setter", types[i].name, "v16", types[i].v16);
+        // The widest implementation this CPU supports; the one `pax_get_setters` picks.
+        bench_range(&buf, "range_setter", types[i].name, "simd", pax_get_simd_range_setter(&buf));
+    #endif
+        pax_buf_destroy(&buf);
+    }
+}
+
+// Compare filling a whole 1080p buffer with the scalar range setter and with `pax_fill_rows`,
+// which uses non-temporal stores for buffers this large where it can.
+static void bench_background() {
+    static struct {
+        pax_buf_type_t     type;
+        char const        *name;
+        pax_range_setter_t scalar;
+    } const types[] = {
+        {PAX_BUF_32_8888ARGB, "PAX_BUF_32_8888ARGB", pax_range_setter_32bpp},
+        {PAX_BUF_24_888RGB, "PAX_BUF_24_888RGB", pax_range_setter_24bpp},
+        {PAX_BUF_16_565RGB, "PAX_BUF_16_565RGB", pax_range_setter_16bpp},
+    };
+    for (size_t i = 0; i < sizeof(types) / sizeof(*types); i++) {
+        pax_buf_t buf;
+        pax_buf_init(&buf, NULL, 1920, 1080, types[i].type);
+        for (int impl = 0; impl < 2; impl++) {
+            if (!bench_selected("background", types[i].name, impl ? "fill_rows" : "scalar")) {
+                continue;
+            }
+            double start = bench_now();
+            double calls = 0;
+            double now;
+            do {
+                if (impl) {
+                    pax_fill_rows(&buf, 0x3f7fbf + (int)calls, 0, buf.height);
+                } else {
+                    types[i].scalar(&buf, 0x3f7fbf + (int)calls, 0, buf.width * buf.height);
+                }
+                calls++;
+                now = bench_now();
+            } while (now - start < BENCH_MIN_SEC);
+            double pixels = calls * buf.width * buf.height;
+            bench_report("background", types[i].name, impl ? "fill_rows" : "scalar", pixels, calls, now - start);
+        }
+        pax_buf_destroy(&buf);
+    }
+}
+#endif
+
+// Everything the render function benchmarks draw with.
+typedef struct {
+    // The buffer to draw to.
+    pax_buf_t   *buf;
+    // An image of the same type as `buf`, for blits.
+    pax_buf_t   *image;
+    // A translucent ARGB image, for sprites, scaled images and the texture shader.
+    pax_buf_t   *texture;
+    // A texture shader of `texture`.
+    pax_shader_t shader;
+    // The color to draw with.
+    pax_col_t    color;
+    // The number of pixels covered by the text benchmark.
+    double       text_pixels;
+} bench_ctx_t;
+
+// Shapes drawn by the render function benchmarks.
+static pax_rectf const       bench_rect       = {16, 16, 224, 224};
+static pax_quadf const       bench_quad       = {16, 8, 240, 32, 224, 240, 32, 216};
+static pax_trif const        bench_tri        = {8, 8, 248, 40, 64, 248};
+static pax_linef const       bench_line       = {0.5, 0.5, 250.5, 190.5};
+// Lines between whole pixels take the integer line walk.
+static pax_linef const       bench_line_int   = {0, 0, 250, 190};
+static pax_linef const       bench_hline      = {0, 100, 250, 100};
+static pax_ellipsef const    bench_ellipse    = {128, 128, 112, 0, 0, 112, 0};
+static pax_round_rectf const bench_round_rect = {16.5, 16.5, 224, 224, 24, 24, 24, 24};
+// The outline of `bench_quad`, for the polygon benchmark.
+static pax_vec2f const bench_poly_points[] = {{16, 8}, {240, 32}, {224, 240}, {32, 216}};
+static size_t const    bench_poly_len      = 4;
+// Text drawn by the text benchmark.
+static char const      bench_text[] = "The quick brown fox jumps";
+// An 8x16 1bpp glyph drawn by the `blit_char` benchmark.
+static uint8_t const   bench_glyph[16]
+    = {0x00, 0x18, 0x3c, 0x66, 0x66, 0x66, 0x7e, 0x7e, 0x66, 0x66, 0x66, 0x66, 0x66, 0x00, 0x00, 0x00};
+// Palette used for palette type buffers.
+static pax_col_t const bench_palette[16] = {
+    0xff000000, 0xffffffff, 0xffff0000, 0xff00ff00, 0xff0000ff, 0xffffff00, 0xffff00ff, 0xff00ffff,
+    0xff7f7f7f, 0x7fffffff, 0x7fff0000, 0x7f00ff00, 0x7f0000ff, 0x7fffff00, 0x7fff00ff, 0x00000000,
+};
+
+// Area of a triangle.
+static double bench_tri_area(pax_trif tri) {
+    return fabs((tri.x1 - tri.x0) * (tri.y2 - tri.y0) - (tri.x2 - tri.x0) * (tri.y1 - tri.y0)) / 2;
+}
+
+// Area of a convex quad.
+static double bench_quad_area(pax_quadf quad) {
+    return bench_tri_area((pax_trif){quad.x0, quad.y0, quad.x1, quad.y1, quad.x2, quad.y2})
+           + bench_tri_area((pax_trif){quad.x0, quad.y0, quad.x2, quad.y2, quad.x3, quad.y3});
+}
+
+// Number of pixels along a line.
+static double bench_line_length(pax_linef line) {
+    return fmax(fabs(line.x1 - line.x0), fabs(line.y1 - line.y0)) + 1;
+}
+
+// The render function benchmarks; each draws once and returns how many pixels it covered.
+static double bench_draw_background(bench_ctx_t *ctx) {
+    pax_dispatch_background(ctx->buf, ctx->color);
+    return ctx->buf->width * ctx->buf->height;
+}
+static double bench_draw_unshaded_line(bench_ctx_t *ctx) {
+    pax_dispatch_unshaded_line(ctx->buf, ctx->color, bench_line);
+    return bench_line_length(bench_line);
+}
+static double bench_draw_unshaded_line_int(bench_ctx_t *ctx) {
+    pax_dispatch_unshaded_line(ctx->buf, ctx->color, bench_line_int);
+    return bench_line_length(bench_line_int);
+}
+static double bench_draw_unshaded_hline(bench_ctx_t *ctx) {
+    pax_dispatch_unshaded_line(ctx->buf, ctx->color, bench_hline);
+    return bench_line_length(bench_hline);
+}
+static double bench_draw_unshaded_rect(bench_ctx_t *ctx) {
+    pax_dispatch_unshaded_rect(ctx->buf, ctx->color, bench_rect);
+    return bench_rect.w * bench_rect.h;
+}
+static double bench_draw_unshaded_quad(bench_ctx_t *ctx) {
+    pax_dispatch_unshaded_quad(ctx->buf, ctx->color, bench_quad);
+    return bench_quad_area(bench_quad);
+}
+static double bench_draw_unshaded_tri(bench_ctx_t *ctx) {
+    pax_dispatch_unshaded_tri(ctx->buf, ctx->color, bench_tri);
+    return bench_tri_area(bench_tri);
+}
+static double bench_draw_unshaded_quad_aa(bench_ctx_t *ctx) {
+    pax_dispatch_unshaded_quad_aa(ctx->buf, ctx->color, bench_quad);
+    return bench_quad_area(bench_quad);
+}
+static double bench_draw_unshaded_tri_aa(bench_ctx_t *ctx) {
+    pax_dispatch_unshaded_tri_aa(ctx->buf, ctx->color, bench_tri);
+    return bench_tri_area(bench_tri);
+}
+static double bench_draw_unshaded_poly(bench_ctx_t *ctx) {
+    pax_polyf shape = {
+        .points       = bench_poly_points,
+        .contour_lens = &bench_poly_len,
+        .n_contours   = 1,
+        .rule         = PAX_FILL_NONZERO,
+    };
+    pax_dispatch_unshaded_poly(ctx->buf, ctx->color, shape);
+    return bench_quad_area(bench_quad);
+}
+static double bench_draw_unshaded_ellipse(bench_ctx_t *ctx) {
+    pax_dispatch_unshaded_ellipse(ctx->buf, ctx->color, bench_ellipse);
+    return M_PI * bench_ellipse.ux * bench_ellipse.vy;
+}
+static double bench_draw_unshaded_round_rect(bench_ctx_t *ctx) {
+    pax_dispatch_unshaded_round_rect(ctx->buf, ctx->color, bench_round_rect);
+    return bench_round_rect.w * bench_round_rect.h - (4 - M_PI) * bench_round_rect.r0 * bench_round_rect.r0;
+}
+static double bench_draw_unshaded_round_rect_aa(bench_ctx_t *ctx) {
+    pax_dispatch_unshaded_round_rect_aa(ctx->buf, ctx->color, bench_round_rect);
+    return bench_round_rect.w * bench_round_rect.h - (4 - M_PI) * bench_round_rect.r0 * bench_round_rect.r0;
+}
+static double bench_draw_shaded_line(bench_ctx_t *ctx) {
+    pax_dispatch_shaded_line(ctx->buf, ctx->color, bench_line, &ctx->shader, (pax_linef){0, 0, 1, 0});
+    return bench_line_length(bench_line);
+}
+static double bench_draw_shaded_rect(bench_ctx_t *ctx) {
+    pax_dispatch_shaded_rect(ctx->buf, ctx->color, bench_rect, &ctx->shader, (pax_quadf){0, 0, 1, 0, 1, 1, 0, 1});
+    return bench_rect.w * bench_rect.h;
+}
+static double bench_draw_shaded_quad(bench_ctx_t *ctx) {
+    pax_dispatch_shaded_quad(ctx->buf, ctx->color, bench_quad, &ctx->shader, (pax_quadf){0, 0, 1, 0, 1, 1, 0, 1});
+    return bench_quad_area(bench_quad);
+}
+static double bench_draw_shaded_tri(bench_ctx_t *ctx) {
+    pax_dispatch_shaded_tri(ctx->buf, ctx->color, bench_tri, &ctx->shader, (pax_trif){0, 0, 1, 0, 0, 1});
+    return bench_tri_area(bench_tri);
+}
+static double bench_draw_scaled_image(bench_ctx_t *ctx) {
+    pax_dispatch_scaled_image(ctx->buf, ctx->texture, (pax_recti){16, 16, 224, 224}, PAX_O_UPRIGHT, false);
+    return 224 * 224;
+}
+static double bench_draw_sprite(bench_ctx_t *ctx) {
+    pax_recti pos = {96, 96, ctx->texture->width, ctx->texture->height};
+    pax_dispatch_sprite(ctx->buf, ctx->texture, pos, PAX_O_UPRIGHT, (pax_vec2i){0, 0});
+    return pos.w * pos.h;
+}
+static double bench_draw_blit(bench_ctx_t *ctx) {
+    pax_recti pos = {96, 96, ctx->image->width, ctx->image->height};
+    pax_dispatch_blit(ctx->buf, ctx->image, pos, PAX_O_UPRIGHT, (pax_vec2i){0, 0});
+    return pos.w * pos.h;
+}
+static double bench_draw_blit_raw(bench_ctx_t *ctx) {
+    pax_vec2i dims = {ctx->image->width, ctx->image->height};
+    pax_recti pos  = {96, 96, dims.x, dims.y};
+    pax_dispatch_blit_raw(ctx->buf, ctx->image->buf, dims, pos, PAX_O_UPRIGHT, (pax_vec2i){0, 0});
+    return pos.w * pos.h;
+}
+static double bench_draw_blit_char(bench_ctx_t *ctx) {
+    pax_text_rsdata_t rsdata = {.w = 8, .h = 16, .bpp = 1, .row_stride = 1, .bitmap = bench_glyph};
+    pax_dispatch_blit_char(ctx->buf, ctx->color, (pax_vec2i){96, 64}, 4, rsdata);
+    return 8 * 4 * 16 * 4;
+}
+static double bench_draw_text(bench_ctx_t *ctx) {
+    pax_dispatch_text(
+        ctx->buf,
+        matrix_2d_identity(),
+        ctx->color,
+        pax_font_saira_regular,
+        18,
+        (pax_vec2f){4, 100},
+        bench_text,
+        sizeof(bench_text) - 1,
+        PAX_ALIGN_BEGIN,
+        PAX_ALIGN_BEGIN,
+        -1
+    );
+    return ctx->text_pixels;
+}
+
+// Every entry of `pax_render_funcs_t` except `join`, which every benchmark calls.
+static struct {
+    char const *name;
+    double (*draw)(bench_ctx_t *ctx);
+} const bench_funcs[] = {
+    {"background", bench_draw_background},
+    {"unshaded_line", bench_draw_unshaded_line},
+    {"unshaded_line_int", bench_draw_unshaded_line_int},
+    {"unshaded_hline", bench_draw_unshaded_hline},
+    {"unshaded_rect", bench_draw_unshaded_rect},
+    {"unshaded_quad", bench_draw_unshaded_quad},
+    {"unshaded_tri", bench_draw_unshaded_tri},
+    {"unshaded_quad_aa", bench_draw_unshaded_quad_aa},
+    {"unshaded_tri_aa", bench_draw_unshaded_tri_aa},
+    {"unshaded_poly", bench_draw_unshaded_poly},
+    {"unshaded_ellipse", bench_draw_unshaded_ellipse},
+    {"unshaded_round_rect", bench_draw_unshaded_round_rect},
+    {"unshaded_round_rect_aa", bench_draw_unshaded_round_rect_aa},
+    {"shaded_line", bench_draw_shaded_line},
+    {"shaded_rect", bench_draw_shaded_rect},
+    {"shaded_quad", bench_draw_shaded_quad},
+    {"shaded_tri", bench_draw_shaded_tri},
+    {"scaled_image", bench_draw_scaled_image},
+    {"sprite", bench_draw_sprite},
+    {"blit", bench_draw_blit},
+    {"blit_raw", bench_draw_blit_raw},
+    {"blit_char", bench_draw_blit_char},
+    {"text", bench_draw_text},
+};
+
+// Every buffer type.
+static struct {
+    pax_buf_type_t type;
+    char const    *name;
+} const bench_types[] = {
+#define PAX_DEF_BUF_TYPE(bpp, name) {name, #name},
+#include "helpers/pax_buf_type.inc"
+};
+
+// Select the soft renderer.
+static void bench_engine_soft() {
+    pax_set_render_engine_default();
+}
+#if CONFIG_PAX_COMPILE_ASYNC_RENDERER
+// Select the async renderer with one worker.
+static void bench_engine_softasync() {
+    pax_set_renderer_async(false);
+}
+#endif
+#if CONFIG_PAX_COMPILE_ASYNC_RENDERER == 2
+// Select the async renderer with one worker per CPU core.
+static void bench_engine_softasync_mt() {
+    pax_set_renderer_async(true);
+}
+#endif
+
+// Every render engine.
+static struct {
+    char const *name;
+    void (*select)();
+} const bench_engines[] = {
+    {"soft", bench_engine_soft},
+#if CONFIG_PAX_COMPILE_ASYNC_RENDERER
+    {"softasync", bench_engine_softasync},
+#endif
+#if CONFIG_PAX_COMPILE_ASYNC_RENDERER == 2
+    {"softasync_mt", bench_engine_softasync_mt},
+#endif
+};
+
+// Set up the buffers for the render function benchmarks for one buffer type.
+static void bench_ctx_init(bench_ctx_t *ctx, pax_buf_type_t type) {
+    ctx->buf     = malloc(sizeof(pax_buf_t));
+    ctx->image   = malloc(sizeof(pax_buf_t));
+    ctx->texture = malloc(sizeof(pax_buf_t));
+    pax_buf_init(ctx->buf, NULL, BENCH_SIZE, BENCH_SIZE, type);
+    pax_buf_init(ctx->image, NULL, 64, 64, type);
+    pax_buf_init(ctx->texture, NULL, 64, 64, PAX_BUF_32_8888ARGB);
+
+    bool palette = ctx->buf->type_info.fmt_type == PAX_BUF_SUBTYPE_PALETTE;
+    if (palette) {
+        size_t len = ctx->buf->type_info.bpp < 4 ? 1 << ctx->buf->type_info.bpp : 16;
+        pax_buf_set_palette_rom(ctx->buf, bench_palette, len);
+        pax_buf_set_palette_rom(ctx->image, bench_palette, len);
+    }
+    for (int y = 0; y < 64; y++) {
+        for (int x = 0; x < 64; x++) {
+            pax_col_t color = pax_col_argb(x * 8 > y * 4 ? 255 : y * 4, x * 4, y * 4, (x ^ y) * 4);
+            pax_set_pixel(ctx->texture, color, x, y);
+            pax_set_pixel(ctx->image, palette ? (x ^ y) & 1 : color, x, y);
+        }
+    }
+    pax_join();
+
+    ctx->shader      = PAX_SHADER_TEXTURE(ctx->texture);
+    ctx->color       = palette ? 1 : 0xff3f7fbf;
+    pax_vec2f size   = pax_text_size(pax_font_saira_regular, 18, bench_text);
+    ctx->text_pixels = size.x * size.y;
+}
+
+// Free the buffers for the render function benchmarks.
+static void bench_ctx_destroy(bench_ctx_t *ctx) {
+    pax_buf_destroy(ctx->buf);
+    pax_buf_destroy(ctx->image);
+    pax_buf_destroy(ctx->texture);
+    free(ctx->buf);
+    free(ctx->image);
+    free(ctx->texture);
+}
+
+// Time every render function on every buffer type with every render engine.
+// The time includes waiting for the async renderer to finish drawing.
+static void bench_render_funcs() {
+    for (size_t e = 0; e < sizeof(bench_engines) / sizeof(*bench_engines); e++) {
+        bench_engines[e].select();
+        for (size_t t = 0; t < sizeof(bench_types) / sizeof(*bench_types); t++) {
+            bench_ctx_t ctx;
+            bench_ctx_init(&ctx, bench_types[t].type);
+            for (size_t f = 0; f < sizeof(bench_funcs) / sizeof(*bench_funcs); f++) {
+                if (!bench_selected(bench_funcs[f].name, bench_types[t].name, bench_engines[e].name)) {
+                    continue;
+                }
+                double start  = bench_now();
+                double pixels = 0;
+                double calls  = 0;
+                double now;
+                do {
+                    for (int i = 0; i < BENCH_DRAW_BATCH; i++) {
+                        pixels += bench_funcs[f].draw(&ctx);
+                    }
+                    calls += BENCH_DRAW_BATCH;
+                    pax_buf_join(ctx.buf);
+                    now = bench_now();
+                } while (now - start < BENCH_DRAW_SEC);
+                bench_report(bench_funcs[f].name, bench_types[t].name, bench_engines[e].name, pixels, calls, now - start);
+            }
+            bench_ctx_destroy(&ctx);
+        }
+    }
+    pax_set_render_engine_default();
+}
+
+// Usage: pax_bench [filter]
+// Prints one line of JSON per benchmark; see `bench_report` for the format.
+int main(int argc, char **argv) {
+    if (argc > 1) {
+        bench_filter = argv[1];
+    }
+#if CONFIG_PAX_RANGE_MERGER
+    bench_range_mergers();
+#endif
+#if CONFIG_PAX_RANGE_SETTER
+    bench_range_setters();
+    bench_background();
+#endif
+    bench_render_funcs();
+    return 0;
+}
@@ -0,0 +1,131 @@
+// SPDX-License-Identifier: MIT
+
+#include "pax_gfx.h"
+#include "pax_renderer.h"
+#include "renderer/pax_renderer_softasync.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Number of times the capture is replayed with each render engine if not specified.
+#define REPLAY_PASSES 10
+
+// Get the current time in seconds.
+static double replay_now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// Hash the contents of every buffer in the capture with FNV-1a, to check that render engines draw the same pixels.
+static uint64_t replay_hash(pax_capture_t *capture) {
+    uint64_t hash = 0xcbf29ce484222325;
+    for (size_t i = 0; i < pax_capture_n_bufs(capture); i++) {
+        pax_buf_t     *buf  = pax_capture_get_buf(capture, i);
+        uint8_t const *data = pax_buf_get_pixels(buf);
+        size_t         size = pax_buf_calc_size_dynamic(buf->width, buf->height, buf->type);
+        for (size_t j = 0; j < size; j++) {
+            hash = (hash ^ data[j]) * 0x100000001b3;
+        }
+    }
+    return hash;
+}
+
+// Select the soft renderer.
+static void replay_engine_soft() {
+    pax_set_render_engine_default();
+}
+#if CONFIG_PAX_COMPILE_ASYNC_RENDERER
+// Select the async renderer with one worker.
+static void replay_engine_softasync() {
+    pax_set_renderer_async(false);
+}
+// Select the async renderer with one worker, discarding draw calls hidden by later opaque ones.
+static void replay_engine_softasync_deferred() {
+    pax_sasr_config_t config = {.workers = 1, .deferred = true};
+    pax_set_renderer(&pax_render_engine_softasync, &config);
+}
+#endif
+#if CONFIG_PAX_COMPILE_ASYNC_RENDERER == 2
+// Select the async renderer with one worker per CPU core.
+static void replay_engine_softasync_mt() {
+    pax_set_renderer_async(true);
+}
+#endif
+
+// Every render engine.
+static struct {
+    char const *name;
+    void (*select)();
+} const replay_engines[] = {
+    {"soft", replay_engine_soft},
+#if CONFIG_PAX_COMPILE_ASYNC_RENDERER
+    {"softasync", replay_engine_softasync},
+    {"softasync_deferred", replay_engine_softasync_deferred},
+#endif
+#if CONFIG_PAX_COMPILE_ASYNC_RENDERER == 2
+    {"softasync_mt", replay_engine_softasync_mt},
+#endif
+};
+
+// Usage: pax_replay <capture> [passes] [engine]
+// Replays a capture made with `pax_capture_start` with every render engine, or only the one named.
+// Prints one line of JSON per render engine with the average time per replay and a hash of the resulting pixels.
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <capture> [passes] [engine]\n", argv[0]);
+        return 1;
+    }
+    int         passes = argc > 2 ? atoi(argv[2]) : REPLAY_PASSES;
+    char const *filter = argc > 3 ? argv[3] : NULL;
+    if (passes < 1) {
+        fprintf(stderr, "Number of passes must be at least 1\n");
+        return 1;
+    }
+
+    FILE *fd = fopen(argv[1], "rb");
+    if (!fd) {
+        perror(argv[1]);
+        return 1;
+    }
+    pax_capture_t *capture = pax_capture_load(fd);
+    fclose(fd);
+    if (!capture) {
+        return 1;
+    }
+
+    for (size_t e = 0; e < sizeof(replay_engines) / sizeof(*replay_engines); e++) {
+        if (filter && strcmp(filter, replay_engines[e].name)) {
+            continue;
+        }
+        replay_engines[e].select();
+        // The first pass creates the buffers and warms up caches, so it is not timed.
+        pax_capture_replay(capture);
+        pax_join();
+
+        double start = replay_now();
+        for (int i = 0; i < passes; i++) {
+            pax_capture_replay(capture);
+        }
+        pax_join();
+        double sec = replay_now() - start;
+
+        printf(
+            "{\"capture\":\"%s\",\"impl\":\"%s\",\"calls\":%zu,\"ms_per_pass\":%.3f,\"calls_per_sec\":%.1f,"
+            "\"hash\":\"%016" PRIx64 "\"}\n",
+            argv[1],
+            replay_engines[e].name,
+            pax_capture_len(capture),
+            sec / passes * 1e3,
+            pax_capture_len(capture) * passes / sec,
+            replay_hash(capture)
+        );
+    }
+
+    pax_set_render_engine_default();
+    pax_capture_free(capture);
+    return 0;
+}
@@ -13,93 +13,6 @@ extern "C" {
 
 // clang-format off
 
-// Multi-core method for unshaded lines.
-// If odd_scanline is true, the odd (counted from 0) lines are drawn, otherwise the even lines are drawn.
-void paxmcr_line_shaded(
-    bool                odd_scanline,
-    pax_buf_t          *buf,
-    pax_col_t           color,
-    pax_shader_t const *shader,
-    float x0, float y0, float x1, float y1,
-    float u0, float v0, float u1, float v1
-);
-
-// Multi-core method for shaded triangles.
-// If odd_scanline is true, the odd (counted from 0) lines are drawn, otherwise the even lines are drawn.
-void paxmcr_tri_shaded(
-    bool                odd_scanline,
-    pax_buf_t          *buf,
-    pax_col_t           color,
-    pax_shader_t const *shader,
-    float x0, float y0, float x1, float y1, float x2, float y2,
-    float u0, float v0, float u1, float v1, float u2, float v2
-);
-
-// Internal method for shaded quads.
-// If odd_scanline is true, the odd (counted from 0) lines are drawn, otherwise the even lines are drawn.
-void paxmcr_quad_shaded(
-    bool                odd_scanline,
-    pax_buf_t          *buf,
-    pax_col_t           color,
-    pax_shader_t const *shader,
-    float x0, float y0, float x1, float y1, float x2, float y2, float x3, float y3,
-    float u0, float v0, float u1, float v1, float u2, float v2, float u3, float v3
-);
-
-//  Multi-core optimisation which maps a buffer directly onto another.
-// If odd_scanline is true, the odd (counted from 0) lines are drawn, otherwise the even lines are drawn.
-void paxmcr_overlay_buffer(
-    bool odd_scanline, pax_buf_t *base, pax_buf_t *top,
-    int x, int y, int width, int height,
-    bool assume_opaque
-);
-
-//  Multi-core  method for shaded rects.
-// If odd_scanline is true, the odd (counted from 0) lines are drawn, otherwise the even lines are drawn.
-void paxmcr_rect_shaded(
-    bool                odd_scanline,
-    pax_buf_t          *buf,
-    pax_col_t           color,
-    pax_shader_t const *shader,
-    float x, float y, float width, float height,
-    float u0, float v0, float u1, float v1, float u2, float v2, float u3, float v3
-);
-
-
-
-// Multi-core method for unshaded lines.
-// If odd_scanline is true, the odd (counted from 0) lines are drawn, otherwise the even lines are drawn.
-void paxmcr_line_unshaded(
-    bool odd_scanline, pax_buf_t *buf, pax_col_t color,
-    float x0, float y0, float x1, float y1
-);
-
-// Multi-core method for unshaded triangles.
-// Assumes points are sorted by Y.
-// If odd_scanline is true, the odd (counted from 0) lines are drawn, otherwise the even lines are drawn.
-void paxmcr_tri_unshaded(
-    bool odd_scanline, pax_buf_t *buf, pax_col_t color,
-    float x0, float y0, float x1, float y1, float x2, float y2
-);
-
-// Internal method for shaded quads.
-// If odd_scanline is true, the odd (counted from 0) lines are drawn, otherwise the even lines are drawn.
-void paxmcr_quad_unshaded(
-    bool                odd_scanline,
-    pax_buf_t          *buf,
-    pax_col_t           color,
-    float x0, float y0, float x1, float y1, float x2, float y2, float x3, float y3
-);
-
-// Multi-core method for unshaded rects.
-// If odd_scanline is true, the odd (counted from 0) lines are drawn, otherwise the even lines are drawn.
-void paxmcr_rect_unshaded(
-    bool odd_scanline, pax_buf_t *buf, pax_col_t color,
-    float x, float y, float width, float height
-);
-
-
-
 // Internal method for shaded triangles.
 // Assumes points are sorted by Y.
 void pax_tri_shaded(
@@ -161,6 +74,44 @@ void pax_quad_unshaded(
     float x0, float y0, float x1, float y1, float x2, float y2, float x3, float y3
 );
 
+// Internal method for anti-aliased unshaded triangles.
+void pax_tri_unshaded_aa(
+    pax_buf_t *buf, pax_col_t color,
+    float x0, float y0, float x1, float y1, float x2, float y2
+);
+
+// Internal method for anti-aliased unshaded quads.
+void pax_quad_unshaded_aa(
+    pax_buf_t *buf,
+    pax_col_t  color,
+    float x0, float y0, float x1, float y1, float x2, float y2, float x3, float y3
+);
+
+// Callback for a span of `len` pixels from (`x`, `y`) to the right.
+typedef void (*pax_span_cb_t)(void *args, int x, int y, int len);
+
+// Internal method that finds the spans of pixels inside a polygon within the clip rectangle, from the top row down.
+void pax_poly_spans(pax_buf_t const *buf, pax_polyf shape, pax_span_cb_t callback, void *args);
+
+// Internal method for unshaded polygons.
+void pax_poly_unshaded(pax_buf_t *buf, pax_col_t color, pax_polyf shape);
+
+// Internal method that finds the spans of pixels inside an ellipse within the clip rectangle, from the top row down.
+void pax_ellipse_spans(pax_buf_t const *buf, pax_ellipsef shape, pax_span_cb_t callback, void *args);
+
+// Internal method for unshaded ellipses.
+void pax_ellipse_unshaded(pax_buf_t *buf, pax_col_t color, pax_ellipsef shape);
+
+// Internal method that finds the spans of pixels inside a rounded rectangle within the clip rectangle, from the top row
+// down.
+void pax_round_rect_spans(pax_buf_t const *buf, pax_round_rectf shape, pax_span_cb_t callback, void *args);
+
+// Internal method for unshaded rounded rectangles.
+void pax_round_rect_unshaded(pax_buf_t *buf, pax_col_t color, pax_round_rectf shape);
+
+// Internal method for anti-aliased unshaded rounded rectangles.
+void pax_round_rect_unshaded_aa(pax_buf_t *buf, pax_col_t color, pax_round_rectf shape);
+
 // Internal method for rectangle drawing.
 void pax_rect_unshaded(
     pax_buf_t *buf, pax_col_t color,
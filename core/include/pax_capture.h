@@ -0,0 +1,49 @@
+
+// SPDX-License-Identifier: MIT
+
+#ifndef PAX_CAPTURE_H
+#define PAX_CAPTURE_H
+
+#include "pax_types.h"
+
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif //__cplusplus
+
+/* ======= DRAW CALL CAPTURE ======= */
+
+// Draw calls read back from a capture file.
+typedef struct pax_capture pax_capture_t;
+
+// Start writing every draw call made to any buffer to `fd`, for replaying later with `pax_capture_replay`.
+// The format, size, palette, contents, clip rectangle and orientation of buffers are written when they are first used.
+// Texture shaders and fonts are written by reference to the built-in ones; other shaders are replaced when replayed.
+// Returns `false` if a capture is already in progress, writing fails or capture is not compiled in.
+bool pax_capture_start(FILE *fd);
+// Stop capturing draw calls; `fd` is flushed but not closed.
+void pax_capture_stop();
+
+// Read a capture written by `pax_capture_start`.
+// Returns `NULL` if `fd` does not contain a valid capture or out of memory.
+pax_capture_t *pax_capture_load(FILE *fd);
+// Free a capture read by `pax_capture_load` and the buffers it replays into.
+void           pax_capture_free(pax_capture_t *capture);
+// Replay every draw call in a capture through the default render context.
+// Buffers are restored to the state they were captured in first, so a capture can be replayed any number of times.
+// Call `pax_join` afterwards to wait for drawing to finish.
+void           pax_capture_replay(pax_capture_t *capture);
+// Get the number of draw calls in a capture.
+size_t         pax_capture_len(pax_capture_t const *capture);
+// Get the number of buffers a capture draws to or from.
+size_t         pax_capture_n_bufs(pax_capture_t const *capture);
+// Get a buffer a capture draws to or from, in the order they were first used; `NULL` if out of range.
+// Buffers are only valid after the capture has been replayed at least once.
+pax_buf_t     *pax_capture_get_buf(pax_capture_t *capture, size_t index);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif //__cplusplus
+
+#endif // PAX_CAPTURE_H
@@ -86,16 +86,55 @@
     #define CONFIG_PAX_RANGE_MERGER true
 #endif
 
+#ifndef CONFIG_PAX_USE_SIMD
+    // Use SIMD instructions for setters and mergers where the CPU supports them.
+    // Only has an effect on x86 and ARM CPUs with NEON.
+    #define CONFIG_PAX_USE_SIMD true
+#endif
+
 #ifndef CONFIG_PAX_COMPILE_ORIENTATION
     // Compile in buffer orientation settings.
     #define CONFIG_PAX_COMPILE_ORIENTATION true
 #endif
 
 #ifndef CONFIG_PAX_QUEUE_SIZE
-    // Queue size to use for multi-core rendering.
+    // Number of tasks that can be queued for each async renderer worker.
+    // Tasks are stored compactly, so this many of the largest kind fit and more of the smaller kinds.
     #define CONFIG_PAX_QUEUE_SIZE 32
 #endif
 
+#ifndef CONFIG_PAX_ASYNC_MAX_WORKERS
+    // Maximum number of worker threads the async renderer can use.
+    #define CONFIG_PAX_ASYNC_MAX_WORKERS 16
+#endif
+
+#ifndef CONFIG_PAX_ASYNC_BANDS_PER_WORKER
+    // Number of bands of rows the async renderer splits buffers into per worker thread.
+    // Idle workers take over the bands of busy ones, so more bands balance better but cost more per draw call.
+    #define CONFIG_PAX_ASYNC_BANDS_PER_WORKER 4
+#endif
+
+#ifndef CONFIG_PAX_ASYNC_MAX_CONTEXTS
+    // Maximum number of render contexts that can use the async renderer at once.
+    #define CONFIG_PAX_ASYNC_MAX_CONTEXTS 8
+#endif
+
+#ifndef CONFIG_PAX_ASYNC_ARENA_BLOCK
+    // Size in bytes of the blocks each async render context allocates task data from.
+    #define CONFIG_PAX_ASYNC_ARENA_BLOCK 4096
+#endif
+
+#ifndef CONFIG_PAX_STATS
+    // Gather rendering statistics and allow recording traces of drawing, see `pax_stats.h`.
+    // WARNING: Enabling slows down drawing, even when no trace is being recorded.
+    #define CONFIG_PAX_STATS false
+#endif
+
+#ifndef CONFIG_PAX_COMPILE_CAPTURE
+    // Compile in capturing draw calls to a file and replaying them, see `pax_capture.h`.
+    #define CONFIG_PAX_COMPILE_CAPTURE true
+#endif
+
 #ifndef CONFIG_PAX_USE_FIXED_POINT
     // Whether to use fixed-point arithmetic internally.
     #define CONFIG_PAX_USE_FIXED_POINT true
@@ -0,0 +1,39 @@
+
+// SPDX-License-Identifier: MIT
+
+#ifndef PAX_DLIST_H
+#define PAX_DLIST_H
+
+#include "pax_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif //__cplusplus
+
+/* ======== DISPLAY LISTS ======== */
+
+// Initialize an empty display list where the `pax_dlist_t` struct is user-managed.
+void pax_dlist_init(pax_dlist_t *list);
+// De-initialize a display list initialized by `pax_dlist_init`.
+void pax_dlist_destroy(pax_dlist_t *list);
+// Remove all recorded draw calls from a display list.
+void pax_dlist_clear(pax_dlist_t *list);
+
+// Start recording draw calls made to `buf` into `list` instead of drawing them.
+// Shapes are recorded after the matrix transform and orientation are applied to them;
+// the clip rectangle is applied when the list is replayed.
+// Shaders, images and fonts used while recording are referenced, not copied, and must outlive the list.
+void pax_dlist_begin(pax_dlist_t *list, pax_buf_t *buf);
+// Stop recording draw calls made to `buf`.
+void pax_dlist_end(pax_buf_t *buf);
+
+// Draw everything recorded in `list` to `buf`, offset by `x` and `y`.
+// The buffer should have the same orientation as the one the list was recorded with.
+// The current clip rectangle of `buf` applies, the matrix stack does not.
+void pax_dlist_replay(pax_dlist_t const *list, pax_buf_t *buf, int x, int y);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif //__cplusplus
+
+#endif // PAX_DLIST_H
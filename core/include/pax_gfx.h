@@ -4,10 +4,13 @@
 #ifndef PAX_GFX_H
 #define PAX_GFX_H
 
+#include "pax_capture.h"
+#include "pax_dlist.h"
 #include "pax_fonts.h"
 #include "pax_orientation.h"
 #include "pax_shaders.h"
 #include "pax_shapes.h"
+#include "pax_stats.h"
 #include "pax_text.h"
 #include "pax_types.h"
 #include "shapes/pax_arcs.h"
@@ -32,14 +35,30 @@ char const *pax_desc_err(pax_err_t error);
 
 /* ===== RENDER ENGINE HOUSEKEEPING ==== */
 
-// Wait for all pending drawing operations to finish.
+// Wait for all pending drawing operations of the default render context to finish.
 void pax_join();
+// Wait for all pending drawing operations of the render context `buf` draws through to finish.
+void pax_buf_join(pax_buf_t *buf);
+// Insert a fence after all drawing operations queued so far in the default render context.
+pax_fence_t pax_insert_fence();
+// Insert a fence after all drawing operations queued so far in the render context `buf` draws through.
+// If `callback` is not NULL, it is called with `cookie` once the fence completes, possibly from a worker thread;
+// it should return quickly and may not draw or wait for anything.
+pax_fence_t pax_buf_insert_fence(pax_buf_t *buf, pax_fence_cb_t callback, void *cookie);
+// Wait for all drawing operations queued before a fence to finish.
+void        pax_fence_wait(pax_fence_t fence);
+// Check whether all drawing operations queued before a fence have finished, without waiting.
+bool        pax_fence_poll(pax_fence_t fence);
 // Set the render engine to synchronous software renderer.
 void pax_set_render_engine_default();
 // Enable the asynchronous renderer.
 // If `multithreaded` is `true` and `CONFIG_PAX_COMPILE_ASYNC_RENDERER` is set to `2`,
-// This will use two threads for rendering instead of just one.
+// This will use one thread per CPU core for rendering instead of just one.
 void pax_set_renderer_async(bool multithreaded);
+// Enable the asynchronous renderer with a specific number of worker threads.
+// If `workers` is less than 1, one worker is started per CPU core.
+// Each worker renders its own band of rows, so large buffers scale with the number of workers.
+void pax_set_renderer_async_workers(int workers);
 
 
 /* ============ BUFFER =========== */
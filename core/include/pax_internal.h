@@ -124,6 +124,16 @@ extern bool            pax_log_use_mutex;
 // Whether multi-core rendering is enabled.
 extern bool pax_do_multicore;
 
+// Render functions that record draw calls into `buf->dlist` instead of drawing them.
+extern pax_render_funcs_t const pax_render_funcs_dlist;
+
+#if CONFIG_PAX_COMPILE_CAPTURE
+// Whether draw calls are currently being captured; see `pax_capture_start`.
+extern bool                     pax_capturing;
+// Render functions that write draw calls to the capture before drawing them.
+extern pax_render_funcs_t const pax_render_funcs_capture;
+#endif
+
 // Swap two variables.
 #define PAX_SWAP(type, a, b)                                                                                           \
     {                                                                                                                  \
@@ -168,6 +178,93 @@ static inline void pax_set_ok() {
 
 
 
+/* ========= STATISTICS ========== */
+
+#if CONFIG_PAX_STATS
+// Counters of the current thread, added to the totals when the task it is running finishes.
+typedef struct {
+    // Number of pixels overwritten with an opaque color.
+    uint64_t pixels_filled;
+    // Number of pixels blended with the color already in the buffer.
+    uint64_t pixels_blended;
+    // Number of pixels colored by a shader.
+    uint64_t shader_calls;
+} pax_stats_local_t;
+
+// Counters of the current thread.
+extern __thread pax_stats_local_t pax_stats_local;
+
+// Get the current time in nanoseconds.
+uint64_t pax_stats_time();
+// Count a draw call that started at `start` and add the counters of the current thread to the totals.
+void     pax_stats_task(pax_task_type_t type, uint64_t start);
+// Count a draw call that was dropped because it was entirely outside the clip rectangle.
+void     pax_stats_cull();
+// Count `count` queued async renderer commands that were discarded because a later opaque draw covered them.
+void     pax_stats_hide(size_t count);
+// Count a task that an async renderer worker ran for a band owned by worker `owner`, starting at `start`.
+void     pax_stats_exec(pax_task_type_t type, int owner, uint64_t start);
+// Count a wait for a render context or a fence that started at `start`.
+void     pax_stats_wait(char const *name, uint64_t start);
+// Update the high-water mark of bytes of commands waiting in an async renderer band.
+void     pax_stats_queue_depth(size_t depth);
+// Called by async renderer worker threads when they start.
+void     pax_stats_worker_start(int index);
+
+// Count `count` pixels that were either blended or filled.
+static inline void pax_stats_pixels(bool blended, int count) {
+    if (blended) {
+        pax_stats_local.pixels_blended += count;
+    } else {
+        pax_stats_local.pixels_filled += count;
+    }
+}
+
+    // Declare `var` holding the current time, for measuring how long something takes.
+    #define PAX_STATS_START(var)                    uint64_t var = pax_stats_time()
+    // Count a draw call that started at `start`, see `pax_stats_task`.
+    #define PAX_STATS_TASK(type, start)             pax_stats_task((type), (start))
+    // Count a draw call that was dropped because it was entirely outside the clip rectangle.
+    #define PAX_STATS_CULL()                        pax_stats_cull()
+    // Count `count` queued async renderer commands that were discarded because a later opaque draw covered them.
+    #define PAX_STATS_HIDE(count)                   pax_stats_hide(count)
+    // Count a task run by an async renderer worker, see `pax_stats_exec`.
+    #define PAX_STATS_EXEC(type, owner, start)      pax_stats_exec((type), (owner), (start))
+    // Count a wait for a render context or a fence that started at `start`.
+    #define PAX_STATS_WAIT(name, start)             pax_stats_wait((name), (start))
+    // Update the high-water mark of bytes of commands waiting in an async renderer band.
+    #define PAX_STATS_QUEUE_DEPTH(depth)            pax_stats_queue_depth(depth)
+    // Called by async renderer worker threads when they start.
+    #define PAX_STATS_WORKER_START(index)           pax_stats_worker_start(index)
+    // Count `count` pixels that were either blended or filled.
+    #define PAX_STATS_PIXELS(blended, count)        pax_stats_pixels((blended), (count))
+    // Count `count` pixels set by an index setter returned by `pax_get_setter`.
+    #define PAX_STATS_SET(setter, count)            pax_stats_pixels((setter) == pax_merge_index, (count))
+    // Count `count` pixels set by a range setter of `buf` returned by `pax_get_range_setter`.
+    #define PAX_STATS_SET_RANGE(buf, setter, count) pax_stats_pixels((setter) == (buf)->range_merger, (count))
+    // Count `count` pixels colored by a shader and set by an index setter returned by `pax_get_setter`.
+    #define PAX_STATS_SHADE(setter, count)                                                                             \
+        do {                                                                                                           \
+            PAX_STATS_SET(setter, count);                                                                              \
+            pax_stats_local.shader_calls += (count);                                                                   \
+        } while (0)
+#else
+    #define PAX_STATS_START(var)
+    #define PAX_STATS_TASK(type, start)             ((void)0)
+    #define PAX_STATS_CULL()                        ((void)0)
+    #define PAX_STATS_HIDE(count)                   ((void)0)
+    #define PAX_STATS_EXEC(type, owner, start)      ((void)0)
+    #define PAX_STATS_WAIT(name, start)             ((void)0)
+    #define PAX_STATS_QUEUE_DEPTH(depth)            ((void)0)
+    #define PAX_STATS_WORKER_START(index)           ((void)0)
+    #define PAX_STATS_PIXELS(blended, count)        ((void)0)
+    #define PAX_STATS_SET(setter, count)            ((void)0)
+    #define PAX_STATS_SET_RANGE(buf, setter, count) ((void)0)
+    #define PAX_STATS_SHADE(setter, count)          ((void)0)
+#endif
+
+
+
 /* ===== GETTERS AND SETTERS ===== */
 
 // Gets the index getters and setters for the given buffer.
@@ -178,6 +275,9 @@ void pax_get_setters(
     pax_range_setter_t *range_setter,
     pax_range_setter_t *range_merger
 );
+// Sets a raw value on rows `y0` up to `y1` of the buffer, like a background fill does.
+// Large fills use non-temporal stores where the CPU has them, because the buffer won't stay in the cache anyway.
+void pax_fill_rows(pax_buf_t *buf, pax_col_t value, int y0, int y1);
 
 // Gets the most efficient index setter for the occasion.
 // Also converts the color, if applicable.
@@ -270,6 +370,82 @@ void pax_range_setter_generic(pax_buf_t *buf, pax_col_t color, int index, int co
 void pax_range_merger_generic(pax_buf_t *buf, pax_col_t color, int index, int count);
 #endif
 
+#if CONFIG_PAX_USE_SIMD && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__                                                   \
+    && (CONFIG_PAX_RANGE_MERGER || CONFIG_PAX_RANGE_SETTER)
+    #if defined(__x86_64__) || defined(__i386__)
+        // SSE2 and AVX2 versions of the setters and mergers are compiled in, selected at runtime.
+        #define PAX_SIMD_X86  1
+    #elif defined(__ARM_NEON)
+        // NEON versions of the setters and mergers are compiled in.
+        #define PAX_SIMD_NEON 1
+    #endif
+#endif
+
+#if (PAX_SIMD_X86 || PAX_SIMD_NEON) && CONFIG_PAX_RANGE_MERGER
+// Get a vectorized range merger for the given buffer type, if there is one for this CPU.
+pax_range_setter_t pax_get_simd_range_merger(pax_buf_type_t type);
+
+// Merges a single 32-bit ARGB color into a range of 32-bit ARGB pixels, 16 bytes at a time.
+void pax_range_merger_8888argb_v16(pax_buf_t *buf, pax_col_t color, int index, int count);
+// Merges a single 32-bit ARGB color into a range of 24-bit RGB pixels, 16 bytes at a time.
+void pax_range_merger_888rgb_v16(pax_buf_t *buf, pax_col_t color, int index, int count);
+// Merges a single 32-bit ARGB color into a range of 16-bit RGB pixels, 16 bytes at a time.
+void pax_range_merger_565rgb_v16(pax_buf_t *buf, pax_col_t color, int index, int count);
+    #if PAX_SIMD_X86
+// Merges a single 32-bit ARGB color into a range of 32-bit ARGB pixels, 32 bytes at a time; requires AVX2.
+void pax_range_merger_8888argb_v32(pax_buf_t *buf, pax_col_t color, int index, int count);
+// Merges a single 32-bit ARGB color into a range of 24-bit RGB pixels, 32 bytes at a time; requires AVX2.
+void pax_range_merger_888rgb_v32(pax_buf_t *buf, pax_col_t color, int index, int count);
+// Merges a single 32-bit ARGB color into a range of 16-bit RGB pixels, 32 bytes at a time; requires AVX2.
+void pax_range_merger_565rgb_v32(pax_buf_t *buf, pax_col_t color, int index, int count);
+    #endif
+#endif
+
+#if (PAX_SIMD_X86 || PAX_SIMD_NEON) && CONFIG_PAX_RANGE_SETTER
+// Get a vectorized range setter for the given buffer, if there is one for this CPU.
+pax_range_setter_t pax_get_simd_range_setter(pax_buf_t const *buf);
+// Sets a raw value on a large range of pixels with non-temporal stores, in the byte order of `buf`.
+// Returns false if the range is too small to benefit or the buffer type isn't supported.
+bool               pax_simd_stream_setter(pax_buf_t *buf, pax_col_t value, int index, int count);
+
+    #define PAX_SIMD_DECL_RANGE_SETTERS(width)                                                                         \
+        void pax_range_setter_16bpp_v##width(pax_buf_t *buf, pax_col_t color, int index, int count);                   \
+        void pax_range_setter_24bpp_v##width(pax_buf_t *buf, pax_col_t color, int index, int count);                   \
+        void pax_range_setter_32bpp_v##width(pax_buf_t *buf, pax_col_t color, int index, int count);                   \
+        void pax_range_setter_16bpp_rev_v##width(pax_buf_t *buf, pax_col_t color, int index, int count);               \
+        void pax_range_setter_24bpp_rev_v##width(pax_buf_t *buf, pax_col_t color, int index, int count);               \
+        void pax_range_setter_32bpp_rev_v##width(pax_buf_t *buf, pax_col_t color, int index, int count);
+// Sets a raw value range from a 16, 24 or 32BPP buffer, 16 bytes at a time.
+PAX_SIMD_DECL_RANGE_SETTERS(16)
+    #if PAX_SIMD_X86
+// Sets a raw value range from a 16, 24 or 32BPP buffer, 32 bytes at a time; requires AVX2.
+PAX_SIMD_DECL_RANGE_SETTERS(32)
+    #endif
+    #undef PAX_SIMD_DECL_RANGE_SETTERS
+#endif
+
+// Checks that a range of pixels is within the buffer if `CONFIG_PAX_BOUNDS_CHECK` is enabled.
+static inline void __attribute__((always_inline))
+getter_setter_bounds_check(pax_buf_t const *buf, int index, int length) {
+#if !CONFIG_PAX_BOUNDS_CHECK
+    (void)buf;
+    (void)index;
+    (void)length;
+#else
+    if (index < 0 || (length > 0 && (index + length < index || index + length > buf->width * buf->height))) {
+        PAX_LOGE(
+            "pax",
+            "Frame buffer access out of bounds: index %d, length %d on a %dx%d buffer",
+            index,
+            length,
+            buf->width,
+            buf->height
+        );
+        abort();
+    }
+#endif
+}
+
 
 // Gets based on index instead of coordinates.
 // Does no bounds checking nor color conversion.
@@ -451,6 +627,13 @@ static inline float pax_flerp4(float x, float y, float e0, float e1, float e2, f
     return a + (b - a) * y;
 }
 
+// Bounding box of an ellipse.
+static inline pax_rectf pax_ellipse_bounds(pax_ellipsef shape) {
+    float w = sqrtf(shape.ux * shape.ux + shape.vx * shape.vx);
+    float h = sqrtf(shape.uy * shape.uy + shape.vy * shape.vy);
+    return (pax_rectf){shape.x - w, shape.y - h, 2 * w, 2 * h};
+}
+
 // Reverse endianness for 16-bit things.
 PAX_PERF_CRITICAL_ATTR static inline uint16_t pax_rev_endian_16(uint16_t in) {
     return (in >> 8) | (in << 8);
@@ -473,8 +656,50 @@ PAX_PERF_CRITICAL_ATTR static inline uint32_t pax_rev_endian_32(uint32_t in) {
 // Gets the correct callback function for the shader.
 pax_shader_ctx_t pax_get_shader_ctx(pax_buf_t *buf, pax_col_t color, pax_shader_t const *shader);
 
-// The scheduler for multicore rendering.
-void paxmcr_add_task(pax_task_t *task);
+// The maximum number of pixels passed to a span shader at once.
+#define PAX_SHADER_SPAN_MAX 64
+
+// Shade `count` pixels of row `y` starting at `x` with the span callback of a shader context.
+static inline void pax_shade_span(
+    pax_buf_t              *buf,
+    pax_col_t               tint,
+    pax_shader_ctx_t const *ctx,
+    pax_index_setter_t      setter,
+    pax_col_conv_t          buf2col,
+    int                     x,
+    int                     y,
+    int                     count,
+    float                   u,
+    float                   v,
+    float                   du,
+    float                   dv
+) {
+    pax_col_t pixels[PAX_SHADER_SPAN_MAX];
+    int       index = x + y * buf->width;
+    PAX_STATS_SHADE(setter, count);
+    for (int done = 0; done < count; done += PAX_SHADER_SPAN_MAX) {
+        int n = count - done < PAX_SHADER_SPAN_MAX ? count - done : PAX_SHADER_SPAN_MAX;
+        for (int i = 0; i < n; i++) {
+            pixels[i] = ctx->do_getter ? buf2col(buf, buf->getter(buf, index + done + i)) : 0;
+        }
+        ctx->span_callback(
+            tint,
+            pixels,
+            pixels,
+            x + done,
+            y,
+            n,
+            u + done * du,
+            v + done * dv,
+            du,
+            dv,
+            ctx->span_args
+        );
+        for (int i = 0; i < n; i++) {
+            setter(buf, pixels[i], index + done + i);
+        }
+    }
+}
 
 // Internal method for rendering text and calculating text size.
 pax_2vec2f pax_internal_text_generic(
@@ -486,6 +711,10 @@ pax_2vec2f pax_internal_text_generic(
     pax_align_t        halign,
     pax_align_t        valign
 );
+// Draw a glyph laid out by `pax_internal_text_generic` using the given render functions.
+void pax_text_draw_glyph(
+    pax_render_funcs_t const *funcs, pax_buf_t *buf, pax_col_t color, pax_text_glyph_t const *glyph
+);
 
 
 
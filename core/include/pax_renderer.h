@@ -26,6 +26,18 @@ void pax_dispatch_unshaded_rect(pax_buf_t *buf, pax_col_t color, pax_rectf shape
 void pax_dispatch_unshaded_quad(pax_buf_t *buf, pax_col_t color, pax_quadf shape);
 // Draw a solid-colored triangle.
 void pax_dispatch_unshaded_tri(pax_buf_t *buf, pax_col_t color, pax_trif shape);
+// Draw a solid-colored quad with anti-aliased edges.
+void pax_dispatch_unshaded_quad_aa(pax_buf_t *buf, pax_col_t color, pax_quadf shape);
+// Draw a solid-colored triangle with anti-aliased edges.
+void pax_dispatch_unshaded_tri_aa(pax_buf_t *buf, pax_col_t color, pax_trif shape);
+// Draw a solid-colored polygon.
+void pax_dispatch_unshaded_poly(pax_buf_t *buf, pax_col_t color, pax_polyf shape);
+// Draw a solid-colored ellipse or elliptic ring.
+void pax_dispatch_unshaded_ellipse(pax_buf_t *buf, pax_col_t color, pax_ellipsef shape);
+// Draw a solid-colored rectangle with rounded corners.
+void pax_dispatch_unshaded_round_rect(pax_buf_t *buf, pax_col_t color, pax_round_rectf shape);
+// Draw a solid-colored rectangle with rounded corners and anti-aliased edges.
+void pax_dispatch_unshaded_round_rect_aa(pax_buf_t *buf, pax_col_t color, pax_round_rectf shape);
 
 // Draw a line with a shader.
 void pax_dispatch_shaded_line(
@@ -84,9 +96,27 @@ void pax_dispatch_text(
 
 /* ==== Render engine management API ==== */
 
-// Change the active render engine.
+// Change the render engine of the default render context, used by buffers without a render context of their own.
 void pax_set_renderer(pax_render_engine_t const *engine, void *init_cookie);
 
+// Create a new render context with its own instance of `engine`.
+// Buffers using different render contexts can be drawn to concurrently from different threads.
+pax_render_ctx_t *pax_render_ctx_create(pax_render_engine_t const *engine, void *init_cookie);
+// Destroy a render context after waiting for its pending drawing operations to finish.
+// No buffers may use the context afterwards.
+void              pax_render_ctx_destroy(pax_render_ctx_t *ctx);
+// Wait for all pending drawing operations of a render context to finish.
+void              pax_render_ctx_join(pax_render_ctx_t *ctx);
+// Insert a fence after all drawing operations queued so far in a render context.
+// If `callback` is not NULL, it is called with `cookie` once the fence completes.
+pax_fence_t       pax_render_ctx_insert_fence(pax_render_ctx_t *ctx, pax_fence_cb_t callback, void *cookie);
+
+// Set the render context `buf` draws through; `NULL` selects the default context.
+// Waits for pending drawing operations of the previous context to finish.
+void              pax_buf_set_render_ctx(pax_buf_t *buf, pax_render_ctx_t *ctx);
+// Get the render context `buf` draws through.
+pax_render_ctx_t *pax_get_render_ctx(pax_buf_t const *buf);
+
 
 
 #ifdef __cplusplus
@@ -16,12 +16,54 @@ extern "C" {
 
 // Texture shader for bitmap fonts on palette buffers.
 pax_col_t pax_shader_font_bmp_pal(pax_col_t tint, pax_col_t existing, int x, int y, float u, float v, void *args);
+// Span texture shader for bitmap fonts on palette buffers.
+void pax_shader_font_bmp_pal_span(
+    pax_col_t        tint,
+    pax_col_t const *existing,
+    pax_col_t       *out,
+    int              x,
+    int              y,
+    int              count,
+    float            u,
+    float            v,
+    float            du,
+    float            dv,
+    void            *args
+);
 
 // Texture shader for bitmap fonts.
 pax_col_t pax_shader_font_bmp(pax_col_t tint, pax_col_t existing, int x, int y, float u, float v, void *args);
+// Span texture shader for bitmap fonts.
+void pax_shader_font_bmp_span(
+    pax_col_t        tint,
+    pax_col_t const *existing,
+    pax_col_t       *out,
+    int              x,
+    int              y,
+    int              count,
+    float            u,
+    float            v,
+    float            du,
+    float            dv,
+    void            *args
+);
 
 // Texture shader for bitmap fonts with linear interpolation.
 pax_col_t pax_shader_font_bmp_aa(pax_col_t tint, pax_col_t existing, int x, int y, float u, float v, void *args);
+// Span texture shader for bitmap fonts with linear interpolation.
+void pax_shader_font_bmp_aa_span(
+    pax_col_t        tint,
+    pax_col_t const *existing,
+    pax_col_t       *out,
+    int              x,
+    int              y,
+    int              count,
+    float            u,
+    float            v,
+    float            du,
+    float            dv,
+    void            *args
+);
 
 /* ========== TEXTURES =========== */
 
@@ -29,22 +71,52 @@ pax_col_t pax_shader_font_bmp_aa(pax_col_t tint, pax_col_t existing, int x, int
 // Texture format is pax_but_t*.
 #define PAX_SHADER_TEXTURE(texture)                                                                                    \
     (pax_shader_t) {                                                                                                   \
-        .schema_version = 1, .schema_complement = (uint8_t)~1, .renderer_id = PAX_RENDERER_ID_SWR,                     \
-        .promise_callback = NULL, .callback = (void *)pax_shader_texture_aa, .callback_args = (void *)(texture),       \
+        .schema_version = 2, .schema_complement = (uint8_t)~2, .renderer_id = PAX_RENDERER_ID_SWR,                     \
+        .promise_callback = NULL, .callback = (void *)pax_shader_texture_aa_span,                                      \
+        .callback_args = (void *)(texture),                                                                            \
         .alpha_promise_0 = true, .alpha_promise_255 = false                                                            \
     }
 // Create a shader_t of the given texture, assumes the texture is opaque.
 // Texture format is pax_but_t*.
 #define PAX_SHADER_TEXTURE_OP(texture)                                                                                 \
     (pax_shader_t) {                                                                                                   \
-        .schema_version = 1, .schema_complement = (uint8_t)~1, .renderer_id = PAX_RENDERER_ID_SWR,                     \
-        .promise_callback = NULL, .callback = (void *)pax_shader_texture_aa, .callback_args = (void *)(texture),       \
+        .schema_version = 2, .schema_complement = (uint8_t)~2, .renderer_id = PAX_RENDERER_ID_SWR,                     \
+        .promise_callback = NULL, .callback = (void *)pax_shader_texture_aa_span,                                      \
+        .callback_args = (void *)(texture),                                                                            \
         .alpha_promise_0 = true, .alpha_promise_255 = true                                                             \
     }
 // Texture shader without interpolation.
 pax_col_t pax_shader_texture(pax_col_t tint, pax_col_t existing, int x, int y, float u, float v, void *args);
 // Texture shader with interpolation.
 pax_col_t pax_shader_texture_aa(pax_col_t tint, pax_col_t existing, int x, int y, float u, float v, void *args);
+// Span texture shader without interpolation.
+void pax_shader_texture_span(
+    pax_col_t        tint,
+    pax_col_t const *existing,
+    pax_col_t       *out,
+    int              x,
+    int              y,
+    int              count,
+    float            u,
+    float            v,
+    float            du,
+    float            dv,
+    void            *args
+);
+// Span texture shader with interpolation.
+void pax_shader_texture_aa_span(
+    pax_col_t        tint,
+    pax_col_t const *existing,
+    pax_col_t       *out,
+    int              x,
+    int              y,
+    int              count,
+    float            u,
+    float            v,
+    float            du,
+    float            dv,
+    void            *args
+);
 
 #ifdef __cplusplus
 }
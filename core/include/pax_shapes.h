@@ -68,6 +68,31 @@ size_t pax_round_shape(pax_vec2f **output, size_t num_points, pax_vec2f *points,
 */
 
 
+/* ======= POLYGON FILLING ======= */
+
+// Draw a shape based on an outline, filled with the nonzero rule.
+// Closes the shape: no need to have the last point overlap the first.
+// The outline may intersect itself.
+void pax_draw_shape(pax_buf_t *buf, pax_col_t color, size_t num_points, pax_vec2f const *points);
+// Draw a shape based on an outline, filled according to `rule`.
+// Closes the shape: no need to have the last point overlap the first.
+// The outline may intersect itself.
+void pax_draw_shape_rule(
+    pax_buf_t *buf, pax_col_t color, size_t num_points, pax_vec2f const *points, pax_fill_rule_t rule
+);
+// Draw a shape made of one or more outlines, such as one with holes in it, filled according to `rule`.
+// The points of all outlines are in `points`, one after the other, with the number of points of each in `contour_lens`.
+// Closes every outline: no need to have the last point overlap the first.
+void pax_draw_shape_contours(
+    pax_buf_t       *buf,
+    pax_col_t        color,
+    size_t           num_contours,
+    size_t const    *contour_lens,
+    pax_vec2f const *points,
+    pax_fill_rule_t  rule
+);
+
+
 /* ======== TRIANGULATION ======== */
 
 /*
@@ -97,11 +122,6 @@ size_t pax_triang_complete(size_t **output, pax_vec2f **additional_points, size_
 // Stores triangles as triple-index pairs in output, which is a dynamically allocated size_t array.
 // Returns the number of triangles created.
 size_t pax_triang_concave(size_t **output, size_t num_points, pax_vec2f const *points);
-// WARNING: Does not work for self-intersecting polygons.
-//
-// Draw a shape based on an outline.
-// Closes the shape: no need to have the last point overlap the first.
-void   pax_draw_shape(pax_buf_t *buf, pax_col_t color, size_t num_points, pax_vec2f const *points);
 
 // Draws a shape which has been previously triangulated.
 // The number of triangles is num_points - 2.
@@ -0,0 +1,64 @@
+
+// SPDX-License-Identifier: MIT
+
+#ifndef PAX_STATS_H
+#define PAX_STATS_H
+
+#include "pax_types.h"
+
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif //__cplusplus
+
+/* ======== STATISTICS ========= */
+
+// Rendering statistics gathered when PAX is compiled with `CONFIG_PAX_STATS`.
+typedef struct {
+    // Number of draw calls made, by task type; calls recorded into display lists are counted when replayed.
+    uint64_t tasks[PAX_N_TASK_TYPES];
+    // Number of draw calls dropped because they were entirely outside the clip rectangle.
+    uint64_t culled;
+    // Number of band commands a deferred async render context discarded because a later opaque draw covered them.
+    uint64_t hidden;
+    // Number of pixels overwritten with an opaque color.
+    uint64_t pixels_filled;
+    // Number of pixels blended with the color already in the buffer.
+    uint64_t pixels_blended;
+    // Number of pixels colored by a shader.
+    uint64_t shader_calls;
+    // Most bytes of commands waiting in a single async renderer band at once.
+    uint64_t queue_high_water;
+    // Number of times a thread waited for a render context or a fence.
+    uint64_t joins;
+    // Time in microseconds threads spent waiting for render contexts and fences.
+    uint64_t join_wait_us;
+    // Time in microseconds each async renderer worker spent running tasks.
+    uint64_t worker_busy_us[CONFIG_PAX_ASYNC_MAX_WORKERS];
+    // Number of tasks each async renderer worker ran from the bands of other workers.
+    uint64_t worker_stolen[CONFIG_PAX_ASYNC_MAX_WORKERS];
+} pax_stats_t;
+
+// Get the rendering statistics gathered since startup or the last `pax_stats_reset`.
+// Returns `false` if PAX was compiled without `CONFIG_PAX_STATS`.
+bool pax_stats_get(pax_stats_t *out);
+// Set all rendering statistics to zero, for example at the start of a frame.
+void pax_stats_reset();
+
+// Start recording a trace of up to `max_events` draw calls, worker tasks and waits, discarding the previous trace.
+// Must not be called while drawing is in progress.
+// Returns `false` if out of memory or PAX was compiled without `CONFIG_PAX_STATS`.
+bool pax_trace_start(size_t max_events);
+// Stop recording the trace; events recorded so far are kept until the next `pax_trace_start`.
+void pax_trace_stop();
+// Write the recorded trace as Chrome `trace_event` JSON, which can be opened in `chrome://tracing` or Perfetto.
+// Must not be called while drawing is in progress.
+// Returns `false` if nothing was recorded or PAX was compiled without `CONFIG_PAX_STATS`.
+bool pax_trace_write(FILE *fd);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif //__cplusplus
+
+#endif // PAX_STATS_H
@@ -30,7 +30,8 @@ extern "C" {
 #define PAX_FONT_LOADER_VERSION 1
 // The version of the shader schema.
 // Currently, schema version 0 is accepted and is interpreted as shaders as of v1.0.0.
-#define PAX_SHADER_VERSION      1
+// Schema version 1 shades one pixel per callback, schema version 2 shades a horizontal span per callback.
+#define PAX_SHADER_VERSION      2
 // The identifier used by shaders for software rendering.
 // A different ID is interpreted as belonging to an incompatble method of rendering.
 // IDs at and above 0x80 are distributed to third party renderers.
@@ -158,6 +159,14 @@ enum pax_text_align {
     PAX_ALIGN_END,
 };
 
+// How to decide which parts of a polygon with overlapping contours are inside it.
+enum pax_fill_rule {
+    // Inside where the contours wind around a point a nonzero number of times.
+    PAX_FILL_NONZERO,
+    // Inside where a line from a point to infinity crosses the contours an odd number of times.
+    PAX_FILL_EVENODD,
+};
+
 // Type of task to do.
 // Things like text and arcs will decompose to rects and triangles.
 enum pax_task_type {
@@ -185,6 +194,30 @@ enum pax_task_type {
     PAX_TASK_BACKGROUND,
     // Scaled image.
     PAX_TASK_SCALED_IMAGE,
+    // Text that has already been laid out into glyphs.
+    PAX_TASK_GLYPHS,
+    // Polygon draw.
+    PAX_TASK_POLY,
+    // Ellipse draw.
+    PAX_TASK_ELLIPSE,
+    // Rounded rectangle draw.
+    PAX_TASK_ROUND_RECT,
+    // Fence in the task queues of a render context.
+    PAX_TASK_FENCE,
+    // Number of task types.
+    PAX_N_TASK_TYPES,
+};
+
+// Ways to draw a glyph laid out by the text renderer.
+enum pax_glyph_type {
+    // Pixel-aligned integer-scaled glyph, drawn using `blit_char`.
+    PAX_GLYPH_BLIT_CHAR,
+    // Pixel-aligned glyph, drawn using `shaded_rect`.
+    PAX_GLYPH_RECT,
+    // Transformed glyph, drawn using `shaded_quad`.
+    PAX_GLYPH_QUAD,
+    // Text cursor, drawn using `unshaded_line`.
+    PAX_GLYPH_CURSOR,
 };
 
 // Distinguishes between ways to draw fonts.
@@ -201,6 +234,8 @@ typedef enum pax_word_wrap   pax_word_wrap_t;
 typedef enum pax_text_align  pax_align_t;
 typedef enum pax_task_type   pax_task_type_t;
 typedef enum pax_font_type   pax_font_type_t;
+typedef enum pax_glyph_type  pax_glyph_type_t;
+typedef enum pax_fill_rule   pax_fill_rule_t;
 
 // Promises that the shape will be fully opaque when drawn.
 #define PAX_PROMISE_OPAQUE      0x01
@@ -223,23 +258,33 @@ struct pax_font;
 struct pax_font_range;
 
 struct pax_task;
+struct pax_dlist;
+struct pax_render_ctx;
 
 union pax_col_union;
 
 typedef struct pax_buf           pax_buf_t;
 typedef struct pax_shader        pax_shader_t;
 typedef struct pax_task          pax_task_t;
+typedef struct pax_dlist         pax_dlist_t;
 typedef struct pax_shader_ctx    pax_shader_ctx_t;
 typedef struct pax_text_render   pax_text_render_t;
 typedef struct pax_text_rsdata   pax_text_rsdata_t;
+typedef struct pax_text_glyph    pax_text_glyph_t;
+typedef struct pax_glyph_run     pax_glyph_run_t;
 typedef struct pax_rcstr         pax_rcstr_t;
 typedef struct pax_task_str      pax_task_str_t;
+typedef struct pax_polyf         pax_polyf;
+typedef struct pax_ellipsef      pax_ellipsef;
+typedef struct pax_round_rectf   pax_round_rectf;
 typedef struct pax_bmpv          pax_bmpv_t;
 typedef struct pax_font          pax_font_t;
 typedef struct pax_font_range    pax_font_range_t;
 typedef struct pax_buf_type_info pax_buf_type_info_t;
 typedef struct pax_render_funcs  pax_render_funcs_t;
 typedef struct pax_render_engine pax_render_engine_t;
+typedef struct pax_render_ctx    pax_render_ctx_t;
+typedef struct pax_fence         pax_fence_t;
 
 typedef uint32_t            pax_col_t;
 typedef union pax_col_union pax_col_union_t;
@@ -284,6 +329,26 @@ typedef pax_col_t (*pax_shader_func_v0_t)(pax_col_t tint, int x, int y, float u,
 typedef pax_col_t (*pax_shader_func_v1_t)(
     pax_col_t tint, pax_col_t existing, int x, int y, float u, float v, void *args
 );
+// Function pointer for span shader callback.
+// Shades `count` pixels of row `y`, starting at `x`; pixel `i` of the span has UVs `u + i * du` and `v + i * dv`.
+// `existing` holds the current colors of the pixels and the colors to draw are written to `out`,
+// which may be the same array as `existing`.
+typedef void (*pax_shader_func_v2_t)(
+    pax_col_t        tint,
+    pax_col_t const *existing,
+    pax_col_t       *out,
+    int              x,
+    int              y,
+    int              count,
+    float            u,
+    float            v,
+    float            du,
+    float            dv,
+    void            *args
+);
+
+// Function pointer called when a fence completes; see `pax_buf_insert_fence`.
+typedef void (*pax_fence_cb_t)(void *cookie);
 
 // A simple linked list data structure used to store matrices in a stack.
 struct matrix_stack_2d {
@@ -395,6 +460,10 @@ struct pax_shader_ctx {
     pax_shader_func_v1_t callback;
     // The args to throw at the callback.
     void                *callback_args;
+    // The callback used per horizontal span, if the shader has one.
+    pax_shader_func_v2_t span_callback;
+    // The args to throw at the span callback.
+    void                *span_args;
     // Whether to skip drawing.
     bool                 skip;
     // Whether to do a get the pixel value for merging.
@@ -426,6 +495,10 @@ struct pax_text_render {
     matrix_2d_t               matrix;
     // The color to draw with.
     pax_col_t                 color;
+    // If not NULL, glyphs are passed to this instead of being drawn using `renderfuncs`.
+    void (*glyph_cb)(void *args, pax_text_glyph_t const *glyph);
+    // Argument passed to `glyph_cb`.
+    void *glyph_args;
 };
 
 // Internal temporary representation used for text rendering.
@@ -441,6 +514,44 @@ struct pax_text_rsdata {
     uint8_t const *bitmap;
 };
 
+// A single glyph or text cursor laid out by the text renderer, with the matrix and orientation already applied.
+// WARNING: Subject to change at any time for any reason, do not use this type yourself.
+struct pax_text_glyph {
+    // How to draw this glyph.
+    uint8_t              type;
+    // Whether the glyph is drawn as a cutout; either fully opaque or fully transparent.
+    bool                 cutout;
+    // Span shader for `PAX_GLYPH_RECT` and `PAX_GLYPH_QUAD`.
+    pax_shader_func_v2_t shader;
+    // Glyph bitmap; unused for `PAX_GLYPH_CURSOR`.
+    pax_text_rsdata_t    rsdata;
+    union {
+        struct {
+            // Character position.
+            pax_vec2i pos;
+            // Character scale; nonzero.
+            int       scale;
+        } blit_char;
+        // Shape for `PAX_GLYPH_RECT`.
+        pax_rectf rect;
+        // Shape for `PAX_GLYPH_QUAD`.
+        pax_quadf quad;
+        // Shape for `PAX_GLYPH_CURSOR`.
+        pax_linef line;
+    };
+};
+
+// A string of text laid out into glyphs, stored in one or more chunks.
+// WARNING: Subject to change at any time for any reason, do not use this type yourself.
+struct pax_glyph_run {
+    // Next chunk of the same run, if any.
+    pax_glyph_run_t *next;
+    // Number of glyphs in this chunk.
+    uint32_t         len;
+    // Glyph data.
+    pax_text_glyph_t glyphs[];
+};
+
 // Heap-allocated version of `pax_task_str_t`; reference-counted.
 // WARNING: Subject to change at any time for any reason, do not use this type yourself.
 struct pax_rcstr {
@@ -466,6 +577,38 @@ struct pax_task_str {
     };
 };
 
+// A polygon made of one or more closed contours, such as an outline with holes in it.
+// Contours may intersect themselves and each other; `rule` decides which parts are inside.
+struct pax_polyf {
+    // Points of every contour, one contour after the other.
+    pax_vec2f const *points;
+    // Number of points in each contour.
+    size_t const    *contour_lens;
+    // Number of contours.
+    size_t           n_contours;
+    // Which parts of the polygon are inside it.
+    pax_fill_rule_t  rule;
+};
+
+// An ellipse, or an elliptic ring if `inner` is nonzero.
+// Its outline is (`x`, `y`) + (`ux`, `uy`) * cos(a) + (`vx`, `vy`) * sin(a), so any transformed circle is one.
+struct pax_ellipsef {
+    // Center of the ellipse.
+    float x, y;
+    // The two axes, which need not be at right angles to each other.
+    float ux, uy, vx, vy;
+    // Size of the hole in the middle relative to the ellipse, from 0 for none to 1.
+    float inner;
+};
+
+// An axis-aligned rectangle with rounded corners.
+struct pax_round_rectf {
+    // Top-left corner and size; the size must not be negative.
+    float x, y, w, h;
+    // Corner radii, starting top-left and going clockwise; at most half the width and height.
+    float r0, r1, r2, r3;
+};
+
 // A task to perform, used by multicore rendering.
 // Every task has pre-transformed co-ordinates.
 // If you change the shader object's content (AKA the value that args points to),
@@ -484,11 +627,16 @@ struct pax_task {
             pax_shader_t shader;
             // Whether to use a shader.
             bool         use_shader;
+            // Whether to anti-alias the edges of an unshaded triangle or quad.
+            bool         antialias;
         };
         // Text transform matrix.
         // Packed in here because text tasks never use a shader.
         matrix_2d_t text_matrix;
     };
+    // Conservative bounds of the pixels this task may draw to, already intersected with the clip rectangle.
+    // Filled in by the render engine when the task is queued.
+    pax_recti bounds;
 
     union {
         struct {
@@ -525,6 +673,10 @@ struct pax_task {
             // String to draw.
             pax_task_str_t    str;
         } text;
+        // Glyphs to draw.
+        pax_glyph_run_t *glyphs;
+        // Engine-specific fence to signal.
+        void            *fence;
         struct {
             pax_buf_t const  *top;
             pax_recti         base_pos;
@@ -548,6 +700,12 @@ struct pax_task {
         struct {
             pax_linef shape, uvs;
         } linef;
+        // Polygons; the points and contour lengths are owned by the render engine or display list.
+        pax_polyf       polyf;
+        // Ellipses.
+        pax_ellipsef    ellipsef;
+        // Rounded rectangles.
+        pax_round_rectf round_rectf;
     };
     /*
     union {
@@ -591,6 +749,17 @@ struct pax_task {
     */
 };
 
+// A list of recorded draw calls that can be replayed into any buffer.
+// See `pax_dlist_begin` and `pax_dlist_replay`.
+struct pax_dlist {
+    // Recorded draw calls; the `buffer` field is unused.
+    pax_task_t *tasks;
+    // Number of recorded draw calls.
+    size_t      len;
+    // Capacity of `tasks`.
+    size_t      cap;
+};
+
 // The main data structure in PAX.
 // Stores pixel data and matrix information among other things.
 struct pax_buf {
@@ -659,6 +828,11 @@ struct pax_buf {
 
     // Orientation setting.
     pax_orientation_t orientation;
+
+    // Display list that draw calls to this buffer are recorded into instead of drawn, if any.
+    pax_dlist_t      *dlist;
+    // Render context that draw calls to this buffer go through; `NULL` for the default context.
+    pax_render_ctx_t *render_ctx;
 };
 
 // Render engine function table definition.
@@ -675,6 +849,24 @@ struct pax_render_funcs {
     void (*unshaded_quad)(pax_buf_t *buf, pax_col_t color, pax_quadf shape);
     // Draw a solid-colored triangle.
     void (*unshaded_tri)(pax_buf_t *buf, pax_col_t color, pax_trif shape);
+    // Draw a solid-colored quad with anti-aliased edges.
+    // Optional; if absent, `unshaded_quad` is used instead.
+    void (*unshaded_quad_aa)(pax_buf_t *buf, pax_col_t color, pax_quadf shape);
+    // Draw a solid-colored triangle with anti-aliased edges.
+    // Optional; if absent, `unshaded_tri` is used instead.
+    void (*unshaded_tri_aa)(pax_buf_t *buf, pax_col_t color, pax_trif shape);
+    // Draw a solid-colored polygon; `shape` is only valid for the duration of the call.
+    // Optional; if absent, the polygon is split into rectangles one pixel high drawn with `unshaded_rect`.
+    void (*unshaded_poly)(pax_buf_t *buf, pax_col_t color, pax_polyf shape);
+    // Draw a solid-colored ellipse or elliptic ring.
+    // Optional; if absent, the ellipse is split into rectangles one pixel high drawn with `unshaded_rect`.
+    void (*unshaded_ellipse)(pax_buf_t *buf, pax_col_t color, pax_ellipsef shape);
+    // Draw a solid-colored rectangle with rounded corners.
+    // Optional; if absent, the rectangle is split into rectangles one pixel high drawn with `unshaded_rect`.
+    void (*unshaded_round_rect)(pax_buf_t *buf, pax_col_t color, pax_round_rectf shape);
+    // Draw a solid-colored rectangle with rounded corners and anti-aliased edges.
+    // Optional; if absent, `unshaded_round_rect` is used instead.
+    void (*unshaded_round_rect_aa)(pax_buf_t *buf, pax_col_t color, pax_round_rectf shape);
 
     // Draw a line with a shader.
     void (*shaded_line)(pax_buf_t *buf, pax_col_t color, pax_linef shape, pax_shader_t const *shader, pax_linef uv);
@@ -724,21 +916,48 @@ struct pax_render_funcs {
         ptrdiff_t         cursorpos
     );
 
-    // Wait for all pending drawing operations to finish.
-    void (*join)();
+    // Wait for all pending drawing operations of a render context to finish.
+    void (*join)(void *state);
+    // Insert a fence after all drawing operations queued so far and return its nonzero number.
+    // If `callback` is not NULL, it is called with `cookie` once the fence completes.
+    // Optional; if absent, drawing is synchronous and fences complete when they are inserted.
+    uint64_t (*insert_fence)(void *state, pax_fence_cb_t callback, void *cookie);
+    // Check whether a fence has completed, first waiting for it to complete if `block` is true.
+    // Optional; must be present if `insert_fence` is.
+    bool (*wait_fence)(void *state, uint64_t fence, bool block);
 };
 
 // Render engine definition.
 struct pax_render_engine {
     // Renderer init function; after this returns, the renderer must be ready.
-    pax_render_funcs_t const *(*init)(void *init_cookie);
+    // May store per-context state in `*state`, which is passed back to `join` and `deinit`.
+    pax_render_funcs_t const *(*init)(void **state, void *init_cookie);
     // Renderer de-init function; clean up any implicitly-allocated resources.
     // Optional.
-    void (*deinit)();
+    void (*deinit)(void *state);
     // Have the dispatch run dirty marking on behalf of the renderer.
     bool implicit_dirty;
 };
 
+// A point in the stream of drawing operations of a render context; see `pax_buf_insert_fence`.
+struct pax_fence {
+    // The render context the fence was inserted into.
+    pax_render_ctx_t *ctx;
+    // Engine-specific fence number; 0 for fences that completed when they were inserted.
+    uint64_t          seq;
+};
+
+// An instance of a render engine with its own state, such as worker threads and task queues.
+// Buffers draw through the default context unless `pax_buf_set_render_ctx` is used.
+struct pax_render_ctx {
+    // The render engine this is an instance of.
+    pax_render_engine_t const *engine;
+    // The functions returned by the engine's `init`.
+    pax_render_funcs_t const  *funcs;
+    // Engine-specific state.
+    void                      *state;
+};
+
 #ifdef __cplusplus
 }
 #endif //__cplusplus
@@ -22,6 +22,18 @@ void pax_swr_unshaded_rect(pax_buf_t *buf, pax_col_t color, pax_rectf shape);
 void pax_swr_unshaded_quad(pax_buf_t *buf, pax_col_t color, pax_quadf shape);
 // Draw a solid-colored triangle.
 void pax_swr_unshaded_tri(pax_buf_t *buf, pax_col_t color, pax_trif shape);
+// Draw a solid-colored quad with anti-aliased edges.
+void pax_swr_unshaded_quad_aa(pax_buf_t *buf, pax_col_t color, pax_quadf shape);
+// Draw a solid-colored triangle with anti-aliased edges.
+void pax_swr_unshaded_tri_aa(pax_buf_t *buf, pax_col_t color, pax_trif shape);
+// Draw a solid-colored polygon.
+void pax_swr_unshaded_poly(pax_buf_t *buf, pax_col_t color, pax_polyf shape);
+// Draw a solid-colored ellipse or elliptic ring.
+void pax_swr_unshaded_ellipse(pax_buf_t *buf, pax_col_t color, pax_ellipsef shape);
+// Draw a solid-colored rectangle with rounded corners.
+void pax_swr_unshaded_round_rect(pax_buf_t *buf, pax_col_t color, pax_round_rectf shape);
+// Draw a solid-colored rectangle with rounded corners and anti-aliased edges.
+void pax_swr_unshaded_round_rect_aa(pax_buf_t *buf, pax_col_t color, pax_round_rectf shape);
 
 // Draw a line with a shader.
 void pax_swr_shaded_line(pax_buf_t *buf, pax_col_t color, pax_linef shape, pax_shader_t const *shader, pax_linef uv);
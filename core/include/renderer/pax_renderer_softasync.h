@@ -6,7 +6,6 @@
 
 #include "pax_gfx.h"
 #include "pax_renderer.h"
-#include "ptq.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -23,6 +22,18 @@ void pax_sasr_unshaded_rect(pax_buf_t *buf, pax_col_t color, pax_rectf shape);
 void pax_sasr_unshaded_quad(pax_buf_t *buf, pax_col_t color, pax_quadf shape);
 // Draw a solid-colored triangle.
 void pax_sasr_unshaded_tri(pax_buf_t *buf, pax_col_t color, pax_trif shape);
+// Draw a solid-colored quad with anti-aliased edges.
+void pax_sasr_unshaded_quad_aa(pax_buf_t *buf, pax_col_t color, pax_quadf shape);
+// Draw a solid-colored triangle with anti-aliased edges.
+void pax_sasr_unshaded_tri_aa(pax_buf_t *buf, pax_col_t color, pax_trif shape);
+// Draw a solid-colored polygon.
+void pax_sasr_unshaded_poly(pax_buf_t *buf, pax_col_t color, pax_polyf shape);
+// Draw a solid-colored ellipse or elliptic ring.
+void pax_sasr_unshaded_ellipse(pax_buf_t *buf, pax_col_t color, pax_ellipsef shape);
+// Draw a solid-colored rectangle with rounded corners.
+void pax_sasr_unshaded_round_rect(pax_buf_t *buf, pax_col_t color, pax_round_rectf shape);
+// Draw a solid-colored rectangle with rounded corners and anti-aliased edges.
+void pax_sasr_unshaded_round_rect_aa(pax_buf_t *buf, pax_col_t color, pax_round_rectf shape);
 
 // Draw a line with a shader.
 void pax_sasr_shaded_line(pax_buf_t *buf, pax_col_t color, pax_linef shape, pax_shader_t const *shader, pax_linef uv);
@@ -72,16 +83,64 @@ void pax_sasr_text(
 );
 
 // Wait for all pending draw calls to finish.
-void pax_sasr_join();
+void pax_sasr_join(void *state);
+// Insert a fence after all draw calls queued so far.
+uint64_t pax_sasr_insert_fence(void *state, pax_fence_cb_t callback, void *cookie);
+// Check whether a fence has completed, first waiting for it to complete if `block` is true.
+bool     pax_sasr_wait_fence(void *state, uint64_t fence, bool block);
 
+// Memory use of the arena a render context using the async renderer keeps task data in, such as laid out text.
+// The arena is reset by joining the render context, which is what a frame means here.
+typedef struct {
+    // Bytes allocated since the arena was last reset.
+    size_t used;
+    // Bytes allocated in the frame before the arena was last reset.
+    size_t last_frame;
+    // Most bytes allocated in any one frame.
+    size_t peak;
+    // Bytes of memory held by the arena, used or not.
+    size_t capacity;
+    // Number of times the arena has been reset.
+    size_t frames;
+} pax_sasr_arena_stats_t;
+
+// Get the arena statistics of a render context.
+// Returns `false` if `ctx` does not use the async renderer.
+bool pax_sasr_get_arena_stats(pax_render_ctx_t const *ctx, pax_sasr_arena_stats_t *out);
+
+
+// Settings for the worker threads of the async renderer; passed as the init cookie of `pax_render_engine_softasync`.
+// Fields left zero use the defaults.
+typedef struct {
+    // Number of worker threads; negative for one per CPU core and 0 for one.
+    int              workers;
+    // CPU affinity masks; worker N may only run on the CPUs whose bit is set in `affinity[N % n_affinity]`.
+    // A mask of 0 allows any CPU. On FreeRTOS, workers are pinned to the lowest CPU in their mask.
+    // If NULL, workers may run on any CPU, except on FreeRTOS where worker N is pinned to CPU N.
+    uint64_t const  *affinity;
+    // Number of entries in `affinity`.
+    size_t           n_affinity;
+    // Whether to use `policy` and `priority` instead of the scheduling settings of the thread starting the workers.
+    bool             set_sched;
+    // Scheduling policy, such as `SCHED_FIFO`; ignored on FreeRTOS.
+    int              policy;
+    // Scheduling priority; on FreeRTOS, this is the task priority, which is 1 by default.
+    int              priority;
+    // Stack size of the worker threads in bytes; 0 for the default, which is 4096 on FreeRTOS.
+    size_t           stack_size;
+    // Hold draw calls back until the render context is joined or fenced, and discard the ones that are hidden by a
+    // later opaque background, rectangle or blit before they are run. Unlike the other settings, this applies to
+    // every render context created with it.
+    bool             deferred;
+} pax_sasr_config_t;
 
 // Async software rendering functions.
 extern pax_render_funcs_t const  pax_render_funcs_softasync;
-// Software rendering functions for worker thread 1/2.
-extern pax_render_funcs_t const  pax_render_funcs_mcr_thread0;
-// Software rendering functions for worker thread 2/2.
-extern pax_render_funcs_t const  pax_render_funcs_mcr_thread1;
 // Async software rendering engine.
+// The init cookie is a `pax_sasr_config_t const *`, or NULL for one worker thread with the default settings.
+// Buffers are split into bands of rows spread over the workers, which only receive the tasks that touch them.
+// Every render context using this engine has its own queues and join fence, but they share one pool of workers.
+// The pool is started with the settings of the first context and stopped when the last one is destroyed.
 extern pax_render_engine_t const pax_render_engine_softasync;
 
 
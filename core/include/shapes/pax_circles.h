@@ -19,6 +19,11 @@ void pax_draw_circle(pax_buf_t *buf, pax_col_t color, float x, float y, float r)
 // Draw a hollow circle.
 void pax_draw_hollow_circle(pax_buf_t *buf, pax_col_t color, float x, float y, float radius0, float radius1);
 
+// Draw an ellipse, ignoring matrix transform.
+void pax_simple_ellipse(pax_buf_t *buf, pax_col_t color, float x, float y, float rx, float ry);
+// Draw an ellipse with horizontal radius `rx` and vertical radius `ry`.
+void pax_draw_ellipse(pax_buf_t *buf, pax_col_t color, float x, float y, float rx, float ry);
+
 // Draw a circle outline.
 void pax_outline_circle(pax_buf_t *buf, pax_col_t color, float x, float y, float r);
 // Draw a hollow circle.
@@ -16,6 +16,8 @@ void pax_simple_rect(pax_buf_t *buf, pax_col_t color, float x, float y, float wi
 
 // Draw a rectangle.
 void pax_draw_rect(pax_buf_t *buf, pax_col_t color, float x, float y, float width, float height);
+// Draw a rectangle with anti-aliased edges.
+void pax_draw_rect_aa(pax_buf_t *buf, pax_col_t color, float x, float y, float width, float height);
 // Draw a rounded rectangle.
 void pax_draw_round_rect(pax_buf_t *buf, pax_col_t color, float x, float y, float width, float height, float radius);
 // Draw a rounded rectangle with different radii per corner.
@@ -23,6 +25,13 @@ void pax_draw_round_rect(pax_buf_t *buf, pax_col_t color, float x, float y, floa
 void pax_draw_round_rect4(
     pax_buf_t *buf, pax_col_t color, float x, float y, float width, float height, float r0, float r1, float r2, float r3
 );
+// Draw a rounded rectangle with anti-aliased edges.
+void pax_draw_round_rect_aa(pax_buf_t *buf, pax_col_t color, float x, float y, float width, float height, float radius);
+// Draw a rounded rectangle with different radii per corner and anti-aliased edges.
+// The radii start top-left and go clockwise.
+void pax_draw_round_rect4_aa(
+    pax_buf_t *buf, pax_col_t color, float x, float y, float width, float height, float r0, float r1, float r2, float r3
+);
 
 // Draw a rectangle outline.
 void pax_outline_rect(pax_buf_t *buf, pax_col_t color, float x, float y, float width, float height);
@@ -13,9 +13,14 @@ extern "C" {
 
 // Draw a triangle, ignoring matrix transform.
 void pax_simple_tri(pax_buf_t *buf, pax_col_t color, float x0, float y0, float x1, float y1, float x2, float y2);
+// Draw a triangle with anti-aliased edges, ignoring matrix transform.
+void pax_simple_tri_aa(pax_buf_t *buf, pax_col_t color, float x0, float y0, float x1, float y1, float x2, float y2);
 
 // Draw a triangle.
 void pax_draw_tri(pax_buf_t *buf, pax_col_t color, float x0, float y0, float x1, float y1, float x2, float y2);
+// Draw a triangle with anti-aliased edges.
+// Edge pixels are blended by how much of them the triangle covers, which costs a little more than `pax_draw_tri`.
+void pax_draw_tri_aa(pax_buf_t *buf, pax_col_t color, float x0, float y0, float x1, float y1, float x2, float y2);
 // Draw a triangle.
 void pax_outline_tri(pax_buf_t *buf, pax_col_t color, float x0, float y0, float x1, float y1, float x2, float y2);
 
@@ -4,6 +4,8 @@
 #include "helpers/pax_drawing_helpers.h"
 #include "pax_internal.h"
 
+#include <limits.h>
+
 /* ======= UNSHADED DRAWING ====== */
 
 // Internal method for unshaded trapezoids.
@@ -26,10 +28,794 @@
 #define PDHG_TZOID_NAME pax_tzoid_unshaded
 #include "helpers/pax_dh_generic_quad.inc"
 
-// Internal method for unshaded lines.
-#define PDHG_NAME pax_line_unshaded
+// Internal method for unshaded lines with endpoints that aren't whole pixels.
+#define PDHG_NAME pax_line_unshaded_dda
+#define PDHG_STATIC
 #include "helpers/pax_dh_generic_line.inc"
 
+
+
+/* ======== INTEGER LINES ======== */
+
+// Lines with whole-pixel endpoints further than this from the origin are drawn by the generic walk instead.
+// Small enough that the 16.16 positions and clip bounds below can't overflow 32 bits.
+#define PAX_LINE_INT_MAX  0x2000
+// Shallow lines with runs shorter than this are drawn a pixel at a time instead of a range setter call per run.
+#define PAX_LINE_MIN_SPAN 3
+
+// Whether `value` is a whole number the integer line walk can start or end at.
+static inline bool pax_line_is_int(float value) {
+    return value >= -PAX_LINE_INT_MAX && value <= PAX_LINE_INT_MAX && value == (int)value;
+}
+
+// Divide rounding towards negative infinity; `den` must be positive.
+static inline int_fast32_t pax_floor_div(int_fast32_t num, int_fast32_t den) {
+    return num >= 0 ? num / den : -((den - 1 - num) / den);
+}
+
+// Narrow the range of steps [`*k0`, `*k1`] to those where the pixel `(pos + k * step) >> 16` is within [`lo`, `hi`].
+// Leaves `*k0 > *k1` if there are no such steps.
+static void pax_line_int_clip(int_fast32_t pos, int_fast32_t step, int lo, int hi, int *k0, int *k1) {
+    lo                  = lo < -PAX_LINE_INT_MAX ? -PAX_LINE_INT_MAX : lo;
+    hi                  = hi > PAX_LINE_INT_MAX ? PAX_LINE_INT_MAX : hi;
+    int_fast32_t lo_fix = (int_fast32_t)lo * 0x10000;
+    int_fast32_t hi_fix = (int_fast32_t)(hi + 1) * 0x10000;
+    int_fast32_t first, last;
+    if (step > 0) {
+        first = -pax_floor_div(pos - lo_fix, step);
+        last  = -pax_floor_div(pos - hi_fix, step) - 1;
+    } else if (step < 0) {
+        first = pax_floor_div(pos - hi_fix, -step) + 1;
+        last  = pax_floor_div(pos - lo_fix, -step);
+    } else if (pos >= lo_fix && pos < hi_fix) {
+        return;
+    } else {
+        *k1 = *k0 - 1;
+        return;
+    }
+    if (first > *k0) {
+        *k0 = first;
+    }
+    if (last < *k1) {
+        *k1 = last;
+    }
+}
+
+// Internal method for unshaded lines between whole pixels.
+// Picks the same pixels as the generic 16.16 walk, but with integer steps: shallow lines are drawn with one range
+// setter call per row, so horizontal lines are a single call, and other lines with a Bresenham walk of the pixel index.
+// Unlike the generic walk, the pixels drawn do not depend on the clip rect.
+static void pax_line_unshaded_int(pax_buf_t *buf, pax_col_t color, int x0, int y0, int x1, int y1) {
+    if (!buf->clip.w || !buf->clip.h) {
+        return;
+    }
+
+    // Sort points vertically, so the walk starts at the same end as the generic one.
+    if (y0 > y1) {
+        PAX_SWAP(int, x0, x1)
+        PAX_SWAP(int, y0, y1)
+    }
+
+    // The major axis moves one pixel per step, the minor axis `minor_step` in 16.16 format.
+    bool is_steep = abs(x1 - x0) < y1 - y0;
+    int  major0   = is_steep ? y0 : x0;
+    int  major1   = is_steep ? y1 : x1;
+    int  minor0   = is_steep ? x0 : y0;
+    int  minor1   = is_steep ? x1 : y1;
+    int  n_steps  = abs(major1 - major0);
+    int  dir      = major1 < major0 ? -1 : 1;
+    // Rounded the same way as in the generic walk.
+    float        minor_delta = (float)(minor1 - minor0) / (n_steps ? n_steps : 1);
+    int_fast32_t minor_step  = minor_delta * 0x10000;
+    int_fast32_t minor_pos   = (int_fast32_t)minor0 * 0x10000 + 0x8000;
+
+    // Clip the range of steps to the clip rect, unless both ends are already inside it.
+    int k0 = 0;
+    int k1 = n_steps;
+    if (x0 < buf->clip.x || x1 < buf->clip.x || x0 >= buf->clip.x + buf->clip.w || x1 >= buf->clip.x + buf->clip.w
+        || y0 < buf->clip.y || y1 >= buf->clip.y + buf->clip.h) {
+        int major_lo = is_steep ? buf->clip.y : buf->clip.x;
+        int major_hi = major_lo + (is_steep ? buf->clip.h : buf->clip.w) - 1;
+        int minor_lo = is_steep ? buf->clip.x : buf->clip.y;
+        int minor_hi = minor_lo + (is_steep ? buf->clip.w : buf->clip.h) - 1;
+        pax_line_int_clip((int_fast32_t)major0 * 0x10000 + 0x8000, dir * 0x10000, major_lo, major_hi, &k0, &k1);
+        pax_line_int_clip(minor_pos, minor_step, minor_lo, minor_hi, &k0, &k1);
+        if (k0 > k1) {
+            return;
+        }
+    }
+
+    // `error` is how far the minor position can move before it leaves the current pixel.
+    minor_pos              += minor_step * k0;
+    int          major      = major0 + dir * k0;
+    int          minor      = minor_pos >> 16;
+    int          minor_dir  = minor_step < 0 ? -1 : 1;
+    int_fast32_t abs_step   = minor_step < 0 ? -minor_step : minor_step;
+    int_fast32_t error      = minor_step < 0 ? minor_pos - (int_fast32_t)minor * 0x10000 + 1
+                                             : (int_fast32_t)(minor + 1) * 0x10000 - minor_pos;
+    int          remaining  = k1 - k0 + 1;
+    // After the first, every run of steps on the same minor pixel is `run_min` or `run_min + 1` steps long.
+    int          run_min    = abs_step ? 0x10000 / abs_step : remaining;
+
+    if (!is_steep && run_min >= PAX_LINE_MIN_SPAN) {
+        // Shallow line; draw it a run at a time.
+        pax_range_setter_t setter = pax_get_range_setter(buf, &color);
+        if (!setter) {
+            return;
+        }
+        int run_len = abs_step ? (error + abs_step - 1) / abs_step : remaining;
+        while (1) {
+            if (run_len > remaining) {
+                run_len = remaining;
+            }
+            int left = dir < 0 ? major - run_len + 1 : major;
+            setter(buf, color, left + minor * buf->width, run_len);
+            PAX_STATS_SET_RANGE(buf, setter, run_len);
+            remaining -= run_len;
+            if (remaining <= 0) {
+                break;
+            }
+            major   += dir * run_len;
+            minor   += minor_dir;
+            error   += 0x10000 - run_len * abs_step;
+            run_len  = run_min * abs_step >= error ? run_min : run_min + 1;
+        }
+
+    } else {
+        // Steep line or short runs; draw it a pixel at a time.
+        pax_index_setter_t setter = pax_get_setter(buf, &color, NULL);
+        if (!setter) {
+            return;
+        }
+        int index        = is_steep ? minor + major * buf->width : major + minor * buf->width;
+        int major_stride = is_steep ? buf->width : dir;
+        int minor_stride = is_steep ? minor_dir : minor_dir * buf->width;
+        for (int i = 0; i < remaining; i++) {
+            setter(buf, color, index);
+            index += major_stride;
+            error -= abs_step;
+            if (error <= 0) {
+                error += 0x10000;
+                index += minor_stride;
+            }
+        }
+        PAX_STATS_SET(setter, remaining);
+    }
+}
+
+// Internal method for line drawing.
+void pax_line_unshaded(pax_buf_t *buf, pax_col_t color, float x0, float y0, float x1, float y1) {
+    if (pax_line_is_int(x0) && pax_line_is_int(y0) && pax_line_is_int(x1) && pax_line_is_int(y1)) {
+        pax_line_unshaded_int(buf, color, x0, y0, x1, y1);
+    } else {
+        pax_line_unshaded_dda(buf, color, x0, y0, x1, y1);
+    }
+}
+
+
+
+/* ==== ANTI-ALIASED DRAWING ===== */
+
+// Maximum number of points of a polygon drawn with anti-aliasing.
+#define PAX_AA_MAX_POINTS 4
+// Edges closer to vertical than this over one row are integrated at their midpoint instead.
+#define PAX_AA_FLAT_EDGE  (1.0_fix / 64)
+
+// The part of an edge of a polygon inside one row of pixels.
+typedef struct {
+    // X at the top and bottom of the part.
+    fixpt_t x0, x1;
+    // Height of the part; negative if the edge runs upwards.
+    fixpt_t h;
+    // First and one past the last pixel column the part crosses.
+    int     col0, col1;
+} pax_aa_edge_t;
+
+// Integral of `clamp(u, 0, 1)` from 0 to `u`.
+static inline fixpt_t pax_aa_ramp(fixpt_t u) {
+    if (u <= 0) {
+        return 0;
+    } else if (u >= 1) {
+        return u - 0.5_fix;
+    } else {
+        return u * u * 0.5_fix;
+    }
+}
+
+// Area of the part of the pixel column from `x` to `x + 1` left of an edge, signed like its height.
+static inline fixpt_t pax_aa_area_left(pax_aa_edge_t const *edge, fixpt_t x) {
+    fixpt_t u0 = edge->x0 - x;
+    fixpt_t u1 = edge->x1 - x;
+    if (u0 <= 0 && u1 <= 0) {
+        return 0;
+    } else if (u0 >= 1 && u1 >= 1) {
+        return edge->h;
+    }
+    fixpt_t du = u1 - u0;
+    if (du < PAX_AA_FLAT_EDGE && du > -PAX_AA_FLAT_EDGE) {
+        fixpt_t mid = (u0 + u1) * 0.5_fix;
+        return (mid <= 0 ? fixpt_t(0) : mid >= 1 ? fixpt_t(1) : mid) * edge->h;
+    }
+    return (pax_aa_ramp(u1) - pax_aa_ramp(u0)) / du * edge->h;
+}
+
+// Round down to an integer.
+static inline int pax_fix_floor(fixpt_t value) {
+    int i = value;
+    return fixpt_t(i) > value ? i - 1 : i;
+}
+
+// Round up to an integer.
+static inline int pax_fix_ceil(fixpt_t value) {
+    int i = value;
+    return fixpt_t(i) < value ? i + 1 : i;
+}
+
+// Get the part of the edge from (`xa`, `ya`) to (`xb`, `yb`) inside the row from `y` to `y + 1`.
+// Returns false if the edge doesn't cross the row.
+static bool pax_aa_clip_edge(fixpt_t xa, fixpt_t ya, fixpt_t xb, fixpt_t yb, int y, pax_aa_edge_t *out) {
+    fixpt_t sign = 1;
+    if (ya > yb) {
+        PAX_SWAP(fixpt_t, xa, xb);
+        PAX_SWAP(fixpt_t, ya, yb);
+        sign = -1;
+    }
+    if (ya >= y + 1 || yb <= y || ya >= yb) {
+        return false;
+    }
+    fixpt_t lo = xa < xb ? xa : xb;
+    fixpt_t hi = xa < xb ? xb : xa;
+    fixpt_t dx = (xb - xa) / (yb - ya);
+
+    // Interpolated coordinates are clamped to the edge, in case the slope lost precision.
+    out->x0 = xa;
+    out->x1 = xb;
+    out->h  = ((yb < y + 1 ? yb : fixpt_t(y + 1)) - (ya > y ? ya : fixpt_t(y))) * sign;
+    if (ya < y) {
+        out->x0 = xa + dx * (y - ya);
+        out->x0 = out->x0 < lo ? lo : out->x0 > hi ? hi : out->x0;
+    }
+    if (yb > y + 1) {
+        out->x1 = xa + dx * (y + 1 - ya);
+        out->x1 = out->x1 < lo ? lo : out->x1 > hi ? hi : out->x1;
+    }
+    out->col0 = pax_fix_floor(out->x0 < out->x1 ? out->x0 : out->x1);
+    out->col1 = pax_fix_ceil(out->x0 < out->x1 ? out->x1 : out->x0);
+    return true;
+}
+
+// Draw `count` pixels from `index` on with `color` at `alpha` out of 255 times its own alpha.
+// `value` is `color` converted for the range setter, which is used when the result is opaque.
+static inline void pax_aa_span(
+    pax_buf_t *buf, pax_col_t color, pax_col_t value, pax_range_setter_t setter, int alpha, int index, int count
+) {
+    alpha = alpha < 0 ? 0 : alpha > 255 ? 255 : alpha;
+    alpha = (alpha * (color >> 24) + 127) / 255;
+    if (alpha >= 255 && setter == buf->range_setter) {
+        setter(buf, value, index, count);
+        PAX_STATS_PIXELS(false, count);
+    } else if (alpha > 0) {
+        buf->range_merger(buf, (color & 0x00ffffff) | (alpha << 24), index, count);
+        PAX_STATS_PIXELS(true, count);
+    }
+}
+
+// Internal method for anti-aliased polygons with up to `PAX_AA_MAX_POINTS` points.
+// Each pixel is blended by the exact area of it inside the polygon, which is the sum over the edges of the area left
+// of them, signed by whether they run down or up. Spans between the edges have a constant area and are set at once.
+// Self-intersecting polygons are filled with the nonzero rule, except for the pixels where edges cross.
+static void pax_poly_unshaded_aa(pax_buf_t *buf, pax_col_t color, float const *_xs, float const *_ys, int n_points) {
+    pax_col_t          value  = color;
+    pax_range_setter_t setter = pax_get_range_setter(buf, &value);
+    if (!setter) {
+        return;
+    }
+
+    fixpt_t xs[PAX_AA_MAX_POINTS], ys[PAX_AA_MAX_POINTS];
+    fixpt_t y_min = _ys[0], y_max = _ys[0];
+    for (int i = 0; i < n_points; i++) {
+        xs[i] = _xs[i];
+        ys[i] = _ys[i];
+        y_min = ys[i] < y_min ? ys[i] : y_min;
+        y_max = ys[i] > y_max ? ys[i] : y_max;
+    }
+
+    // Clip: Y axis.
+    int iy0 = pax_fix_floor(y_min);
+    int iy1 = pax_fix_ceil(y_max);
+    if (iy0 < buf->clip.y) {
+        iy0 = buf->clip.y;
+    }
+    if (iy1 > buf->clip.y + buf->clip.h) {
+        iy1 = buf->clip.y + buf->clip.h;
+    }
+
+    // Vertical drawing loop.
+    for (int y = iy0; y < iy1; y++) {
+        pax_aa_edge_t edges[PAX_AA_MAX_POINTS];
+        int           n_edges = 0;
+        int           x0      = INT_MAX;
+        int           x1      = INT_MIN;
+        for (int i = 0; i < n_points; i++) {
+            int j = (i + 1) % n_points;
+            if (pax_aa_clip_edge(xs[i], ys[i], xs[j], ys[j], y, &edges[n_edges])) {
+                x0 = edges[n_edges].col0 < x0 ? edges[n_edges].col0 : x0;
+                x1 = edges[n_edges].col1 > x1 ? edges[n_edges].col1 : x1;
+                n_edges++;
+            }
+        }
+
+        // Clip: X axis.
+        if (x0 < buf->clip.x) {
+            x0 = buf->clip.x;
+        }
+        if (x1 > buf->clip.x + buf->clip.w) {
+            x1 = buf->clip.x + buf->clip.w;
+        }
+
+        // Horizontal drawing loop.
+        int delta = y * buf->width;
+        for (int x = x0; x < x1;) {
+            // Pixels that no edge crosses have the same area as the ones after them up to the next edge.
+            int     next = x1;
+            fixpt_t area = 0;
+            for (int i = 0; i < n_edges; i++) {
+                if (edges[i].col0 <= x && x < edges[i].col1) {
+                    next = x + 1;
+                } else if (edges[i].col0 > x && edges[i].col0 < next) {
+                    next = edges[i].col0;
+                }
+                area = area + pax_aa_area_left(&edges[i], x);
+            }
+            pax_aa_span(buf, color, value, setter, abs(area) * 255 + 0.5_fix, delta + x, next - x);
+            x = next;
+        }
+    }
+}
+
+// Internal method for anti-aliased unshaded triangles.
+void pax_tri_unshaded_aa(pax_buf_t *buf, pax_col_t color, float x0, float y0, float x1, float y1, float x2, float y2) {
+    if (buf->type_info.fmt_type == PAX_BUF_SUBTYPE_PALETTE) {
+        // Palette colors can't be blended.
+        pax_tri_unshaded(buf, color, x0, y0, x1, y1, x2, y2);
+        return;
+    }
+    float xs[3] = {x0, x1, x2};
+    float ys[3] = {y0, y1, y2};
+    pax_poly_unshaded_aa(buf, color, xs, ys, 3);
+}
+
+// Internal method for anti-aliased unshaded quads.
+void pax_quad_unshaded_aa(
+    pax_buf_t *buf, pax_col_t color, float x0, float y0, float x1, float y1, float x2, float y2, float x3, float y3
+) {
+    if (buf->type_info.fmt_type == PAX_BUF_SUBTYPE_PALETTE) {
+        // Palette colors can't be blended.
+        pax_quad_unshaded(buf, color, x0, y0, x1, y1, x2, y2, x3, y3);
+        return;
+    }
+    float xs[4] = {x0, x1, x2, x3};
+    float ys[4] = {y0, y1, y2, y3};
+    pax_poly_unshaded_aa(buf, color, xs, ys, 4);
+}
+
+
+
+/* ======= POLYGON FILLING ======= */
+
+// An edge of a polygon, as seen by the scanline filler.
+typedef struct {
+    // X at the center of the current row, which is advanced by `dx` every row.
+    fixpt_t x, dx;
+    // First row and one past the last row whose center the edge crosses.
+    int     row0, row1;
+    // 1 if the edge runs downwards, -1 if it runs upwards.
+    int     winding;
+} pax_poly_edge_t;
+
+// Sort edges by the first row they cross.
+static int pax_poly_edge_cmp(void const *a, void const *b) {
+    int row_a = ((pax_poly_edge_t const *)a)->row0;
+    int row_b = ((pax_poly_edge_t const *)b)->row0;
+    return (row_a > row_b) - (row_a < row_b);
+}
+
+// Find the spans of pixels inside a polygon that are within the clip rectangle of `buf`, from the top row down.
+// A pixel is inside if its center is, like with triangles, so polygons that share an edge don't overlap.
+// Uses an active edge table: each row only looks at the edges that cross it, kept sorted by X.
+void pax_poly_spans(pax_buf_t const *buf, pax_polyf shape, pax_span_cb_t callback, void *args) {
+    size_t n_points = 0;
+    for (size_t i = 0; i < shape.n_contours; i++) {
+        n_points += shape.contour_lens[i];
+    }
+    if (n_points < 3 || buf->clip.w <= 0 || buf->clip.h <= 0) {
+        return;
+    }
+
+    // A list of pointers to the edges crossing the current row, followed by one edge per point at most.
+    pax_poly_edge_t **active = (pax_poly_edge_t **)malloc(n_points * (sizeof(void *) + sizeof(pax_poly_edge_t)));
+    if (!active) {
+        pax_set_err(PAX_ERR_NOMEM);
+        return;
+    }
+    pax_poly_edge_t *edges = (pax_poly_edge_t *)(active + n_points);
+
+    // Build the edge table, leaving out the edges that are horizontal or entirely above or below the clip rectangle.
+    int              clip_y0  = buf->clip.y;
+    int              clip_y1  = buf->clip.y + buf->clip.h;
+    size_t           n_edges  = 0;
+    pax_vec2f const *contour  = shape.points;
+    for (size_t i = 0; i < shape.n_contours; contour += shape.contour_lens[i], i++) {
+        size_t len = shape.contour_lens[i];
+        for (size_t j = 0; j < len; j++) {
+            fixpt_t xa = contour[j].x, ya = contour[j].y;
+            fixpt_t xb = contour[(j + 1) % len].x, yb = contour[(j + 1) % len].y;
+            int     winding = 1;
+            if (ya > yb) {
+                PAX_SWAP(fixpt_t, xa, xb);
+                PAX_SWAP(fixpt_t, ya, yb);
+                winding = -1;
+            }
+            int row0 = pax_fix_ceil(ya - 0.5_fix);
+            int row1 = pax_fix_ceil(yb - 0.5_fix);
+            if (row0 >= row1 || row1 <= clip_y0 || row0 >= clip_y1) {
+                continue;
+            }
+            pax_poly_edge_t *edge = &edges[n_edges++];
+            edge->dx              = (xb - xa) / (yb - ya);
+            edge->x               = xa + edge->dx * (fixpt_t(row0) + 0.5_fix - ya);
+            edge->row0            = row0;
+            edge->row1            = row1;
+            edge->winding         = winding;
+        }
+    }
+    qsort(edges, n_edges, sizeof(pax_poly_edge_t), pax_poly_edge_cmp);
+
+    fixpt_t clip_x0  = buf->clip.x;
+    fixpt_t clip_x1  = buf->clip.x + buf->clip.w;
+    size_t  n_active = 0;
+    size_t  next     = 0;
+    int     y        = clip_y0;
+    while (n_active || next < n_edges) {
+        if (!n_active && edges[next].row0 > y) {
+            // Skip the rows between parts of the polygon.
+            y = edges[next].row0;
+        }
+        if (y >= clip_y1) {
+            break;
+        }
+
+        // Add the edges that start on this row, moving them down to it if they start above the clip rectangle.
+        while (next < n_edges && edges[next].row0 <= y) {
+            pax_poly_edge_t *edge  = &edges[next++];
+            edge->x               += edge->dx * fixpt_t(y - edge->row0);
+            active[n_active++]     = edge;
+        }
+
+        // The order of the edges only changes where they cross, so insertion sort is nearly linear.
+        for (size_t i = 1; i < n_active; i++) {
+            pax_poly_edge_t *edge = active[i];
+            size_t           j    = i;
+            for (; j > 0 && active[j - 1]->x > edge->x; j--) {
+                active[j] = active[j - 1];
+            }
+            active[j] = edge;
+        }
+
+        // Walk the edges from left to right, drawing where the fill rule says the row is inside.
+        int     winding = 0;
+        fixpt_t start   = 0;
+        for (size_t i = 0; i < n_active; i++) {
+            bool was_inside  = shape.rule == PAX_FILL_EVENODD ? winding & 1 : winding != 0;
+            winding         += active[i]->winding;
+            bool is_inside   = shape.rule == PAX_FILL_EVENODD ? winding & 1 : winding != 0;
+            if (is_inside && !was_inside) {
+                start = active[i]->x;
+            } else if (was_inside && !is_inside) {
+                fixpt_t end = active[i]->x;
+                // Clamp before rounding, so that shapes far outside the buffer can't overflow.
+                start       = start < clip_x0 ? clip_x0 : start;
+                end         = end > clip_x1 ? clip_x1 : end;
+                int x0      = pax_fix_ceil(start - 0.5_fix);
+                int x1      = pax_fix_ceil(end - 0.5_fix);
+                if (x1 > x0) {
+                    callback(args, x0, y, x1 - x0);
+                }
+            }
+        }
+
+        // Step to the next row, removing the edges that end here.
+        y++;
+        size_t kept = 0;
+        for (size_t i = 0; i < n_active; i++) {
+            if (active[i]->row1 > y) {
+                active[i]->x     += active[i]->dx;
+                active[kept++]    = active[i];
+            }
+        }
+        n_active = kept;
+    }
+
+    free(active);
+}
+
+// Range setter and color for `pax_unshaded_span`.
+typedef struct {
+    pax_buf_t         *buf;
+    pax_range_setter_t setter;
+    pax_col_t          color;
+} pax_unshaded_span_t;
+
+// Draw one span of an unshaded polygon or ellipse.
+static void pax_unshaded_span(void *args, int x, int y, int len) {
+    pax_unshaded_span_t *ctx = (pax_unshaded_span_t *)args;
+    ctx->setter(ctx->buf, ctx->color, x + y * ctx->buf->width, len);
+    PAX_STATS_SET_RANGE(ctx->buf, ctx->setter, len);
+}
+
+// Internal method for unshaded polygons.
+void pax_poly_unshaded(pax_buf_t *buf, pax_col_t color, pax_polyf shape) {
+    pax_unshaded_span_t ctx = {buf, NULL, color};
+    ctx.setter              = pax_get_range_setter(buf, &ctx.color);
+    if (!ctx.setter) {
+        return;
+    }
+    pax_poly_spans(buf, shape, pax_unshaded_span, &ctx);
+}
+
+
+
+/* ======= ELLIPSE FILLING ======= */
+
+// Pass the pixels whose centers are between `xa` and `xb` on row `y` to `callback`, if any.
+static inline void pax_clip_span(
+    pax_buf_t const *buf, pax_span_cb_t callback, void *args, float xa, float xb, int y
+) {
+    // Clamp before rounding, so that shapes far outside the buffer can't overflow.
+    int x0 = ceilf(fmaxf(xa, buf->clip.x) - 0.5f);
+    int x1 = ceilf(fminf(xb, buf->clip.x + buf->clip.w) - 0.5f);
+    if (x1 > x0) {
+        callback(args, x0, y, x1 - x0);
+    }
+}
+
+// Find the spans of pixels inside an ellipse that are within the clip rectangle of `buf`, from the top row down.
+// A pixel is inside if its center is; every row is solved for exactly, so there is one span per row, or two for rings.
+void pax_ellipse_spans(pax_buf_t const *buf, pax_ellipsef shape, pax_span_cb_t callback, void *args) {
+    // Solving the ellipse for X on a row `dy` below its center gives a span centered on `x + slope * dy`,
+    // reaching `scale * sqrt(height2 - dy * dy)` to either side.
+    float height2 = shape.uy * shape.uy + shape.vy * shape.vy;
+    float det     = fabsf(shape.ux * shape.vy - shape.uy * shape.vx);
+    if (!(height2 > 0 && det > 0) || !isfinite(shape.x + shape.y + height2 + det)) {
+        // Flat, infinite or NaN ellipses have no pixels in them.
+        return;
+    }
+    float slope  = (shape.ux * shape.uy + shape.vx * shape.vy) / height2;
+    float scale  = det / height2;
+    float inner2 = shape.inner * shape.inner * height2;
+
+    // Only visit the rows inside the clip rectangle.
+    float height = sqrtf(height2);
+    float top    = fmaxf(shape.y - height, buf->clip.y);
+    float bottom = fminf(shape.y + height, buf->clip.y + buf->clip.h);
+    if (!(top < bottom)) {
+        return;
+    }
+    int row0 = ceilf(top - 0.5f);
+    int row1 = ceilf(bottom - 0.5f);
+
+    for (int y = row0; y < row1; y++) {
+        float dy    = y + 0.5f - shape.y;
+        float outer = height2 - dy * dy;
+        if (outer <= 0) {
+            continue;
+        }
+        float center = shape.x + slope * dy;
+        float half   = scale * sqrtf(outer);
+        float inner  = inner2 - dy * dy;
+        if (inner > 0) {
+            // Rows that cross the hole have a span on either side of it.
+            float inner_half = scale * sqrtf(inner);
+            pax_clip_span(buf, callback, args, center - half, center - inner_half, y);
+            pax_clip_span(buf, callback, args, center + inner_half, center + half, y);
+        } else {
+            pax_clip_span(buf, callback, args, center - half, center + half, y);
+        }
+    }
+}
+
+// Internal method for unshaded ellipses.
+void pax_ellipse_unshaded(pax_buf_t *buf, pax_col_t color, pax_ellipsef shape) {
+    pax_unshaded_span_t ctx = {buf, NULL, color};
+    ctx.setter              = pax_get_range_setter(buf, &ctx.color);
+    if (!ctx.setter) {
+        return;
+    }
+    pax_ellipse_spans(buf, shape, pax_unshaded_span, &ctx);
+}
+
+
+
+/* ===== ROUNDED RECTANGLES ====== */
+
+// Clamp `value` between `lo` and `hi`.
+// Used instead of `fminf` and `fmaxf`, which are library calls on some targets, in the per-row and per-pixel code.
+static inline float pax_clampf(float value, float lo, float hi) {
+    return value < lo ? lo : value > hi ? hi : value;
+}
+
+// Round down to an integer; `value` must fit in an int.
+static inline int pax_floor_int(float value) {
+    int i = value;
+    return i > value ? i - 1 : i;
+}
+
+// Round up to an integer; `value` must fit in an int.
+static inline int pax_ceil_int(float value) {
+    int i = value;
+    return i < value ? i + 1 : i;
+}
+
+// Get how far the edge of a corner with radius `r` is from the straight side, `d` from the corner's other side.
+static inline float pax_round_rect_inset(float r, float d) {
+    float h2 = r * r - (r - d) * (r - d);
+    return r - (h2 > 0 ? sqrtf(h2) : 0);
+}
+
+// Get the left and right edges of a rounded rectangle at height `y`, which must be between its top and bottom.
+static inline void pax_round_rect_row(pax_round_rectf const &shape, float y, float *left, float *right) {
+    float top    = y - shape.y;
+    float bottom = shape.y + shape.h - y;
+    *left        = shape.x;
+    *right       = shape.x + shape.w;
+    if (top < shape.r0) {
+        *left += pax_round_rect_inset(shape.r0, top);
+    } else if (bottom < shape.r3) {
+        *left += pax_round_rect_inset(shape.r3, bottom);
+    }
+    if (top < shape.r1) {
+        *right -= pax_round_rect_inset(shape.r1, top);
+    } else if (bottom < shape.r2) {
+        *right -= pax_round_rect_inset(shape.r2, bottom);
+    }
+}
+
+// Find the spans of pixels inside a rounded rectangle that are within the clip rectangle of `buf`, from the top row
+// down. A pixel is inside if its center is, so there is exactly one span per row, of which only the rows with
+// corners in them need to be calculated.
+void pax_round_rect_spans(pax_buf_t const *buf, pax_round_rectf shape, pax_span_cb_t callback, void *args) {
+    // Clamp before rounding, so that shapes far outside the buffer can't overflow.
+    float top    = fmaxf(shape.y, buf->clip.y);
+    float bottom = fminf(shape.y + shape.h, buf->clip.y + buf->clip.h);
+    if (!(top < bottom)) {
+        return;
+    }
+    int row0 = ceilf(top - 0.5f);
+    int row1 = ceilf(bottom - 0.5f);
+    for (int y = row0; y < row1; y++) {
+        float left, right;
+        pax_round_rect_row(shape, y + 0.5f, &left, &right);
+        pax_clip_span(buf, callback, args, left, right, y);
+    }
+}
+
+// Internal method for unshaded rounded rectangles.
+void pax_round_rect_unshaded(pax_buf_t *buf, pax_col_t color, pax_round_rectf shape) {
+    pax_unshaded_span_t ctx = {buf, NULL, color};
+    ctx.setter              = pax_get_range_setter(buf, &ctx.color);
+    if (!ctx.setter) {
+        return;
+    }
+    pax_round_rect_spans(buf, shape, pax_unshaded_span, &ctx);
+}
+
+// Get how much of the pixel centered on (`x`, `y`) is inside a rounded rectangle, from 0 to 1.
+// Along the sides this is the exact area; in the corners, it is estimated from the distance to the corner's circle.
+static inline float pax_round_rect_coverage(pax_round_rectf const &shape, float x, float y) {
+    float right  = shape.x + shape.w;
+    float bottom = shape.y + shape.h;
+    float r      = 0;
+    float cx     = 0;
+    float cy     = 0;
+    if (x < shape.x + shape.r0 && y < shape.y + shape.r0) {
+        r  = shape.r0;
+        cx = shape.x + r;
+        cy = shape.y + r;
+    } else if (x > right - shape.r1 && y < shape.y + shape.r1) {
+        r  = shape.r1;
+        cx = right - r;
+        cy = shape.y + r;
+    } else if (x > right - shape.r2 && y > bottom - shape.r2) {
+        r  = shape.r2;
+        cx = right - r;
+        cy = bottom - r;
+    } else if (x < shape.x + shape.r3 && y > bottom - shape.r3) {
+        r  = shape.r3;
+        cx = shape.x + r;
+        cy = bottom - r;
+    }
+    float cover_x = pax_clampf(x + 0.5f, shape.x, right) - pax_clampf(x - 0.5f, shape.x, right);
+    float cover_y = pax_clampf(y + 0.5f, shape.y, bottom) - pax_clampf(y - 0.5f, shape.y, bottom);
+    float cover   = cover_x * cover_y;
+    if (r > 0) {
+        // Small corners cover less than the distance suggests, but never more than the box does.
+        float round = r + 0.5f - sqrtf((x - cx) * (x - cx) + (y - cy) * (y - cy));
+        round       = pax_clampf(round, 0, 1);
+        cover       = round < cover ? round : cover;
+    }
+    return cover;
+}
+
+// Draw the pixels from `x0` to `x1` on row `y` of an anti-aliased rounded rectangle one by one.
+static inline void pax_round_rect_aa_pixels(
+    pax_buf_t *buf, pax_col_t color, pax_col_t value, pax_range_setter_t setter, pax_round_rectf const &shape,
+    int x0, int x1, int y
+) {
+    x0 = x0 < buf->clip.x ? buf->clip.x : x0;
+    x1 = x1 > buf->clip.x + buf->clip.w ? buf->clip.x + buf->clip.w : x1;
+    for (int x = x0; x < x1; x++) {
+        float coverage = pax_round_rect_coverage(shape, x + 0.5f, y + 0.5f);
+        pax_aa_span(buf, color, value, setter, coverage * 255 + 0.5f, x + y * buf->width, 1);
+    }
+}
+
+// Internal method for anti-aliased unshaded rounded rectangles.
+// Pixels near the outline are blended one by one, and the ones between are set at once.
+void pax_round_rect_unshaded_aa(pax_buf_t *buf, pax_col_t color, pax_round_rectf shape) {
+    if (buf->type_info.fmt_type == PAX_BUF_SUBTYPE_PALETTE) {
+        // Palette colors can't be blended.
+        pax_round_rect_unshaded(buf, color, shape);
+        return;
+    }
+    pax_col_t          value  = color;
+    pax_range_setter_t setter = pax_get_range_setter(buf, &value);
+    if (!setter) {
+        return;
+    }
+
+    // Clamp before rounding, so that shapes far outside the buffer can't overflow.
+    float top    = fmaxf(shape.y, buf->clip.y);
+    float bottom = fminf(shape.y + shape.h, buf->clip.y + buf->clip.h);
+    if (!(top < bottom)) {
+        return;
+    }
+    int   row0    = floorf(top);
+    int   row1    = ceilf(bottom);
+    float clip_x0 = buf->clip.x - 1;
+    float clip_x1 = buf->clip.x + buf->clip.w + 1;
+
+    for (int y = row0; y < row1; y++) {
+        // The sides are narrowest at the top or bottom of the row, and widest where the corners end or at the
+        // nearest point to that in the row, so those bound where the outline crosses it.
+        float y0 = y > shape.y ? y : shape.y;
+        float y1 = y + 1 < shape.y + shape.h ? y + 1 : shape.y + shape.h;
+        float left0, right0, left1, right1, left, right, unused;
+        pax_round_rect_row(shape, y0, &left0, &right0);
+        pax_round_rect_row(shape, y1, &left1, &right1);
+        pax_round_rect_row(shape, pax_clampf(shape.y + shape.r0, y0, y1), &left, &unused);
+        pax_round_rect_row(shape, pax_clampf(shape.y + shape.r1, y0, y1), &unused, &right);
+        // Pixels within half a pixel of the outline are blended one by one.
+        int inner0 = pax_ceil_int(pax_clampf((left0 > left1 ? left0 : left1) + 0.5f, clip_x0, clip_x1));
+        int inner1 = pax_floor_int(pax_clampf((right0 < right1 ? right0 : right1) - 0.5f, clip_x0, clip_x1));
+        int outer0 = pax_floor_int(pax_clampf(left - 0.5f, clip_x0, clip_x1));
+        int outer1 = pax_ceil_int(pax_clampf(right + 0.5f, clip_x0, clip_x1));
+        if (inner0 >= inner1) {
+            pax_round_rect_aa_pixels(buf, color, value, setter, shape, outer0, outer1, y);
+            continue;
+        }
+        pax_round_rect_aa_pixels(buf, color, value, setter, shape, outer0, inner0, y);
+        pax_round_rect_aa_pixels(buf, color, value, setter, shape, inner1, outer1, y);
+        // The pixels in between are covered as much as the row is.
+        int x0 = inner0 < buf->clip.x ? buf->clip.x : inner0;
+        int x1 = inner1 > buf->clip.x + buf->clip.w ? buf->clip.x + buf->clip.w : inner1;
+        if (x1 > x0) {
+            pax_aa_span(buf, color, value, setter, (y1 - y0) * 255 + 0.5f, x0 + y * buf->width, x1 - x0);
+        }
+    }
+}
+
+
+
 // Internal method for line drawing.
 void pax_line_unshaded_old(pax_buf_t *buf, pax_col_t color, float x0, float y0, float x1, float y1) {
     pax_index_setter_t setter = pax_get_setter(buf, &color, NULL);
@@ -0,0 +1,1469 @@
+
+// SPDX-License-Identifier: MIT
+
+#include "pax_capture.h"
+
+#include "helpers/pax_drawing_helpers.h"
+#include "pax_fonts.h"
+#include "pax_gfx.h"
+#include "pax_internal.h"
+#include "pax_renderer.h"
+#include "pax_shaders.h"
+
+static char const *TAG = "pax-capture";
+
+#if !CONFIG_PAX_COMPILE_CAPTURE
+
+// Start writing every draw call made to any buffer to `fd`, for replaying later with `pax_capture_replay`.
+// Returns `false` if a capture is already in progress, writing fails or capture is not compiled in.
+bool pax_capture_start(FILE *fd) {
+    PAX_LOGW(TAG, "Capture is not compiled in; pax_capture_start call ignored");
+    return false;
+}
+
+// Stop capturing draw calls; `fd` is flushed but not closed.
+void pax_capture_stop() {
+}
+
+// Read a capture written by `pax_capture_start`.
+// Returns `NULL` if `fd` does not contain a valid capture or out of memory.
+pax_capture_t *pax_capture_load(FILE *fd) {
+    PAX_LOGW(TAG, "Capture is not compiled in; pax_capture_load call ignored");
+    return NULL;
+}
+
+// Free a capture read by `pax_capture_load` and the buffers it replays into.
+void pax_capture_free(pax_capture_t *capture) {
+}
+
+// Replay every draw call in a capture through the default render context.
+void pax_capture_replay(pax_capture_t *capture) {
+}
+
+// Get the number of draw calls in a capture.
+size_t pax_capture_len(pax_capture_t const *capture) {
+    return 0;
+}
+
+// Get the number of buffers a capture draws to or from.
+size_t pax_capture_n_bufs(pax_capture_t const *capture) {
+    return 0;
+}
+
+// Get a buffer a capture draws to or from, in the order they were first used; `NULL` if out of range.
+pax_buf_t *pax_capture_get_buf(pax_capture_t *capture, size_t index) {
+    return NULL;
+}
+
+#else
+
+    #include <pthread.h>
+    #include <stdlib.h>
+    #include <string.h>
+
+    // Capture file magic.
+    #define PAX_CAP_MAGIC      "PAXCAP\0"
+    // Capture file format version.
+    #define PAX_CAP_VERSION    1
+    // Written in native byte order to detect captures made on a machine with different endianness.
+    #define PAX_CAP_ENDIAN     0x01020304
+    // Record flag: the draw call has a shader reference and UVs after the shape.
+    #define PAX_CAP_SHADED     0x01
+    // Record flag: the unshaded triangle or quad has anti-aliased edges.
+    #define PAX_CAP_AA         0x02
+    // Largest buffer that can be loaded from a capture, in pixels.
+    #define PAX_CAP_MAX_PIXELS (1 << 26)
+
+/* ======== FILE FORMAT ========== */
+
+// A capture file is a `pax_cap_file_t` followed by records, each a `pax_cap_hdr_t` followed by its payload.
+// Everything is stored in the byte order and struct layout of the machine that made the capture.
+// Buffers are referred to by an ID assigned the first time they are used.
+
+// Kinds of records in a capture file.
+typedef enum {
+    // Format, palette and contents of a buffer; `pax_cap_buffer_t`, palette, pixel data.
+    PAX_CAP_BUFFER,
+    // Clip rectangle and orientation of a buffer; `pax_cap_state_t`.
+    PAX_CAP_STATE,
+    // Background fill; `pax_cap_draw_t`.
+    PAX_CAP_BACKGROUND,
+    // Line; `pax_cap_draw_t`, `pax_linef`, optionally `pax_cap_shader_t` and `pax_linef` UVs.
+    PAX_CAP_LINE,
+    // Rectangle; `pax_cap_draw_t`, `pax_rectf`, optionally `pax_cap_shader_t` and `pax_quadf` UVs.
+    PAX_CAP_RECT,
+    // Quad; `pax_cap_draw_t`, `pax_quadf`, optionally `pax_cap_shader_t` and `pax_quadf` UVs.
+    PAX_CAP_QUAD,
+    // Triangle; `pax_cap_draw_t`, `pax_trif`, optionally `pax_cap_shader_t` and `pax_trif` UVs.
+    PAX_CAP_TRI,
+    // Scaled image; `pax_cap_scaled_t`.
+    PAX_CAP_SCALED_IMAGE,
+    // Sprite; `pax_cap_blit_t`.
+    PAX_CAP_SPRITE,
+    // Blit; `pax_cap_blit_t`.
+    PAX_CAP_BLIT,
+    // Blit of an unmanaged buffer; `pax_cap_blit_raw_t`, pixel data in the format of the target buffer.
+    PAX_CAP_BLIT_RAW,
+    // Character; `pax_cap_blit_char_t`, bitmap.
+    PAX_CAP_BLIT_CHAR,
+    // String of text; `pax_cap_text_t`, font name, text.
+    PAX_CAP_TEXT,
+    // Polygon; `pax_cap_poly_t`, `uint32_t` point count of each contour, points.
+    PAX_CAP_POLY,
+    // Ellipse; `pax_cap_draw_t`, `pax_ellipsef`.
+    PAX_CAP_ELLIPSE,
+    // Rectangle with rounded corners; `pax_cap_draw_t`, `pax_round_rectf`.
+    PAX_CAP_ROUND_RECT,
+    // Number of kinds of records.
+    PAX_CAP_N_KINDS,
+} pax_cap_kind_t;
+
+// Header of a capture file.
+typedef struct {
+    // Equal to `PAX_CAP_MAGIC`.
+    char     magic[8];
+    // Equal to `PAX_CAP_VERSION`.
+    uint32_t version;
+    // Equal to `PAX_CAP_ENDIAN`.
+    uint32_t endian;
+} pax_cap_file_t;
+
+// Header of a record.
+typedef struct {
+    // A `pax_cap_kind_t`.
+    uint8_t  kind;
+    // Zero or more of `PAX_CAP_SHADED` and `PAX_CAP_AA`.
+    uint8_t  flags;
+    uint16_t reserved;
+    // Size of the payload in bytes.
+    uint32_t size;
+} pax_cap_hdr_t;
+
+// Format of a buffer.
+typedef struct {
+    uint32_t id;
+    uint32_t type;
+    int32_t  width, height;
+    uint32_t palette_size;
+    uint8_t  reversed;
+    uint8_t  reserved[3];
+} pax_cap_buffer_t;
+
+// Clip rectangle and orientation of a buffer.
+typedef struct {
+    uint32_t  id;
+    pax_recti clip;
+    uint32_t  orientation;
+} pax_cap_state_t;
+
+// Target and color of a draw call.
+typedef struct {
+    uint32_t  buf;
+    pax_col_t color;
+} pax_cap_draw_t;
+
+// Kinds of shaders that can be replayed.
+typedef enum {
+    // A shader that cannot be captured; replaced with one that draws the tint color.
+    PAX_CAP_SHADER_CUSTOM,
+    // `pax_shader_texture`.
+    PAX_CAP_SHADER_TEXTURE,
+    // `pax_shader_texture_aa`.
+    PAX_CAP_SHADER_TEXTURE_AA,
+    // `pax_shader_texture_span`.
+    PAX_CAP_SHADER_TEXTURE_SPAN,
+    // `pax_shader_texture_aa_span`.
+    PAX_CAP_SHADER_TEXTURE_AA_SPAN,
+    // Number of kinds of shaders.
+    PAX_CAP_N_SHADERS,
+} pax_cap_shader_kind_t;
+
+// Reference to a shader.
+typedef struct {
+    // A `pax_cap_shader_kind_t`.
+    uint8_t  kind;
+    uint8_t  alpha_promise_0;
+    uint8_t  alpha_promise_255;
+    uint8_t  reserved;
+    // Buffer ID of the texture of built-in texture shaders.
+    uint32_t texture;
+} pax_cap_shader_t;
+
+// Scaled image draw call.
+typedef struct {
+    uint32_t  base, top;
+    pax_recti base_pos;
+    uint32_t  top_orientation;
+    uint8_t   assume_opaque;
+    uint8_t   reserved[3];
+} pax_cap_scaled_t;
+
+// Sprite or blit draw call.
+typedef struct {
+    uint32_t  base, top;
+    pax_recti base_pos;
+    uint32_t  top_orientation;
+    pax_vec2i top_pos;
+} pax_cap_blit_t;
+
+// Unmanaged buffer blit draw call.
+typedef struct {
+    uint32_t  base;
+    pax_vec2i top_dims;
+    pax_recti base_pos;
+    uint32_t  top_orientation;
+    pax_vec2i top_pos;
+} pax_cap_blit_raw_t;
+
+// Character draw call.
+typedef struct {
+    uint32_t  buf;
+    pax_col_t color;
+    pax_vec2i pos;
+    int32_t   scale;
+    uint8_t   w, h, bpp, row_stride;
+} pax_cap_blit_char_t;
+
+// Text draw call.
+typedef struct {
+    uint32_t    buf;
+    pax_col_t   color;
+    matrix_2d_t matrix;
+    float       font_size;
+    pax_vec2f   pos;
+    uint32_t    halign, valign;
+    uint32_t    reserved;
+    int64_t     cursorpos;
+    uint32_t    text_len;
+    uint32_t    font_name_len;
+} pax_cap_text_t;
+
+// Polygon draw call.
+typedef struct {
+    uint32_t  buf;
+    pax_col_t color;
+    uint32_t  n_contours;
+    uint32_t  rule;
+} pax_cap_poly_t;
+
+// Size of the shape of each kind of unshaded draw call, or 0 for those that don't have one.
+static size_t const pax_cap_shape_size[PAX_CAP_N_KINDS] = {
+    [PAX_CAP_LINE]       = sizeof(pax_linef),
+    [PAX_CAP_RECT]       = sizeof(pax_rectf),
+    [PAX_CAP_QUAD]       = sizeof(pax_quadf),
+    [PAX_CAP_TRI]        = sizeof(pax_trif),
+    [PAX_CAP_ELLIPSE]    = sizeof(pax_ellipsef),
+    [PAX_CAP_ROUND_RECT] = sizeof(pax_round_rectf),
+};
+
+// Size of the UVs of each kind of shaded draw call, or 0 for those that can't be shaded.
+static size_t const pax_cap_uv_size[PAX_CAP_N_KINDS] = {
+    [PAX_CAP_LINE] = sizeof(pax_linef),
+    [PAX_CAP_RECT] = sizeof(pax_quadf),
+    [PAX_CAP_QUAD] = sizeof(pax_quadf),
+    [PAX_CAP_TRI]  = sizeof(pax_trif),
+};
+
+// Built-in shader callbacks by `pax_cap_shader_kind_t`.
+static void *const pax_cap_shaders[PAX_CAP_N_SHADERS] = {
+    [PAX_CAP_SHADER_TEXTURE]         = (void *)pax_shader_texture,
+    [PAX_CAP_SHADER_TEXTURE_AA]      = (void *)pax_shader_texture_aa,
+    [PAX_CAP_SHADER_TEXTURE_SPAN]    = (void *)pax_shader_texture_span,
+    [PAX_CAP_SHADER_TEXTURE_AA_SPAN] = (void *)pax_shader_texture_aa_span,
+};
+
+// Built-in fonts that text can be replayed with, found by name.
+static pax_font_t const *const pax_cap_fonts[] = {
+    &pax_font_sky_raw,
+    &pax_font_sky_mono_raw,
+    &pax_font_marker_raw,
+    &pax_font_saira_condensed_raw,
+    &pax_font_saira_regular_raw,
+};
+
+// Whether `type` is a valid buffer type.
+static bool pax_cap_valid_type(uint32_t type) {
+    switch (type) {
+        #define PAX_DEF_BUF_TYPE(bpp, name) case name:
+        #include "helpers/pax_buf_type.inc"
+        return true;
+        default: return false;
+    }
+}
+
+
+
+/* ========== CAPTURING ========== */
+
+// A buffer that has been written to the capture.
+typedef struct {
+    // The buffer.
+    pax_buf_t const  *buf;
+    // Pixel memory, format and size it was written with.
+    void const       *pixels;
+    pax_buf_type_t    type;
+    int               width, height;
+    // Clip rectangle and orientation as they are in the capture.
+    pax_recti         clip;
+    pax_orientation_t orientation;
+} pax_cap_known_t;
+
+// Whether draw calls are currently being captured.
+bool pax_capturing;
+
+// Guards all capture state below.
+static pthread_mutex_t  cap_mtx = PTHREAD_MUTEX_INITIALIZER;
+// File the capture is written to; `NULL` when not capturing.
+static FILE            *cap_fd;
+// Buffers written to the capture so far, by ID.
+static pax_cap_known_t *cap_known;
+static size_t           cap_known_len, cap_known_cap;
+// The record being built.
+static uint8_t         *cap_rec;
+static size_t           cap_rec_len, cap_rec_cap;
+// Whether the record being built was dropped because out of memory.
+static bool             cap_rec_failed;
+
+// Stop capturing after an error.
+static void cap_abort() {
+    __atomic_store_n(&pax_capturing, false, __ATOMIC_RELAXED);
+    cap_fd = NULL;
+}
+
+// Append data to the record being built.
+static void cap_put(void const *data, size_t size) {
+    if (cap_rec_failed || !size) {
+        return;
+    }
+    if (cap_rec_len + size > cap_rec_cap) {
+        size_t cap = cap_rec_cap ? cap_rec_cap : 256;
+        while (cap < cap_rec_len + size) {
+            cap *= 2;
+        }
+        uint8_t *mem = realloc(cap_rec, cap);
+        if (!mem) {
+            cap_rec_failed = true;
+            return;
+        }
+        cap_rec     = mem;
+        cap_rec_cap = cap;
+    }
+    memcpy(cap_rec + cap_rec_len, data, size);
+    cap_rec_len += size;
+}
+
+// Start building a new record.
+static void cap_begin(pax_cap_kind_t kind, uint8_t flags) {
+    pax_cap_hdr_t hdr = {.kind = kind, .flags = flags};
+    cap_rec_len       = 0;
+    cap_rec_failed    = false;
+    cap_put(&hdr, sizeof(hdr));
+}
+
+// Write the record being built to the capture file.
+// Records are padded to a multiple of 8 bytes so that their payloads stay aligned.
+static void cap_end() {
+    if (!cap_fd) {
+        return;
+    }
+    static uint8_t const padding[8] = {0};
+    cap_put(padding, -cap_rec_len % 8);
+    if (cap_rec_failed) {
+        PAX_LOGE(TAG, "Out of memory; capture stopped");
+        pax_set_err(PAX_ERR_NOMEM);
+        cap_abort();
+        return;
+    }
+    ((pax_cap_hdr_t *)cap_rec)->size = cap_rec_len - sizeof(pax_cap_hdr_t);
+    if (fwrite(cap_rec, 1, cap_rec_len, cap_fd) != cap_rec_len) {
+        PAX_LOGE(TAG, "Failed to write capture; capture stopped");
+        pax_set_err(PAX_ERR_ENCODE);
+        cap_abort();
+    }
+}
+
+// Get the ID of a buffer, first writing its format, palette and contents if it is new to the capture.
+// Buffers are written again if their pixel memory, format or size changed.
+static uint32_t cap_buf_id(pax_buf_t const *buf) {
+    size_t id;
+    for (id = 0; id < cap_known_len; id++) {
+        if (cap_known[id].buf == buf) {
+            break;
+        }
+    }
+    if (id < cap_known_len && cap_known[id].pixels == buf->buf && cap_known[id].type == buf->type
+        && cap_known[id].width == buf->width && cap_known[id].height == buf->height) {
+        return id;
+    }
+
+    if (id == cap_known_len) {
+        if (cap_known_len >= cap_known_cap) {
+            size_t           cap = cap_known_cap ? cap_known_cap * 2 : 8;
+            pax_cap_known_t *mem = realloc(cap_known, cap * sizeof(pax_cap_known_t));
+            if (!mem) {
+                PAX_LOGE(TAG, "Out of memory; capture stopped");
+                pax_set_err(PAX_ERR_NOMEM);
+                cap_abort();
+                return 0;
+            }
+            cap_known     = mem;
+            cap_known_cap = cap;
+        }
+        cap_known_len++;
+    }
+    // Replaying a buffer record resets the clip rectangle and orientation.
+    cap_known[id] = (pax_cap_known_t){
+        .buf         = buf,
+        .pixels      = buf->buf,
+        .type        = buf->type,
+        .width       = buf->width,
+        .height      = buf->height,
+        .clip        = {0, 0, buf->width, buf->height},
+        .orientation = PAX_O_UPRIGHT,
+    };
+
+    // The contents must include all drawing queued before this draw call.
+    pax_render_ctx_join(pax_get_render_ctx(buf));
+    pax_cap_buffer_t info = {
+        .id           = id,
+        .type         = buf->type,
+        .width        = buf->width,
+        .height       = buf->height,
+        .palette_size = buf->type_info.fmt_type == PAX_BUF_SUBTYPE_PALETTE && buf->palette ? buf->palette_size : 0,
+        .reversed     = buf->reverse_endianness,
+    };
+    cap_begin(PAX_CAP_BUFFER, 0);
+    cap_put(&info, sizeof(info));
+    cap_put(buf->palette, info.palette_size * sizeof(pax_col_t));
+    cap_put(buf->buf, pax_buf_calc_size_dynamic(buf->width, buf->height, buf->type));
+    cap_end();
+    return id;
+}
+
+// Get the ID of a buffer that is drawn to, also writing its clip rectangle and orientation if they changed.
+static uint32_t cap_target(pax_buf_t const *buf) {
+    uint32_t id = cap_buf_id(buf);
+    if (!cap_fd) {
+        return id;
+    }
+    pax_cap_known_t *known = &cap_known[id];
+    if (known->orientation != buf->orientation || memcmp(&known->clip, &buf->clip, sizeof(pax_recti))) {
+        known->clip           = buf->clip;
+        known->orientation    = buf->orientation;
+        pax_cap_state_t state = {
+            .id          = id,
+            .clip        = buf->clip,
+            .orientation = buf->orientation,
+        };
+        cap_begin(PAX_CAP_STATE, 0);
+        cap_put(&state, sizeof(state));
+        cap_end();
+    }
+    return id;
+}
+
+// Get a reference to a shader, writing its texture first if it is a built-in texture shader.
+static pax_cap_shader_t cap_shader(pax_shader_t const *shader) {
+    pax_cap_shader_t ref = {
+        .kind              = PAX_CAP_SHADER_CUSTOM,
+        .alpha_promise_0   = shader->alpha_promise_0,
+        .alpha_promise_255 = shader->alpha_promise_255,
+    };
+    for (int kind = PAX_CAP_SHADER_TEXTURE; kind < PAX_CAP_N_SHADERS; kind++) {
+        if (shader->callback == pax_cap_shaders[kind]) {
+            ref.kind    = kind;
+            ref.texture = cap_buf_id(shader->callback_args);
+            break;
+        }
+    }
+    return ref;
+}
+
+// Write a draw call of a shape, optionally with a shader.
+// `flags` are added to the record's flags; `PAX_CAP_SHADED` is added if there is a shader.
+static void cap_shape(
+    pax_cap_kind_t      kind,
+    uint8_t             flags,
+    pax_buf_t          *buf,
+    pax_col_t           color,
+    void const         *shape,
+    pax_shader_t const *shader,
+    void const         *uv
+) {
+    pthread_mutex_lock(&cap_mtx);
+    if (cap_fd) {
+        pax_cap_draw_t   draw = {cap_target(buf), color};
+        pax_cap_shader_t ref  = {0};
+        if (shader) {
+            ref = cap_shader(shader);
+        }
+        cap_begin(kind, flags | (shader ? PAX_CAP_SHADED : 0));
+        cap_put(&draw, sizeof(draw));
+        cap_put(shape, pax_cap_shape_size[kind]);
+        if (shader) {
+            cap_put(&ref, sizeof(ref));
+            cap_put(uv, pax_cap_uv_size[kind]);
+        }
+        cap_end();
+    }
+    pthread_mutex_unlock(&cap_mtx);
+}
+
+// Write a sprite or blit draw call.
+static void cap_blit(
+    pax_cap_kind_t    kind,
+    pax_buf_t        *base,
+    pax_buf_t const  *top,
+    pax_recti         base_pos,
+    pax_orientation_t top_orientation,
+    pax_vec2i         top_pos
+) {
+    pthread_mutex_lock(&cap_mtx);
+    if (cap_fd) {
+        pax_cap_blit_t blit = {
+            .base            = cap_target(base),
+            .top             = cap_buf_id(top),
+            .base_pos        = base_pos,
+            .top_orientation = top_orientation,
+            .top_pos         = top_pos,
+        };
+        cap_begin(kind, 0);
+        cap_put(&blit, sizeof(blit));
+        cap_end();
+    }
+    pthread_mutex_unlock(&cap_mtx);
+}
+
+
+
+// Background fill.
+static void pax_cap_background(pax_buf_t *buf, pax_col_t color) {
+    cap_shape(PAX_CAP_BACKGROUND, 0, buf, color, NULL, NULL, NULL);
+    pax_get_render_ctx(buf)->funcs->background(buf, color);
+}
+
+// Draw a solid-colored line.
+static void pax_cap_unshaded_line(pax_buf_t *buf, pax_col_t color, pax_linef shape) {
+    cap_shape(PAX_CAP_LINE, 0, buf, color, &shape, NULL, NULL);
+    pax_get_render_ctx(buf)->funcs->unshaded_line(buf, color, shape);
+}
+
+// Draw a solid-colored rectangle.
+static void pax_cap_unshaded_rect(pax_buf_t *buf, pax_col_t color, pax_rectf shape) {
+    cap_shape(PAX_CAP_RECT, 0, buf, color, &shape, NULL, NULL);
+    pax_get_render_ctx(buf)->funcs->unshaded_rect(buf, color, shape);
+}
+
+// Draw a solid-colored quad.
+static void pax_cap_unshaded_quad(pax_buf_t *buf, pax_col_t color, pax_quadf shape) {
+    cap_shape(PAX_CAP_QUAD, 0, buf, color, &shape, NULL, NULL);
+    pax_get_render_ctx(buf)->funcs->unshaded_quad(buf, color, shape);
+}
+
+// Draw a solid-colored triangle.
+static void pax_cap_unshaded_tri(pax_buf_t *buf, pax_col_t color, pax_trif shape) {
+    cap_shape(PAX_CAP_TRI, 0, buf, color, &shape, NULL, NULL);
+    pax_get_render_ctx(buf)->funcs->unshaded_tri(buf, color, shape);
+}
+
+// Draw a solid-colored quad with anti-aliased edges.
+static void pax_cap_unshaded_quad_aa(pax_buf_t *buf, pax_col_t color, pax_quadf shape) {
+    cap_shape(PAX_CAP_QUAD, PAX_CAP_AA, buf, color, &shape, NULL, NULL);
+    pax_render_funcs_t const *funcs = pax_get_render_ctx(buf)->funcs;
+    (funcs->unshaded_quad_aa ? funcs->unshaded_quad_aa : funcs->unshaded_quad)(buf, color, shape);
+}
+
+// Draw a solid-colored triangle with anti-aliased edges.
+static void pax_cap_unshaded_tri_aa(pax_buf_t *buf, pax_col_t color, pax_trif shape) {
+    cap_shape(PAX_CAP_TRI, PAX_CAP_AA, buf, color, &shape, NULL, NULL);
+    pax_render_funcs_t const *funcs = pax_get_render_ctx(buf)->funcs;
+    (funcs->unshaded_tri_aa ? funcs->unshaded_tri_aa : funcs->unshaded_tri)(buf, color, shape);
+}
+
+// Draw a line with a shader.
+static void
+    pax_cap_shaded_line(pax_buf_t *buf, pax_col_t color, pax_linef shape, pax_shader_t const *shader, pax_linef uv) {
+    cap_shape(PAX_CAP_LINE, 0, buf, color, &shape, shader, &uv);
+    pax_get_render_ctx(buf)->funcs->shaded_line(buf, color, shape, shader, uv);
+}
+
+// Draw a rectangle with a shader.
+static void
+    pax_cap_shaded_rect(pax_buf_t *buf, pax_col_t color, pax_rectf shape, pax_shader_t const *shader, pax_quadf uv) {
+    cap_shape(PAX_CAP_RECT, 0, buf, color, &shape, shader, &uv);
+    pax_get_render_ctx(buf)->funcs->shaded_rect(buf, color, shape, shader, uv);
+}
+
+// Draw a quad with a shader.
+static void
+    pax_cap_shaded_quad(pax_buf_t *buf, pax_col_t color, pax_quadf shape, pax_shader_t const *shader, pax_quadf uv) {
+    cap_shape(PAX_CAP_QUAD, 0, buf, color, &shape, shader, &uv);
+    pax_get_render_ctx(buf)->funcs->shaded_quad(buf, color, shape, shader, uv);
+}
+
+// Draw a triangle with a shader.
+static void
+    pax_cap_shaded_tri(pax_buf_t *buf, pax_col_t color, pax_trif shape, pax_shader_t const *shader, pax_trif uv) {
+    cap_shape(PAX_CAP_TRI, 0, buf, color, &shape, shader, &uv);
+    pax_get_render_ctx(buf)->funcs->shaded_tri(buf, color, shape, shader, uv);
+}
+
+// Draw an axis-aligned image with fractional scaling.
+static void pax_cap_scaled_image(
+    pax_buf_t *base, pax_buf_t const *top, pax_recti base_pos, pax_orientation_t top_orientation, bool assume_opaque
+) {
+    pthread_mutex_lock(&cap_mtx);
+    if (cap_fd) {
+        pax_cap_scaled_t scaled = {
+            .base            = cap_target(base),
+            .top             = cap_buf_id(top),
+            .base_pos        = base_pos,
+            .top_orientation = top_orientation,
+            .assume_opaque   = assume_opaque,
+        };
+        cap_begin(PAX_CAP_SCALED_IMAGE, 0);
+        cap_put(&scaled, sizeof(scaled));
+        cap_end();
+    }
+    pthread_mutex_unlock(&cap_mtx);
+    pax_get_render_ctx(base)->funcs->scaled_image(base, top, base_pos, top_orientation, assume_opaque);
+}
+
+// Draw a sprite; like a blit, but use color blending if applicable.
+static void pax_cap_sprite(
+    pax_buf_t *base, pax_buf_t const *top, pax_recti base_pos, pax_orientation_t top_orientation, pax_vec2i top_pos
+) {
+    cap_blit(PAX_CAP_SPRITE, base, top, base_pos, top_orientation, top_pos);
+    pax_get_render_ctx(base)->funcs->sprite(base, top, base_pos, top_orientation, top_pos);
+}
+
+// Perform a buffer copying operation with a PAX buffer.
+static void pax_cap_blit(
+    pax_buf_t *base, pax_buf_t const *top, pax_recti base_pos, pax_orientation_t top_orientation, pax_vec2i top_pos
+) {
+    cap_blit(PAX_CAP_BLIT, base, top, base_pos, top_orientation, top_pos);
+    pax_get_render_ctx(base)->funcs->blit(base, top, base_pos, top_orientation, top_pos);
+}
+
+// Perform a buffer copying operation with an unmanaged user buffer.
+static void pax_cap_blit_raw(
+    pax_buf_t        *base,
+    void const       *top,
+    pax_vec2i         top_dims,
+    pax_recti         base_pos,
+    pax_orientation_t top_orientation,
+    pax_vec2i         top_pos
+) {
+    pthread_mutex_lock(&cap_mtx);
+    if (cap_fd) {
+        pax_cap_blit_raw_t blit = {
+            .base            = cap_target(base),
+            .top_dims        = top_dims,
+            .base_pos        = base_pos,
+            .top_orientation = top_orientation,
+            .top_pos         = top_pos,
+        };
+        cap_begin(PAX_CAP_BLIT_RAW, 0);
+        cap_put(&blit, sizeof(blit));
+        cap_put(top, pax_buf_calc_size_dynamic(top_dims.x, top_dims.y, base->type));
+        cap_end();
+    }
+    pthread_mutex_unlock(&cap_mtx);
+    pax_get_render_ctx(base)->funcs->blit_raw(base, top, top_dims, base_pos, top_orientation, top_pos);
+}
+
+// Blit a character of text in the bitmapped format.
+static void pax_cap_blit_char(pax_buf_t *buf, pax_col_t color, pax_vec2i pos, int scale, pax_text_rsdata_t rsdata) {
+    pthread_mutex_lock(&cap_mtx);
+    if (cap_fd) {
+        pax_cap_blit_char_t blit_char = {
+            .buf        = cap_target(buf),
+            .color      = color,
+            .pos        = pos,
+            .scale      = scale,
+            .w          = rsdata.w,
+            .h          = rsdata.h,
+            .bpp        = rsdata.bpp,
+            .row_stride = rsdata.row_stride,
+        };
+        cap_begin(PAX_CAP_BLIT_CHAR, 0);
+        cap_put(&blit_char, sizeof(blit_char));
+        cap_put(rsdata.bitmap, rsdata.row_stride * rsdata.h);
+        cap_end();
+    }
+    pthread_mutex_unlock(&cap_mtx);
+    pax_get_render_ctx(buf)->funcs->blit_char(buf, color, pos, scale, rsdata);
+}
+
+// Draw a string of text in the bitmapped format.
+static void pax_cap_text(
+    pax_buf_t        *buf,
+    matrix_2d_t       matrix,
+    pax_col_t         color,
+    pax_font_t const *font,
+    float             font_size,
+    pax_vec2f         pos,
+    char const       *text,
+    size_t            text_len,
+    pax_align_t       halign,
+    pax_align_t       valign,
+    ptrdiff_t         cursorpos
+) {
+    pthread_mutex_lock(&cap_mtx);
+    if (cap_fd) {
+        pax_cap_text_t info = {
+            .buf           = cap_target(buf),
+            .color         = color,
+            .matrix        = matrix,
+            .font_size     = font_size,
+            .pos           = pos,
+            .halign        = halign,
+            .valign        = valign,
+            .cursorpos     = cursorpos,
+            .text_len      = text_len,
+            .font_name_len = font->name ? strlen(font->name) : 0,
+        };
+        cap_begin(PAX_CAP_TEXT, 0);
+        cap_put(&info, sizeof(info));
+        cap_put(font->name, info.font_name_len);
+        cap_put(text, text_len);
+        cap_end();
+    }
+    pthread_mutex_unlock(&cap_mtx);
+    pax_get_render_ctx(buf)
+        ->funcs->text(buf, matrix, color, font, font_size, pos, text, text_len, halign, valign, cursorpos);
+}
+
+// Target of `cap_span_rect`.
+typedef struct {
+    pax_buf_t                *buf;
+    pax_col_t                 color;
+    pax_render_funcs_t const *funcs;
+} cap_span_t;
+
+// Draw one span of a polygon, ellipse or rounded rectangle as a rectangle, for render engines that can't draw those.
+static void cap_span_rect(void *args, int x, int y, int len) {
+    cap_span_t *ctx = args;
+    ctx->funcs->unshaded_rect(ctx->buf, ctx->color, (pax_rectf){x, y, len, 1});
+}
+
+// Draw a solid-colored polygon.
+static void pax_cap_unshaded_poly(pax_buf_t *buf, pax_col_t color, pax_polyf shape) {
+    pthread_mutex_lock(&cap_mtx);
+    if (cap_fd) {
+        pax_cap_poly_t info = {
+            .buf        = cap_target(buf),
+            .color      = color,
+            .n_contours = shape.n_contours,
+            .rule       = shape.rule,
+        };
+        size_t n_points = 0;
+        cap_begin(PAX_CAP_POLY, 0);
+        cap_put(&info, sizeof(info));
+        for (size_t i = 0; i < shape.n_contours; i++) {
+            uint32_t len  = shape.contour_lens[i];
+            n_points     += len;
+            cap_put(&len, sizeof(len));
+        }
+        cap_put(shape.points, n_points * sizeof(pax_vec2f));
+        cap_end();
+    }
+    pthread_mutex_unlock(&cap_mtx);
+    pax_render_funcs_t const *funcs = pax_get_render_ctx(buf)->funcs;
+    if (funcs->unshaded_poly) {
+        funcs->unshaded_poly(buf, color, shape);
+    } else {
+        cap_span_t ctx = {buf, color, funcs};
+        pax_poly_spans(buf, shape, cap_span_rect, &ctx);
+    }
+}
+
+// Draw a solid-colored ellipse or elliptic ring.
+static void pax_cap_unshaded_ellipse(pax_buf_t *buf, pax_col_t color, pax_ellipsef shape) {
+    cap_shape(PAX_CAP_ELLIPSE, 0, buf, color, &shape, NULL, NULL);
+    pax_render_funcs_t const *funcs = pax_get_render_ctx(buf)->funcs;
+    if (funcs->unshaded_ellipse) {
+        funcs->unshaded_ellipse(buf, color, shape);
+    } else {
+        cap_span_t ctx = {buf, color, funcs};
+        pax_ellipse_spans(buf, shape, cap_span_rect, &ctx);
+    }
+}
+
+// Draw a solid-colored rectangle with rounded corners.
+static void pax_cap_unshaded_round_rect(pax_buf_t *buf, pax_col_t color, pax_round_rectf shape) {
+    cap_shape(PAX_CAP_ROUND_RECT, 0, buf, color, &shape, NULL, NULL);
+    pax_render_funcs_t const *funcs = pax_get_render_ctx(buf)->funcs;
+    if (funcs->unshaded_round_rect) {
+        funcs->unshaded_round_rect(buf, color, shape);
+    } else {
+        cap_span_t ctx = {buf, color, funcs};
+        pax_round_rect_spans(buf, shape, cap_span_rect, &ctx);
+    }
+}
+
+// Draw a solid-colored rectangle with rounded corners and anti-aliased edges.
+static void pax_cap_unshaded_round_rect_aa(pax_buf_t *buf, pax_col_t color, pax_round_rectf shape) {
+    cap_shape(PAX_CAP_ROUND_RECT, PAX_CAP_AA, buf, color, &shape, NULL, NULL);
+    pax_render_funcs_t const *funcs = pax_get_render_ctx(buf)->funcs;
+    if (funcs->unshaded_round_rect_aa) {
+        funcs->unshaded_round_rect_aa(buf, color, shape);
+    } else if (funcs->unshaded_round_rect) {
+        funcs->unshaded_round_rect(buf, color, shape);
+    } else {
+        cap_span_t ctx = {buf, color, funcs};
+        pax_round_rect_spans(buf, shape, cap_span_rect, &ctx);
+    }
+}
+
+// Render functions that write draw calls to the capture before drawing them.
+pax_render_funcs_t const pax_render_funcs_capture = {
+    .background             = pax_cap_background,
+    .unshaded_line          = pax_cap_unshaded_line,
+    .unshaded_rect          = pax_cap_unshaded_rect,
+    .unshaded_quad          = pax_cap_unshaded_quad,
+    .unshaded_tri           = pax_cap_unshaded_tri,
+    .unshaded_quad_aa       = pax_cap_unshaded_quad_aa,
+    .unshaded_tri_aa        = pax_cap_unshaded_tri_aa,
+    .unshaded_poly          = pax_cap_unshaded_poly,
+    .unshaded_ellipse       = pax_cap_unshaded_ellipse,
+    .unshaded_round_rect    = pax_cap_unshaded_round_rect,
+    .unshaded_round_rect_aa = pax_cap_unshaded_round_rect_aa,
+    .shaded_line            = pax_cap_shaded_line,
+    .shaded_rect            = pax_cap_shaded_rect,
+    .shaded_quad            = pax_cap_shaded_quad,
+    .shaded_tri             = pax_cap_shaded_tri,
+    .scaled_image           = pax_cap_scaled_image,
+    .sprite                 = pax_cap_sprite,
+    .blit                   = pax_cap_blit,
+    .blit_raw               = pax_cap_blit_raw,
+    .blit_char              = pax_cap_blit_char,
+    .text                   = pax_cap_text,
+};
+
+// Start writing every draw call made to any buffer to `fd`, for replaying later with `pax_capture_replay`.
+// The format, size, palette, contents, clip rectangle and orientation of buffers are written when they are first used.
+// Texture shaders and fonts are written by reference to the built-in ones; other shaders are replaced when replayed.
+// Returns `false` if a capture is already in progress, writing fails or capture is not compiled in.
+bool pax_capture_start(FILE *fd) {
+    PAX_NULL_CHECK(fd, false);
+    pthread_mutex_lock(&cap_mtx);
+    if (cap_fd) {
+        pthread_mutex_unlock(&cap_mtx);
+        PAX_LOGE(TAG, "A capture is already in progress");
+        PAX_ERROR(PAX_ERR_PARAM, false);
+    }
+    pax_cap_file_t hdr = {
+        .magic   = PAX_CAP_MAGIC,
+        .version = PAX_CAP_VERSION,
+        .endian  = PAX_CAP_ENDIAN,
+    };
+    if (fwrite(&hdr, sizeof(hdr), 1, fd) != 1) {
+        pthread_mutex_unlock(&cap_mtx);
+        PAX_LOGE(TAG, "Failed to write capture");
+        PAX_ERROR(PAX_ERR_ENCODE, false);
+    }
+    cap_fd        = fd;
+    cap_known_len = 0;
+    __atomic_store_n(&pax_capturing, true, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&cap_mtx);
+    return true;
+}
+
+// Stop capturing draw calls; `fd` is flushed but not closed.
+void pax_capture_stop() {
+    pthread_mutex_lock(&cap_mtx);
+    __atomic_store_n(&pax_capturing, false, __ATOMIC_RELAXED);
+    if (cap_fd) {
+        fflush(cap_fd);
+        cap_fd = NULL;
+    }
+    free(cap_known);
+    free(cap_rec);
+    cap_known     = NULL;
+    cap_known_len = 0;
+    cap_known_cap = 0;
+    cap_rec       = NULL;
+    cap_rec_cap   = 0;
+    pthread_mutex_unlock(&cap_mtx);
+}
+
+
+
+/* ========== REPLAYING ========== */
+
+// Draw calls read back from a capture file.
+struct pax_capture {
+    // Records, without the file header.
+    uint8_t   *data;
+    size_t     size;
+    // Buffers drawn to and from, by ID.
+    pax_buf_t *bufs;
+    size_t     n_bufs;
+    // Number of draw calls.
+    size_t     n_calls;
+};
+
+// Read a struct from a record payload.
+    #define CAP_READ(var, ptr) memcpy(&(var), (ptr), sizeof(var))
+
+// Stands in for shaders that could not be captured; draws the tint color.
+static pax_col_t cap_stand_in(pax_col_t tint, pax_col_t existing, int x, int y, float u, float v, void *args) {
+    (void)x;
+    (void)y;
+    (void)u;
+    (void)v;
+    (void)args;
+    return pax_col_merge(existing, tint);
+}
+
+// Find a built-in font by name; `NULL` if there is none.
+static pax_font_t const *cap_find_font(char const *name, size_t name_len) {
+    for (size_t i = 0; i < sizeof(pax_cap_fonts) / sizeof(*pax_cap_fonts); i++) {
+        if (strlen(pax_cap_fonts[i]->name) == name_len && !memcmp(pax_cap_fonts[i]->name, name, name_len)) {
+            return pax_cap_fonts[i];
+        }
+    }
+    return NULL;
+}
+
+// Get the expected payload size of a record, or 0 if it refers to buffers that don't exist or has invalid values.
+// Adds new buffers to `capture->bufs`, with only their format and size set.
+static size_t cap_check_record(pax_capture_t *capture, pax_cap_hdr_t hdr, uint8_t const *payload) {
+    size_t     n_bufs = capture->n_bufs;
+    pax_buf_t *bufs   = capture->bufs;
+    if (hdr.kind < PAX_CAP_LINE || hdr.kind > PAX_CAP_TRI ? hdr.flags : hdr.flags & ~PAX_CAP_SHADED) {
+        // Only unshaded triangles, quads and rounded rectangles can be anti-aliased.
+        bool aa_kind = hdr.kind == PAX_CAP_QUAD || hdr.kind == PAX_CAP_TRI || hdr.kind == PAX_CAP_ROUND_RECT;
+        if (hdr.flags != PAX_CAP_AA || !aa_kind) {
+            return 0;
+        }
+    }
+
+    switch (hdr.kind) {
+        case PAX_CAP_BUFFER: {
+            pax_cap_buffer_t info;
+            if (hdr.size < sizeof(info)) {
+                return 0;
+            }
+            CAP_READ(info, payload);
+            if (info.id > n_bufs || !pax_cap_valid_type(info.type) || info.width <= 0 || info.height <= 0
+                || (int64_t)info.width * info.height > PAX_CAP_MAX_PIXELS) {
+                return 0;
+            }
+            pax_buf_type_info_t type_info = pax_buf_type_info(info.type);
+            if (type_info.fmt_type == PAX_BUF_SUBTYPE_PALETTE ? info.palette_size > (1u << type_info.bpp)
+                                                               : info.palette_size) {
+                return 0;
+            }
+            if (info.id == n_bufs) {
+                bufs = realloc(bufs, (n_bufs + 1) * sizeof(pax_buf_t));
+                if (!bufs) {
+                    return 0;
+                }
+                memset(&bufs[n_bufs], 0, sizeof(pax_buf_t));
+                capture->bufs = bufs;
+                capture->n_bufs++;
+            }
+            bufs[info.id].type   = info.type;
+            bufs[info.id].width  = info.width;
+            bufs[info.id].height = info.height;
+            return sizeof(info) + info.palette_size * sizeof(pax_col_t)
+                   + pax_buf_calc_size_dynamic(info.width, info.height, info.type);
+        }
+        case PAX_CAP_STATE: {
+            pax_cap_state_t state;
+            if (hdr.size < sizeof(state)) {
+                return 0;
+            }
+            CAP_READ(state, payload);
+            if (state.id >= n_bufs || state.orientation > PAX_O_ROT_CW_FLIP_H) {
+                return 0;
+            }
+            // The clip rectangle must be inside the buffer, because drawing code relies on it.
+            pax_recti clip  = state.clip;
+            bool      valid = clip.x >= 0 && clip.y >= 0 && clip.w >= 0 && clip.h >= 0
+                         && clip.x + clip.w <= bufs[state.id].width && clip.y + clip.h <= bufs[state.id].height;
+            return valid ? sizeof(state) : 0;
+        }
+        case PAX_CAP_BACKGROUND:
+        case PAX_CAP_LINE:
+        case PAX_CAP_RECT:
+        case PAX_CAP_QUAD:
+        case PAX_CAP_TRI:
+        case PAX_CAP_ELLIPSE:
+        case PAX_CAP_ROUND_RECT: {
+            pax_cap_draw_t   draw;
+            pax_cap_shader_t ref;
+            size_t           size = sizeof(draw) + pax_cap_shape_size[hdr.kind];
+            if (hdr.size < size || (hdr.flags & PAX_CAP_SHADED && hdr.size < size + sizeof(ref))) {
+                return 0;
+            }
+            CAP_READ(draw, payload);
+            if (draw.buf >= n_bufs || (hdr.flags & PAX_CAP_SHADED && !pax_cap_uv_size[hdr.kind])) {
+                return 0;
+            }
+            if (hdr.flags & PAX_CAP_SHADED) {
+                CAP_READ(ref, payload + size);
+                if (ref.kind >= PAX_CAP_N_SHADERS || (ref.kind != PAX_CAP_SHADER_CUSTOM && ref.texture >= n_bufs)) {
+                    return 0;
+                }
+                size += sizeof(ref) + pax_cap_uv_size[hdr.kind];
+            }
+            return size;
+        }
+        case PAX_CAP_SCALED_IMAGE: {
+            pax_cap_scaled_t scaled;
+            if (hdr.size < sizeof(scaled)) {
+                return 0;
+            }
+            CAP_READ(scaled, payload);
+            bool valid = scaled.base < n_bufs && scaled.top < n_bufs && scaled.top_orientation <= PAX_O_ROT_CW_FLIP_H;
+            return valid ? sizeof(scaled) : 0;
+        }
+        case PAX_CAP_SPRITE:
+        case PAX_CAP_BLIT: {
+            pax_cap_blit_t blit;
+            if (hdr.size < sizeof(blit)) {
+                return 0;
+            }
+            CAP_READ(blit, payload);
+            bool valid = blit.base < n_bufs && blit.top < n_bufs && blit.top_orientation <= PAX_O_ROT_CW_FLIP_H;
+            return valid ? sizeof(blit) : 0;
+        }
+        case PAX_CAP_BLIT_RAW: {
+            pax_cap_blit_raw_t blit;
+            if (hdr.size < sizeof(blit)) {
+                return 0;
+            }
+            CAP_READ(blit, payload);
+            if (blit.base >= n_bufs || blit.top_orientation > PAX_O_ROT_CW_FLIP_H || blit.top_dims.x <= 0
+                || blit.top_dims.y <= 0 || (int64_t)blit.top_dims.x * blit.top_dims.y > PAX_CAP_MAX_PIXELS) {
+                return 0;
+            }
+            return sizeof(blit) + pax_buf_calc_size_dynamic(blit.top_dims.x, blit.top_dims.y, bufs[blit.base].type);
+        }
+        case PAX_CAP_BLIT_CHAR: {
+            pax_cap_blit_char_t blit_char;
+            if (hdr.size < sizeof(blit_char)) {
+                return 0;
+            }
+            CAP_READ(blit_char, payload);
+            if (blit_char.buf >= n_bufs || blit_char.scale <= 0
+                || (blit_char.bpp != 1 && blit_char.bpp != 2 && blit_char.bpp != 4 && blit_char.bpp != 8)
+                || blit_char.row_stride < (blit_char.w * blit_char.bpp + 7) / 8) {
+                return 0;
+            }
+            return sizeof(blit_char) + blit_char.row_stride * blit_char.h;
+        }
+        case PAX_CAP_TEXT: {
+            pax_cap_text_t info;
+            if (hdr.size < sizeof(info)) {
+                return 0;
+            }
+            CAP_READ(info, payload);
+            if (info.buf >= n_bufs || info.halign > PAX_ALIGN_END || info.valign > PAX_ALIGN_END
+                || info.font_name_len > hdr.size - sizeof(info)) {
+                return 0;
+            }
+            char const *font_name = (char const *)payload + sizeof(info);
+            if (!cap_find_font(font_name, info.font_name_len)) {
+                PAX_LOGW(
+                    TAG,
+                    "Font \"%.*s\" is not built in; text will be replayed with the default font",
+                    (int)info.font_name_len,
+                    font_name
+                );
+            }
+            return sizeof(info) + info.font_name_len + info.text_len;
+        }
+        case PAX_CAP_POLY: {
+            pax_cap_poly_t info;
+            if (hdr.size < sizeof(info)) {
+                return 0;
+            }
+            CAP_READ(info, payload);
+            if (info.buf >= n_bufs || info.rule > PAX_FILL_EVENODD
+                || info.n_contours > (hdr.size - sizeof(info)) / sizeof(uint32_t)) {
+                return 0;
+            }
+            uint64_t n_points = 0;
+            for (uint32_t i = 0; i < info.n_contours; i++) {
+                uint32_t len;
+                CAP_READ(len, payload + sizeof(info) + i * sizeof(uint32_t));
+                n_points += len;
+            }
+            size_t size = sizeof(info) + info.n_contours * sizeof(uint32_t);
+            if (n_points > (hdr.size - size) / sizeof(pax_vec2f)) {
+                return 0;
+            }
+            return size + n_points * sizeof(pax_vec2f);
+        }
+        default: return 0;
+    }
+}
+
+// Check that the records of a capture are well-formed and count its buffers and draw calls.
+static bool cap_check(pax_capture_t *capture) {
+    size_t pos = 0;
+    while (pos < capture->size) {
+        pax_cap_hdr_t hdr;
+        if (capture->size - pos < sizeof(hdr)) {
+            return false;
+        }
+        CAP_READ(hdr, capture->data + pos);
+        pos += sizeof(hdr);
+        if (hdr.size > capture->size - pos) {
+            return false;
+        }
+        size_t size = cap_check_record(capture, hdr, capture->data + pos);
+        if (!size || (size + 7) / 8 * 8 != hdr.size) {
+            return false;
+        }
+        if (hdr.kind >= PAX_CAP_BACKGROUND) {
+            capture->n_calls++;
+        }
+        pos += hdr.size;
+    }
+    return true;
+}
+
+// Read a capture written by `pax_capture_start`.
+// Returns `NULL` if `fd` does not contain a valid capture or out of memory.
+pax_capture_t *pax_capture_load(FILE *fd) {
+    PAX_NULL_CHECK(fd, NULL);
+    pax_cap_file_t hdr;
+    if (fread(&hdr, sizeof(hdr), 1, fd) != 1 || memcmp(hdr.magic, PAX_CAP_MAGIC, sizeof(hdr.magic))) {
+        PAX_LOGE(TAG, "Not a capture file");
+        PAX_ERROR(PAX_ERR_DECODE, NULL);
+    }
+    if (hdr.version != PAX_CAP_VERSION || hdr.endian != PAX_CAP_ENDIAN) {
+        PAX_LOGE(TAG, "Capture was made with a different version of PAX or on a machine with different endianness");
+        PAX_ERROR(PAX_ERR_UNSUPPORTED, NULL);
+    }
+
+    pax_capture_t *capture = calloc(1, sizeof(pax_capture_t));
+    if (!capture) {
+        PAX_ERROR(PAX_ERR_NOMEM, NULL);
+    }
+    size_t cap = 0;
+    while (!feof(fd)) {
+        if (capture->size == cap) {
+            cap          = cap ? cap * 2 : 65536;
+            uint8_t *mem = realloc(capture->data, cap);
+            if (!mem) {
+                pax_capture_free(capture);
+                PAX_ERROR(PAX_ERR_NOMEM, NULL);
+            }
+            capture->data = mem;
+        }
+        capture->size += fread(capture->data + capture->size, 1, cap - capture->size, fd);
+        if (ferror(fd)) {
+            PAX_LOGE(TAG, "Failed to read capture");
+            pax_capture_free(capture);
+            PAX_ERROR(PAX_ERR_UNKNOWN, NULL);
+        }
+    }
+
+    if (!cap_check(capture)) {
+        PAX_LOGE(TAG, "Capture is corrupt or truncated");
+        pax_capture_free(capture);
+        PAX_ERROR(PAX_ERR_CORRUPT, NULL);
+    }
+    // Buffers are created when replayed.
+    if (capture->n_bufs) {
+        memset(capture->bufs, 0, capture->n_bufs * sizeof(pax_buf_t));
+    }
+    pax_set_ok();
+    return capture;
+}
+
+// Free a capture read by `pax_capture_load` and the buffers it replays into.
+void pax_capture_free(pax_capture_t *capture) {
+    if (!capture) {
+        return;
+    }
+    for (size_t i = 0; i < capture->n_bufs; i++) {
+        if (capture->bufs[i].buf) {
+            pax_buf_join(&capture->bufs[i]);
+            pax_buf_destroy(&capture->bufs[i]);
+        }
+    }
+    free(capture->bufs);
+    free(capture->data);
+    free(capture);
+}
+
+// Replay a buffer record: set the format, palette and contents of the buffer.
+// Returns `false` if out of memory.
+static bool cap_replay_buffer(pax_capture_t *capture, uint8_t const *payload) {
+    pax_cap_buffer_t info;
+    CAP_READ(info, payload);
+    pax_col_t const *palette = (pax_col_t const *)(payload + sizeof(info));
+    uint8_t const   *pixels  = payload + sizeof(info) + info.palette_size * sizeof(pax_col_t);
+    size_t           size    = pax_buf_calc_size_dynamic(info.width, info.height, info.type);
+    pax_buf_t       *buf     = &capture->bufs[info.id];
+
+    if (buf->buf) {
+        // The buffer may still be drawn to or from by queued draw calls.
+        pax_buf_join(buf);
+        if (buf->type != info.type || buf->width != info.width || buf->height != info.height) {
+            pax_buf_destroy(buf);
+            buf->buf = NULL;
+        }
+    }
+    if (!buf->buf) {
+        void *mem = malloc(size);
+        if (!mem) {
+            return false;
+        }
+        pax_buf_init(buf, mem, info.width, info.height, info.type);
+        buf->do_free = true;
+    }
+
+    memcpy(buf->buf, pixels, size);
+    if (info.palette_size) {
+        pax_buf_set_palette(buf, palette, info.palette_size);
+        if (pax_get_err() != PAX_OK) {
+            return false;
+        }
+    }
+    pax_buf_reversed(buf, info.reversed);
+    pax_noclip(buf);
+    buf->orientation = PAX_O_UPRIGHT;
+    return true;
+}
+
+// Make the shader a shader reference is replayed with.
+static pax_shader_t cap_replay_shader(pax_capture_t *capture, pax_cap_shader_t ref) {
+    pax_shader_t shader = {
+        .schema_version    = 1,
+        .schema_complement = (uint8_t)~1,
+        .renderer_id       = PAX_RENDERER_ID_SWR,
+        .callback          = (void *)cap_stand_in,
+        .alpha_promise_0   = ref.alpha_promise_0,
+        .alpha_promise_255 = ref.alpha_promise_255,
+    };
+    if (ref.kind != PAX_CAP_SHADER_CUSTOM) {
+        shader.callback      = pax_cap_shaders[ref.kind];
+        shader.callback_args = &capture->bufs[ref.texture];
+        if (ref.kind >= PAX_CAP_SHADER_TEXTURE_SPAN) {
+            shader.schema_version    = 2;
+            shader.schema_complement = (uint8_t)~2;
+        }
+    }
+    return shader;
+}
+
+// Replay a draw call of a shape.
+static void cap_replay_shape(pax_capture_t *capture, pax_cap_hdr_t hdr, uint8_t const *payload) {
+    union {
+        pax_linef       line;
+        pax_rectf       rect;
+        pax_quadf       quad;
+        pax_trif        tri;
+        pax_ellipsef    ellipse;
+        pax_round_rectf round_rect;
+    } shape, uv;
+    pax_cap_draw_t   draw;
+    pax_cap_shader_t ref;
+    CAP_READ(draw, payload);
+    payload += sizeof(draw);
+    memcpy(&shape, payload, pax_cap_shape_size[hdr.kind]);
+    payload += pax_cap_shape_size[hdr.kind];
+    pax_buf_t *buf = &capture->bufs[draw.buf];
+
+    if (!(hdr.flags & PAX_CAP_SHADED)) {
+        switch (hdr.kind) {
+            case PAX_CAP_BACKGROUND: pax_dispatch_background(buf, draw.color); break;
+            case PAX_CAP_LINE: pax_dispatch_unshaded_line(buf, draw.color, shape.line); break;
+            case PAX_CAP_RECT: pax_dispatch_unshaded_rect(buf, draw.color, shape.rect); break;
+            case PAX_CAP_QUAD:
+                if (hdr.flags & PAX_CAP_AA) {
+                    pax_dispatch_unshaded_quad_aa(buf, draw.color, shape.quad);
+                } else {
+                    pax_dispatch_unshaded_quad(buf, draw.color, shape.quad);
+                }
+                break;
+            case PAX_CAP_TRI:
+                if (hdr.flags & PAX_CAP_AA) {
+                    pax_dispatch_unshaded_tri_aa(buf, draw.color, shape.tri);
+                } else {
+                    pax_dispatch_unshaded_tri(buf, draw.color, shape.tri);
+                }
+                break;
+            case PAX_CAP_ELLIPSE: pax_dispatch_unshaded_ellipse(buf, draw.color, shape.ellipse); break;
+            case PAX_CAP_ROUND_RECT:
+                if (hdr.flags & PAX_CAP_AA) {
+                    pax_dispatch_unshaded_round_rect_aa(buf, draw.color, shape.round_rect);
+                } else {
+                    pax_dispatch_unshaded_round_rect(buf, draw.color, shape.round_rect);
+                }
+                break;
+        }
+        return;
+    }
+
+    CAP_READ(ref, payload);
+    payload += sizeof(ref);
+    memcpy(&uv, payload, pax_cap_uv_size[hdr.kind]);
+    pax_shader_t shader = cap_replay_shader(capture, ref);
+    switch (hdr.kind) {
+        case PAX_CAP_LINE: pax_dispatch_shaded_line(buf, draw.color, shape.line, &shader, uv.line); break;
+        case PAX_CAP_RECT: pax_dispatch_shaded_rect(buf, draw.color, shape.rect, &shader, uv.quad); break;
+        case PAX_CAP_QUAD: pax_dispatch_shaded_quad(buf, draw.color, shape.quad, &shader, uv.quad); break;
+        case PAX_CAP_TRI: pax_dispatch_shaded_tri(buf, draw.color, shape.tri, &shader, uv.tri); break;
+    }
+}
+
+// Replay a single record.
+// Returns `false` if out of memory.
+static bool cap_replay_record(pax_capture_t *capture, pax_cap_hdr_t hdr, uint8_t const *payload) {
+    pax_buf_t *bufs = capture->bufs;
+    switch (hdr.kind) {
+        case PAX_CAP_BUFFER: return cap_replay_buffer(capture, payload);
+        case PAX_CAP_STATE: {
+            pax_cap_state_t state;
+            CAP_READ(state, payload);
+            bufs[state.id].clip        = state.clip;
+            bufs[state.id].orientation = state.orientation;
+        } break;
+        case PAX_CAP_BACKGROUND:
+        case PAX_CAP_LINE:
+        case PAX_CAP_RECT:
+        case PAX_CAP_QUAD:
+        case PAX_CAP_TRI:
+        case PAX_CAP_ELLIPSE:
+        case PAX_CAP_ROUND_RECT: cap_replay_shape(capture, hdr, payload); break;
+        case PAX_CAP_SCALED_IMAGE: {
+            pax_cap_scaled_t scaled;
+            CAP_READ(scaled, payload);
+            pax_dispatch_scaled_image(
+                &bufs[scaled.base],
+                &bufs[scaled.top],
+                scaled.base_pos,
+                scaled.top_orientation,
+                scaled.assume_opaque
+            );
+        } break;
+        case PAX_CAP_SPRITE:
+        case PAX_CAP_BLIT: {
+            pax_cap_blit_t blit;
+            CAP_READ(blit, payload);
+            (hdr.kind == PAX_CAP_SPRITE ? pax_dispatch_sprite : pax_dispatch_blit)(
+                &bufs[blit.base],
+                &bufs[blit.top],
+                blit.base_pos,
+                blit.top_orientation,
+                blit.top_pos
+            );
+        } break;
+        case PAX_CAP_BLIT_RAW: {
+            pax_cap_blit_raw_t blit;
+            CAP_READ(blit, payload);
+            pax_dispatch_blit_raw(
+                &bufs[blit.base],
+                payload + sizeof(blit),
+                blit.top_dims,
+                blit.base_pos,
+                blit.top_orientation,
+                blit.top_pos
+            );
+        } break;
+        case PAX_CAP_BLIT_CHAR: {
+            pax_cap_blit_char_t blit_char;
+            CAP_READ(blit_char, payload);
+            pax_text_rsdata_t rsdata = {
+                .w          = blit_char.w,
+                .h          = blit_char.h,
+                .bpp        = blit_char.bpp,
+                .row_stride = blit_char.row_stride,
+                .bitmap     = payload + sizeof(blit_char),
+            };
+            pax_dispatch_blit_char(&bufs[blit_char.buf], blit_char.color, blit_char.pos, blit_char.scale, rsdata);
+        } break;
+        case PAX_CAP_TEXT: {
+            pax_cap_text_t info;
+            CAP_READ(info, payload);
+            char const       *font_name = (char const *)payload + sizeof(info);
+            pax_font_t const *font      = cap_find_font(font_name, info.font_name_len);
+            pax_dispatch_text(
+                &bufs[info.buf],
+                info.matrix,
+                info.color,
+                font ? font : PAX_FONT_DEFAULT,
+                info.font_size,
+                info.pos,
+                font_name + info.font_name_len,
+                info.text_len,
+                info.halign,
+                info.valign,
+                info.cursorpos
+            );
+        } break;
+        case PAX_CAP_POLY: {
+            pax_cap_poly_t info;
+            CAP_READ(info, payload);
+            size_t *contour_lens = malloc(info.n_contours * sizeof(size_t));
+            if (info.n_contours && !contour_lens) {
+                return false;
+            }
+            for (uint32_t i = 0; i < info.n_contours; i++) {
+                uint32_t len;
+                CAP_READ(len, payload + sizeof(info) + i * sizeof(uint32_t));
+                contour_lens[i] = len;
+            }
+            pax_polyf shape = {
+                .points       = (pax_vec2f const *)(payload + sizeof(info) + info.n_contours * sizeof(uint32_t)),
+                .contour_lens = contour_lens,
+                .n_contours   = info.n_contours,
+                .rule         = info.rule,
+            };
+            pax_dispatch_unshaded_poly(&bufs[info.buf], info.color, shape);
+            free(contour_lens);
+        } break;
+    }
+    return true;
+}
+
+// Replay every draw call in a capture through the default render context.
+// Buffers are restored to the state they were captured in first, so a capture can be replayed any number of times.
+// Call `pax_join` afterwards to wait for drawing to finish.
+void pax_capture_replay(pax_capture_t *capture) {
+    PAX_NULL_CHECK(capture);
+    size_t pos = 0;
+    while (pos < capture->size) {
+        pax_cap_hdr_t hdr;
+        CAP_READ(hdr, capture->data + pos);
+        pos += sizeof(hdr);
+        if (!cap_replay_record(capture, hdr, capture->data + pos)) {
+            PAX_LOGE(TAG, "Out of memory; replay stopped");
+            PAX_ERROR(PAX_ERR_NOMEM);
+        }
+        pos += hdr.size;
+    }
+}
+
+// Get the number of draw calls in a capture.
+size_t pax_capture_len(pax_capture_t const *capture) {
+    PAX_NULL_CHECK(capture, 0);
+    return capture->n_calls;
+}
+
+// Get the number of buffers a capture draws to or from.
+size_t pax_capture_n_bufs(pax_capture_t const *capture) {
+    PAX_NULL_CHECK(capture, 0);
+    return capture->n_bufs;
+}
+
+// Get a buffer a capture draws to or from, in the order they were first used; `NULL` if out of range.
+// Buffers are only valid after the capture has been replayed at least once.
+pax_buf_t *pax_capture_get_buf(pax_capture_t *capture, size_t index) {
+    PAX_NULL_CHECK(capture, NULL);
+    if (index >= capture->n_bufs || !capture->bufs[index].buf) {
+        PAX_ERROR(PAX_ERR_BOUNDS, NULL);
+    }
+    return &capture->bufs[index];
+}
+
+#endif
@@ -0,0 +1,616 @@
+
+// SPDX-License-Identifier: MIT
+
+#include "pax_dlist.h"
+
+#include "pax_internal.h"
+#include "pax_renderer.h"
+
+#include <string.h>
+
+static char const *TAG = "pax-dlist";
+
+
+
+// Free the string or polygon owned by a recorded task, if any.
+static void pax_dlist_free_task(pax_task_t *task) {
+    if (task->type == PAX_TASK_TEXT && task->text.str.len > PAX_SSO_BUF_LEN) {
+        free(task->text.str.ptr);
+    } else if (task->type == PAX_TASK_POLY) {
+        // The points are stored in the same allocation, after the contour lengths.
+        free((void *)task->polyf.contour_lens);
+    }
+}
+
+// Get the total number of points of a polygon.
+static size_t pax_dlist_poly_len(pax_polyf shape) {
+    size_t n_points = 0;
+    for (size_t i = 0; i < shape.n_contours; i++) {
+        n_points += shape.contour_lens[i];
+    }
+    return n_points;
+}
+
+// Append a task to the display list of `buf`.
+// Returns false if out of memory.
+static bool pax_dlist_append(pax_buf_t *buf, pax_task_t const *task) {
+    pax_dlist_t *list = buf->dlist;
+    if (list->len >= list->cap) {
+        size_t      cap = list->cap ? list->cap * 2 : 16;
+        pax_task_t *mem = realloc(list->tasks, cap * sizeof(pax_task_t));
+        if (!mem) {
+            PAX_LOGE(TAG, "Out of memory; draw call dropped");
+            pax_set_err(PAX_ERR_NOMEM);
+            return false;
+        }
+        list->tasks = mem;
+        list->cap   = cap;
+    }
+    list->tasks[list->len]        = *task;
+    list->tasks[list->len].buffer = NULL;
+    list->len++;
+    return true;
+}
+
+
+
+// Background fill.
+static void pax_dlist_background(pax_buf_t *buf, pax_col_t color) {
+    pax_task_t task = {
+        .type  = PAX_TASK_BACKGROUND,
+        .color = color,
+    };
+    pax_dlist_append(buf, &task);
+}
+
+// Draw a solid-colored line.
+static void pax_dlist_unshaded_line(pax_buf_t *buf, pax_col_t color, pax_linef shape) {
+    pax_task_t task = {
+        .type        = PAX_TASK_LINE,
+        .color       = color,
+        .use_shader  = false,
+        .linef.shape = shape,
+    };
+    pax_dlist_append(buf, &task);
+}
+
+// Draw a solid-colored rectangle.
+static void pax_dlist_unshaded_rect(pax_buf_t *buf, pax_col_t color, pax_rectf shape) {
+    pax_task_t task = {
+        .type        = PAX_TASK_RECT,
+        .color       = color,
+        .use_shader  = false,
+        .rectf.shape = shape,
+    };
+    pax_dlist_append(buf, &task);
+}
+
+// Draw a solid-colored quad.
+static void pax_dlist_unshaded_quad(pax_buf_t *buf, pax_col_t color, pax_quadf shape) {
+    pax_task_t task = {
+        .type        = PAX_TASK_QUAD,
+        .color       = color,
+        .use_shader  = false,
+        .quadf.shape = shape,
+    };
+    pax_dlist_append(buf, &task);
+}
+
+// Draw a solid-colored triangle.
+static void pax_dlist_unshaded_tri(pax_buf_t *buf, pax_col_t color, pax_trif shape) {
+    pax_task_t task = {
+        .type       = PAX_TASK_TRI,
+        .color      = color,
+        .use_shader = false,
+        .trif.shape = shape,
+    };
+    pax_dlist_append(buf, &task);
+}
+
+// Draw a solid-colored quad with anti-aliased edges.
+static void pax_dlist_unshaded_quad_aa(pax_buf_t *buf, pax_col_t color, pax_quadf shape) {
+    pax_task_t task = {
+        .type        = PAX_TASK_QUAD,
+        .color       = color,
+        .use_shader  = false,
+        .antialias   = true,
+        .quadf.shape = shape,
+    };
+    pax_dlist_append(buf, &task);
+}
+
+// Draw a solid-colored triangle with anti-aliased edges.
+static void pax_dlist_unshaded_tri_aa(pax_buf_t *buf, pax_col_t color, pax_trif shape) {
+    pax_task_t task = {
+        .type       = PAX_TASK_TRI,
+        .color      = color,
+        .use_shader = false,
+        .antialias  = true,
+        .trif.shape = shape,
+    };
+    pax_dlist_append(buf, &task);
+}
+
+// Draw a solid-colored polygon.
+static void pax_dlist_unshaded_poly(pax_buf_t *buf, pax_col_t color, pax_polyf shape) {
+    size_t  n_points = pax_dlist_poly_len(shape);
+    size_t *mem      = malloc(shape.n_contours * sizeof(size_t) + n_points * sizeof(pax_vec2f));
+    if (!mem) {
+        PAX_LOGE(TAG, "Out of memory; draw call dropped");
+        pax_set_err(PAX_ERR_NOMEM);
+        return;
+    }
+    memcpy(mem, shape.contour_lens, shape.n_contours * sizeof(size_t));
+    memcpy(mem + shape.n_contours, shape.points, n_points * sizeof(pax_vec2f));
+    shape.contour_lens = mem;
+    shape.points       = (pax_vec2f const *)(mem + shape.n_contours);
+
+    pax_task_t task = {
+        .type  = PAX_TASK_POLY,
+        .color = color,
+        .polyf = shape,
+    };
+    if (!pax_dlist_append(buf, &task)) {
+        pax_dlist_free_task(&task);
+    }
+}
+
+// Draw a solid-colored ellipse or elliptic ring.
+static void pax_dlist_unshaded_ellipse(pax_buf_t *buf, pax_col_t color, pax_ellipsef shape) {
+    pax_task_t task = {
+        .type     = PAX_TASK_ELLIPSE,
+        .color    = color,
+        .ellipsef = shape,
+    };
+    pax_dlist_append(buf, &task);
+}
+
+// Draw a solid-colored rectangle with rounded corners.
+static void pax_dlist_unshaded_round_rect(pax_buf_t *buf, pax_col_t color, pax_round_rectf shape) {
+    pax_task_t task = {
+        .type        = PAX_TASK_ROUND_RECT,
+        .color       = color,
+        .round_rectf = shape,
+    };
+    pax_dlist_append(buf, &task);
+}
+
+// Draw a solid-colored rectangle with rounded corners and anti-aliased edges.
+static void pax_dlist_unshaded_round_rect_aa(pax_buf_t *buf, pax_col_t color, pax_round_rectf shape) {
+    pax_task_t task = {
+        .type        = PAX_TASK_ROUND_RECT,
+        .color       = color,
+        .antialias   = true,
+        .round_rectf = shape,
+    };
+    pax_dlist_append(buf, &task);
+}
+
+
+// Draw a line with a shader.
+static void
+    pax_dlist_shaded_line(pax_buf_t *buf, pax_col_t color, pax_linef shape, pax_shader_t const *shader, pax_linef uv) {
+    pax_task_t task = {
+        .type        = PAX_TASK_LINE,
+        .color       = color,
+        .shader      = *shader,
+        .use_shader  = true,
+        .linef.shape = shape,
+        .linef.uvs   = uv,
+    };
+    pax_dlist_append(buf, &task);
+}
+
+// Draw a rectangle with a shader.
+static void
+    pax_dlist_shaded_rect(pax_buf_t *buf, pax_col_t color, pax_rectf shape, pax_shader_t const *shader, pax_quadf uv) {
+    pax_task_t task = {
+        .type        = PAX_TASK_RECT,
+        .color       = color,
+        .shader      = *shader,
+        .use_shader  = true,
+        .rectf.shape = shape,
+        .rectf.uvs   = uv,
+    };
+    pax_dlist_append(buf, &task);
+}
+
+// Draw a quad with a shader.
+static void
+    pax_dlist_shaded_quad(pax_buf_t *buf, pax_col_t color, pax_quadf shape, pax_shader_t const *shader, pax_quadf uv) {
+    pax_task_t task = {
+        .type        = PAX_TASK_QUAD,
+        .color       = color,
+        .shader      = *shader,
+        .use_shader  = true,
+        .quadf.shape = shape,
+        .quadf.uvs   = uv,
+    };
+    pax_dlist_append(buf, &task);
+}
+
+// Draw a triangle with a shader.
+static void
+    pax_dlist_shaded_tri(pax_buf_t *buf, pax_col_t color, pax_trif shape, pax_shader_t const *shader, pax_trif uv) {
+    pax_task_t task = {
+        .type       = PAX_TASK_TRI,
+        .color      = color,
+        .shader     = *shader,
+        .use_shader = true,
+        .trif.shape = shape,
+        .trif.uvs   = uv,
+    };
+    pax_dlist_append(buf, &task);
+}
+
+
+// Draw an axis-aligned image with fractional scaling.
+static void pax_dlist_scaled_image(
+    pax_buf_t *base, pax_buf_t const *top, pax_recti base_pos, pax_orientation_t top_orientation, bool assume_opaque
+) {
+    pax_task_t task = {
+        .type         = PAX_TASK_SCALED_IMAGE,
+        .scaled_image = {
+            .top             = top,
+            .base_pos        = base_pos,
+            .top_orientation = top_orientation,
+            .assume_opaque   = assume_opaque,
+        },
+    };
+    pax_dlist_append(base, &task);
+}
+
+// Draw a sprite; like a blit, but use color blending if applicable.
+static void pax_dlist_sprite(
+    pax_buf_t *base, pax_buf_t const *top, pax_recti base_pos, pax_orientation_t top_orientation, pax_vec2i top_pos
+) {
+    pax_task_t task = {
+        .type = PAX_TASK_SPRITE,
+        .blit = {
+            .top             = top,
+            .top_orientation = top_orientation,
+            .top_pos         = top_pos,
+            .base_pos        = base_pos,
+        },
+    };
+    pax_dlist_append(base, &task);
+}
+
+// Perform a buffer copying operation with a PAX buffer.
+static void pax_dlist_blit(
+    pax_buf_t *base, pax_buf_t const *top, pax_recti base_pos, pax_orientation_t top_orientation, pax_vec2i top_pos
+) {
+    pax_task_t task = {
+        .type = PAX_TASK_BLIT,
+        .blit = {
+            .top             = top,
+            .top_orientation = top_orientation,
+            .top_pos         = top_pos,
+            .base_pos        = base_pos,
+        },
+    };
+    pax_dlist_append(base, &task);
+}
+
+// Perform a buffer copying operation with an unmanaged user buffer.
+static void pax_dlist_blit_raw(
+    pax_buf_t        *base,
+    void const       *top,
+    pax_vec2i         top_dims,
+    pax_recti         base_pos,
+    pax_orientation_t top_orientation,
+    pax_vec2i         top_pos
+) {
+    pax_task_t task = {
+        .type = PAX_TASK_BLIT_RAW,
+        .blit = {
+            .top             = top,
+            .top_dims        = top_dims,
+            .top_orientation = top_orientation,
+            .top_pos         = top_pos,
+            .base_pos        = base_pos,
+        },
+    };
+    pax_dlist_append(base, &task);
+}
+
+// Blit one or more characters of text in the bitmapped format.
+static void pax_dlist_blit_char(pax_buf_t *buf, pax_col_t color, pax_vec2i pos, int scale, pax_text_rsdata_t rsdata) {
+    pax_task_t task = {
+        .type      = PAX_TASK_BLIT_CHAR,
+        .color     = color,
+        .blit_char = {
+            .rsdata = rsdata,
+            .pos    = pos,
+            .scale  = scale,
+        },
+    };
+    pax_dlist_append(buf, &task);
+}
+
+// Draw a string of text in the bitmapped format.
+static void pax_dlist_text(
+    pax_buf_t        *buf,
+    matrix_2d_t       matrix,
+    pax_col_t         color,
+    pax_font_t const *font,
+    float             font_size,
+    pax_vec2f         pos,
+    char const       *text,
+    size_t            text_len,
+    pax_align_t       halign,
+    pax_align_t       valign,
+    ptrdiff_t         cursorpos
+) {
+    pax_task_str_t str;
+    str.len = text_len;
+    if (text_len <= PAX_SSO_BUF_LEN) {
+        memcpy(str.sso, text, text_len);
+    } else {
+        str.ptr = malloc(sizeof(pax_rcstr_t) + text_len);
+        if (!str.ptr) {
+            PAX_LOGE(TAG, "Out of memory; draw call dropped");
+            pax_set_err(PAX_ERR_NOMEM);
+            return;
+        }
+        memcpy(str.ptr->data, text, text_len);
+    }
+    pax_task_t task = {
+        .type           = PAX_TASK_TEXT,
+        .color          = color,
+        .text_matrix    = matrix,
+        .text.font      = font,
+        .text.font_size = font_size,
+        .text.pos       = pos,
+        .text.halign    = halign,
+        .text.valign    = valign,
+        .text.cursorpos = cursorpos,
+        .text.str       = str,
+    };
+    if (!pax_dlist_append(buf, &task)) {
+        pax_dlist_free_task(&task);
+    }
+}
+
+// Render functions that record into `buf->dlist`.
+pax_render_funcs_t const pax_render_funcs_dlist = {
+    .background             = pax_dlist_background,
+    .unshaded_line          = pax_dlist_unshaded_line,
+    .unshaded_rect          = pax_dlist_unshaded_rect,
+    .unshaded_quad          = pax_dlist_unshaded_quad,
+    .unshaded_tri           = pax_dlist_unshaded_tri,
+    .unshaded_quad_aa       = pax_dlist_unshaded_quad_aa,
+    .unshaded_tri_aa        = pax_dlist_unshaded_tri_aa,
+    .unshaded_poly          = pax_dlist_unshaded_poly,
+    .unshaded_ellipse       = pax_dlist_unshaded_ellipse,
+    .unshaded_round_rect    = pax_dlist_unshaded_round_rect,
+    .unshaded_round_rect_aa = pax_dlist_unshaded_round_rect_aa,
+    .shaded_line            = pax_dlist_shaded_line,
+    .shaded_rect            = pax_dlist_shaded_rect,
+    .shaded_quad            = pax_dlist_shaded_quad,
+    .shaded_tri             = pax_dlist_shaded_tri,
+    .scaled_image           = pax_dlist_scaled_image,
+    .sprite                 = pax_dlist_sprite,
+    .blit                   = pax_dlist_blit,
+    .blit_raw               = pax_dlist_blit_raw,
+    .blit_char              = pax_dlist_blit_char,
+    .join                   = NULL,
+    .text                   = pax_dlist_text,
+};
+
+
+
+// Initialize an empty display list where the `pax_dlist_t` struct is user-managed.
+void pax_dlist_init(pax_dlist_t *list) {
+    PAX_NULL_CHECK(list);
+    *list = (pax_dlist_t){
+        .tasks = NULL,
+        .len   = 0,
+        .cap   = 0,
+    };
+}
+
+// De-initialize a display list initialized by `pax_dlist_init`.
+void pax_dlist_destroy(pax_dlist_t *list) {
+    PAX_NULL_CHECK(list);
+    pax_dlist_clear(list);
+    free(list->tasks);
+    list->tasks = NULL;
+    list->cap   = 0;
+}
+
+// Remove all recorded draw calls from a display list.
+void pax_dlist_clear(pax_dlist_t *list) {
+    PAX_NULL_CHECK(list);
+    for (size_t i = 0; i < list->len; i++) {
+        pax_dlist_free_task(&list->tasks[i]);
+    }
+    list->len = 0;
+}
+
+// Start recording draw calls made to `buf` into `list` instead of drawing them.
+void pax_dlist_begin(pax_dlist_t *list, pax_buf_t *buf) {
+    PAX_BUF_CHECK(buf);
+    PAX_NULL_CHECK(list);
+    buf->dlist = list;
+}
+
+// Stop recording draw calls made to `buf`.
+void pax_dlist_end(pax_buf_t *buf) {
+    PAX_BUF_CHECK(buf);
+    buf->dlist = NULL;
+}
+
+// Draw everything recorded in `list` to `buf`, offset by `x` and `y`.
+void pax_dlist_replay(pax_dlist_t const *list, pax_buf_t *buf, int x, int y) {
+    PAX_BUF_CHECK(buf);
+    PAX_NULL_CHECK(list);
+    if (buf->dlist == list) {
+        PAX_LOGE(TAG, "Cannot replay a display list into the buffer that is recording it");
+        PAX_ERROR(PAX_ERR_PARAM);
+    }
+
+    // Recorded shapes are in raw buffer co-ordinates, text and characters are not.
+#if CONFIG_PAX_COMPILE_ORIENTATION
+    pax_vec2f origin = pax_orient_det_vec2f(buf, (pax_vec2f){0, 0});
+    pax_vec2f offset = pax_orient_det_vec2f(buf, (pax_vec2f){x, y});
+    float     dx     = offset.x - origin.x;
+    float     dy     = offset.y - origin.y;
+#else
+    float dx = x;
+    float dy = y;
+#endif
+
+    for (size_t i = 0; i < list->len; i++) {
+        pax_task_t const *task = &list->tasks[i];
+        switch (task->type) {
+            default: break;
+            case PAX_TASK_BACKGROUND: pax_dispatch_background(buf, task->color); break;
+            case PAX_TASK_LINE: {
+                pax_linef shape  = task->linef.shape;
+                shape.x0        += dx;
+                shape.y0        += dy;
+                shape.x1        += dx;
+                shape.y1        += dy;
+                if (task->use_shader) {
+                    pax_dispatch_shaded_line(buf, task->color, shape, &task->shader, task->linef.uvs);
+                } else {
+                    pax_dispatch_unshaded_line(buf, task->color, shape);
+                }
+            } break;
+            case PAX_TASK_RECT: {
+                pax_rectf shape  = task->rectf.shape;
+                shape.x         += dx;
+                shape.y         += dy;
+                if (task->use_shader) {
+                    pax_dispatch_shaded_rect(buf, task->color, shape, &task->shader, task->rectf.uvs);
+                } else {
+                    pax_dispatch_unshaded_rect(buf, task->color, shape);
+                }
+            } break;
+            case PAX_TASK_QUAD: {
+                pax_quadf shape  = task->quadf.shape;
+                shape.x0        += dx;
+                shape.y0        += dy;
+                shape.x1        += dx;
+                shape.y1        += dy;
+                shape.x2        += dx;
+                shape.y2        += dy;
+                shape.x3        += dx;
+                shape.y3        += dy;
+                if (task->use_shader) {
+                    pax_dispatch_shaded_quad(buf, task->color, shape, &task->shader, task->quadf.uvs);
+                } else if (task->antialias) {
+                    pax_dispatch_unshaded_quad_aa(buf, task->color, shape);
+                } else {
+                    pax_dispatch_unshaded_quad(buf, task->color, shape);
+                }
+            } break;
+            case PAX_TASK_TRI: {
+                pax_trif shape  = task->trif.shape;
+                shape.x0       += dx;
+                shape.y0       += dy;
+                shape.x1       += dx;
+                shape.y1       += dy;
+                shape.x2       += dx;
+                shape.y2       += dy;
+                if (task->use_shader) {
+                    pax_dispatch_shaded_tri(buf, task->color, shape, &task->shader, task->trif.uvs);
+                } else if (task->antialias) {
+                    pax_dispatch_unshaded_tri_aa(buf, task->color, shape);
+                } else {
+                    pax_dispatch_unshaded_tri(buf, task->color, shape);
+                }
+            } break;
+            case PAX_TASK_POLY: {
+                if (dx == 0 && dy == 0) {
+                    pax_dispatch_unshaded_poly(buf, task->color, task->polyf);
+                    break;
+                }
+                // The recorded points can't be moved in place, because the display list may be replayed again.
+                size_t     n_points = pax_dlist_poly_len(task->polyf);
+                pax_vec2f *points   = malloc(n_points * sizeof(pax_vec2f));
+                if (!points) {
+                    PAX_LOGE(TAG, "Out of memory; draw call dropped");
+                    pax_set_err(PAX_ERR_NOMEM);
+                    break;
+                }
+                for (size_t j = 0; j < n_points; j++) {
+                    points[j] = (pax_vec2f){task->polyf.points[j].x + dx, task->polyf.points[j].y + dy};
+                }
+                pax_polyf shape = task->polyf;
+                shape.points    = points;
+                pax_dispatch_unshaded_poly(buf, task->color, shape);
+                free(points);
+            } break;
+            case PAX_TASK_ELLIPSE: {
+                pax_ellipsef shape  = task->ellipsef;
+                shape.x            += dx;
+                shape.y            += dy;
+                pax_dispatch_unshaded_ellipse(buf, task->color, shape);
+            } break;
+            case PAX_TASK_ROUND_RECT: {
+                pax_round_rectf shape  = task->round_rectf;
+                shape.x               += dx;
+                shape.y               += dy;
+                if (task->antialias) {
+                    pax_dispatch_unshaded_round_rect_aa(buf, task->color, shape);
+                } else {
+                    pax_dispatch_unshaded_round_rect(buf, task->color, shape);
+                }
+            } break;
+            case PAX_TASK_SCALED_IMAGE: {
+                pax_recti pos  = task->scaled_image.base_pos;
+                pos.x         += dx;
+                pos.y         += dy;
+                pax_dispatch_scaled_image(
+                    buf,
+                    task->scaled_image.top,
+                    pos,
+                    task->scaled_image.top_orientation,
+                    task->scaled_image.assume_opaque
+                );
+            } break;
+            case PAX_TASK_SPRITE:
+            case PAX_TASK_BLIT:
+            case PAX_TASK_BLIT_RAW: {
+                pax_recti pos  = task->blit.base_pos;
+                pos.x         += dx;
+                pos.y         += dy;
+                if (task->type == PAX_TASK_SPRITE) {
+                    pax_dispatch_sprite(buf, task->blit.top, pos, task->blit.top_orientation, task->blit.top_pos);
+                } else if (task->type == PAX_TASK_BLIT) {
+                    pax_dispatch_blit(buf, task->blit.top, pos, task->blit.top_orientation, task->blit.top_pos);
+                } else {
+                    pax_dispatch_blit_raw(
+                        buf,
+                        task->blit.top,
+                        task->blit.top_dims,
+                        pos,
+                        task->blit.top_orientation,
+                        task->blit.top_pos
+                    );
+                }
+            } break;
+            case PAX_TASK_BLIT_CHAR: {
+                pax_vec2i pos = {task->blit_char.pos.x + x, task->blit_char.pos.y + y};
+                pax_dispatch_blit_char(buf, task->color, pos, task->blit_char.scale, task->blit_char.rsdata);
+            } break;
+            case PAX_TASK_TEXT: {
+                pax_dispatch_text(
+                    buf,
+                    matrix_2d_multiply(matrix_2d_translate(x, y), task->text_matrix),
+                    task->color,
+                    task->text.font,
+                    task->text.font_size,
+                    task->text.pos,
+                    task->text.str.len > PAX_SSO_BUF_LEN ? task->text.str.ptr->data : task->text.str.sso,
+                    task->text.str.len,
+                    task->text.halign,
+                    task->text.valign,
+                    task->text.cursorpos
+                );
+            } break;
+        }
+    }
+}
@@ -59,6 +59,16 @@ static pax_col_t
     return pax_col_merge(existing, v0(tint, x, y, u, v, args->callback_args));
 }
 
+// A wrapper callback to use V2 shader callbacks for single pixels.
+static pax_col_t
+    pax_shader_wrapper_for_v2(pax_col_t tint, pax_col_t existing, int x, int y, float u, float v, void *args0) {
+    pax_shader_t        *args = args0;
+    pax_shader_func_v2_t v2   = args->callback;
+    pax_col_t            out;
+    v2(tint, &existing, &out, x, y, 1, u, v, 0, 0, args->callback_args);
+    return out;
+}
+
 // Gets the correct callback function for the shader.
 pax_shader_ctx_t pax_get_shader_ctx(pax_buf_t *buf, pax_col_t color, pax_shader_t const *shader) {
     (void)buf;
@@ -74,7 +84,19 @@ pax_shader_ctx_t pax_get_shader_ctx(pax_buf_t *buf, pax_col_t color, pax_shader_
         };
     }
 
-    // Use the new version.
+    if (shader->schema_version == 2) {
+        // Shade spans at once where possible, and single pixels for the shapes that don't have spans.
+        return (pax_shader_ctx_t){
+            .callback      = pax_shader_wrapper_for_v2,
+            .callback_args = (void *)shader,
+            .span_callback = shader->callback,
+            .span_args     = shader->callback_args,
+            .do_getter     = true,
+            .skip          = false,
+        };
+    }
+
+    // Use the per-pixel version.
     return (pax_shader_ctx_t){
         .callback      = shader->callback,
         .callback_args = shader->callback_args,
@@ -187,6 +209,7 @@ void pax_buf_set_palette(pax_buf_t *buf, pax_col_t const *palette, size_t palett
     }
     buf->palette      = mem;
     buf->palette_size = palette_len;
+    buf->do_free_pal  = true;
     memcpy(mem, palette, sizeof(pax_col_t) * palette_len);
 }
 
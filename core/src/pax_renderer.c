@@ -3,9 +3,13 @@
 
 #include "pax_renderer.h"
 
+#include "helpers/pax_drawing_helpers.h"
 #include "pax_gfx.h"
+#include "pax_internal.h"
 #include "renderer/pax_renderer_soft.h"
 
+#include <math.h>
+
 #define DEFAULT_RENDERER_ONLY !CONFIG_PAX_COMPILE_ASYNC_RENDERER && !CONFIG_PAX_COMPILE_ESP32P4_PPA_RENDERER
 
 
@@ -40,62 +44,318 @@ static inline void clipped_mark_dirty2(pax_buf_t *buf, int x, int y, int w, int
     }
 }
 
+// Whether the bounding box from (x0, y0) to (x1, y1) lies entirely outside `clip`.
+// Allows a pixel of slack for rounding and antialiasing, so that anything that might touch `clip` is kept.
+static inline bool outside_clip(pax_recti clip, float x0, float y0, float x1, float y1) {
+    return clip.w <= 0 || clip.h <= 0 || x1 < clip.x - 1 || y1 < clip.y - 1 || x0 > clip.x + clip.w
+           || y0 > clip.y + clip.h;
+}
+
+// Whether a draw call to `buf` with the bounding box from (x0, y0) to (x1, y1) in buffer coordinates draws nothing.
+// Draw calls recorded into a display list are kept, because they are clipped when the display list is replayed.
+#define CULLED(buf, x0, y0, x1, y1) (!(buf)->dlist && outside_clip((buf)->clip, (x0), (y0), (x1), (y1)))
+
+// Drop a draw call that draws nothing before it is marked dirty or queued.
+#define CULL(culled)                                                                                                   \
+    do {                                                                                                               \
+        if (culled) {                                                                                                  \
+            PAX_STATS_CULL();                                                                                          \
+            return;                                                                                                    \
+        }                                                                                                              \
+    } while (0)
+
+// Whether a line is entirely outside the clip rectangle.
+static inline bool culled_line(pax_buf_t const *buf, pax_linef shape) {
+    return CULLED(
+        buf,
+        fminf(shape.x0, shape.x1),
+        fminf(shape.y0, shape.y1),
+        fmaxf(shape.x0, shape.x1),
+        fmaxf(shape.y0, shape.y1)
+    );
+}
+
+// Whether a rectangle is entirely outside the clip rectangle.
+static inline bool culled_rect(pax_buf_t const *buf, float x, float y, float w, float h) {
+    return CULLED(buf, fminf(x, x + w), fminf(y, y + h), fmaxf(x, x + w), fmaxf(y, y + h));
+}
+
+// Whether a quad is entirely outside the clip rectangle.
+static inline bool culled_quad(pax_buf_t const *buf, pax_quadf shape) {
+    return CULLED(
+        buf,
+        fminf(fminf(shape.x0, shape.x1), fminf(shape.x2, shape.x3)),
+        fminf(fminf(shape.y0, shape.y1), fminf(shape.y2, shape.y3)),
+        fmaxf(fmaxf(shape.x0, shape.x1), fmaxf(shape.x2, shape.x3)),
+        fmaxf(fmaxf(shape.y0, shape.y1), fmaxf(shape.y2, shape.y3))
+    );
+}
+
+// Whether a triangle is entirely outside the clip rectangle.
+static inline bool culled_tri(pax_buf_t const *buf, pax_trif shape) {
+    return CULLED(
+        buf,
+        fminf(fminf(shape.x0, shape.x1), shape.x2),
+        fminf(fminf(shape.y0, shape.y1), shape.y2),
+        fmaxf(fmaxf(shape.x0, shape.x1), shape.x2),
+        fmaxf(fmaxf(shape.y0, shape.y1), shape.y2)
+    );
+}
+
+// Get the bounding box of the points of a polygon.
+static inline void poly_bounds(pax_polyf shape, float *x0, float *y0, float *x1, float *y1) {
+    size_t n_points = 0;
+    for (size_t i = 0; i < shape.n_contours; i++) {
+        n_points += shape.contour_lens[i];
+    }
+    *x0 = *y0 = INFINITY;
+    *x1 = *y1 = -INFINITY;
+    for (size_t i = 0; i < n_points; i++) {
+        *x0 = fminf(*x0, shape.points[i].x);
+        *y0 = fminf(*y0, shape.points[i].y);
+        *x1 = fmaxf(*x1, shape.points[i].x);
+        *y1 = fmaxf(*y1, shape.points[i].y);
+    }
+}
+
+// Whether a character is entirely outside the clip rectangle.
+// Characters are drawn before the orientation is applied, so they are clipped in the same coordinates.
+static inline bool culled_char(pax_buf_t const *buf, pax_vec2i pos, int scale, pax_text_rsdata_t rsdata) {
+    if (buf->dlist) {
+        return false;
+    }
+    return outside_clip(pax_get_clip(buf), pos.x, pos.y, pos.x + rsdata.w * scale, pos.y + rsdata.h * scale);
+}
+
+// Whether text is entirely above or below the clip rectangle.
+// Only the height of text is known before it is laid out, so text that is rotated or sheared is never culled.
+static inline bool culled_text(
+    pax_buf_t const *buf, matrix_2d_t matrix, float font_size, pax_vec2f pos, char const *text, size_t text_len
+) {
+    if (buf->dlist || matrix.b0 != 0) {
+        return false;
+    }
+    size_t lines = 1;
+    for (size_t i = 0; i < text_len; i++) {
+        lines += text[i] == '\n' || text[i] == '\r';
+    }
+    // Text is within its height of `pos` for any alignment; one more line of slack covers glyphs that stick out.
+    float height = fabsf(font_size) * (lines + 1);
+    float y0     = matrix.b1 * (pos.y - height) + matrix.b2;
+    float y1     = matrix.b1 * (pos.y + height) + matrix.b2;
+    // Text is drawn before the orientation is applied, so it is clipped in the same coordinates.
+    return outside_clip(pax_get_clip(buf), -INFINITY, fminf(y0, y1), INFINITY, fmaxf(y0, y1));
+}
+
 
 
+// Render context used by buffers that don't have one of their own.
+static pax_render_ctx_t default_ctx = {
+    .engine = &pax_render_engine_soft,
+    .funcs  = &pax_render_funcs_soft,
+    .state  = NULL,
+};
+
+// Get the render context `buf` draws through.
+#define RENDER_CTX(buf) ((buf)->render_ctx ? (buf)->render_ctx : &default_ctx)
+
 #if DEFAULT_RENDERER_ONLY
-    #define implicit_dirty       true
-    #define RENDERFUNC(function) pax_swr_##function
+    #define IMPLICIT_DIRTY(buf)       true
+    #define RENDERFUNC(buf, function) pax_swr_##function
+#else
+    #define IMPLICIT_DIRTY(buf)       RENDER_CTX(buf)->engine->implicit_dirty
+    #define RENDERFUNC(buf, function) RENDER_CTX(buf)->funcs->function
+#endif
+
+#if CONFIG_PAX_COMPILE_CAPTURE
+    // Draw calls to a buffer that is recording a display list are recorded instead of drawn.
+    // Draw calls made while capturing are written to the capture and then drawn.
+    #define DISPATCH(buf, function)                                                                                    \
+        ((buf)->dlist                                        ? pax_render_funcs_dlist.function                         \
+         : __atomic_load_n(&pax_capturing, __ATOMIC_RELAXED) ? pax_render_funcs_capture.function                       \
+                                                             : RENDERFUNC(buf, function))
 #else
-static bool                       implicit_dirty = true;
-static pax_render_engine_t const *renderer       = &pax_render_engine_soft;
-static pax_render_funcs_t const  *renderfunc     = &pax_render_funcs_soft;
-    #define RENDERFUNC(function) renderfunc->function
+    // Draw calls to a buffer that is recording a display list are recorded instead of drawn.
+    #define DISPATCH(buf, function) ((buf)->dlist ? pax_render_funcs_dlist.function : RENDERFUNC(buf, function))
+#endif
+
+#if CONFIG_PAX_STATS
+    // Count and time a draw call; draw calls recorded into a display list are counted when it is replayed.
+    #define COUNTED(buf, type, call)                                                                                   \
+        do {                                                                                                           \
+            PAX_STATS_START(start);                                                                                    \
+            call;                                                                                                      \
+            if (!(buf)->dlist) {                                                                                       \
+                PAX_STATS_TASK(type, start);                                                                           \
+            }                                                                                                          \
+        } while (0)
+#else
+    #define COUNTED(buf, type, call) call
 #endif
 
 // Background fill.
 void pax_dispatch_background(pax_buf_t *buf, pax_col_t color) {
-    if (implicit_dirty) {
+    if (IMPLICIT_DIRTY(buf) && !buf->dlist) {
         pax_mark_dirty0(buf);
     }
-    RENDERFUNC(background)(buf, color);
+    COUNTED(buf, PAX_TASK_BACKGROUND, DISPATCH(buf, background)(buf, color));
 }
 
 // Draw a solid-colored line.
 void pax_dispatch_unshaded_line(pax_buf_t *buf, pax_col_t color, pax_linef shape) {
-    if (implicit_dirty) {
+    CULL(culled_line(buf, shape));
+    if (IMPLICIT_DIRTY(buf) && !buf->dlist) {
         clipped_mark_dirty1(buf, shape.x0, shape.y0);
         clipped_mark_dirty1(buf, shape.x1, shape.y1);
     }
-    RENDERFUNC(unshaded_line)(buf, color, shape);
+    COUNTED(buf, PAX_TASK_LINE, DISPATCH(buf, unshaded_line)(buf, color, shape));
 }
 
 // Draw a solid-colored rectangle.
 void pax_dispatch_unshaded_rect(pax_buf_t *buf, pax_col_t color, pax_rectf shape) {
-    if (implicit_dirty) {
+    CULL(culled_rect(buf, shape.x, shape.y, shape.w, shape.h));
+    if (IMPLICIT_DIRTY(buf) && !buf->dlist) {
         clipped_mark_dirty2(buf, shape.x, shape.y, shape.w, shape.h);
     }
-    RENDERFUNC(unshaded_rect)(buf, color, shape);
+    COUNTED(buf, PAX_TASK_RECT, DISPATCH(buf, unshaded_rect)(buf, color, shape));
 }
 
 // Draw a solid-colored quad.
 void pax_dispatch_unshaded_quad(pax_buf_t *buf, pax_col_t color, pax_quadf shape) {
-    if (implicit_dirty) {
+    CULL(culled_quad(buf, shape));
+    if (IMPLICIT_DIRTY(buf) && !buf->dlist) {
         clipped_mark_dirty1(buf, shape.x0, shape.y0);
         clipped_mark_dirty1(buf, shape.x1, shape.y1);
         clipped_mark_dirty1(buf, shape.x2, shape.y2);
         clipped_mark_dirty1(buf, shape.x3, shape.y3);
     }
-    RENDERFUNC(unshaded_quad)(buf, color, shape);
+    COUNTED(buf, PAX_TASK_QUAD, DISPATCH(buf, unshaded_quad)(buf, color, shape));
 }
 
 // Draw a solid-colored triangle.
 void pax_dispatch_unshaded_tri(pax_buf_t *buf, pax_col_t color, pax_trif shape) {
-    if (implicit_dirty) {
+    CULL(culled_tri(buf, shape));
+    if (IMPLICIT_DIRTY(buf) && !buf->dlist) {
+        clipped_mark_dirty1(buf, shape.x0, shape.y0);
+        clipped_mark_dirty1(buf, shape.x1, shape.y1);
+        clipped_mark_dirty1(buf, shape.x2, shape.y2);
+    }
+    COUNTED(buf, PAX_TASK_TRI, DISPATCH(buf, unshaded_tri)(buf, color, shape));
+}
+
+// Draw a solid-colored quad with anti-aliased edges.
+void pax_dispatch_unshaded_quad_aa(pax_buf_t *buf, pax_col_t color, pax_quadf shape) {
+    CULL(culled_quad(buf, shape));
+    if (IMPLICIT_DIRTY(buf) && !buf->dlist) {
+        clipped_mark_dirty1(buf, shape.x0, shape.y0);
+        clipped_mark_dirty1(buf, shape.x1, shape.y1);
+        clipped_mark_dirty1(buf, shape.x2, shape.y2);
+        clipped_mark_dirty1(buf, shape.x3, shape.y3);
+    }
+    // Render engines that can't anti-alias draw the quad aliased instead.
+    void (*func)(pax_buf_t *, pax_col_t, pax_quadf) = DISPATCH(buf, unshaded_quad_aa);
+    if (!func) {
+        func = DISPATCH(buf, unshaded_quad);
+    }
+    COUNTED(buf, PAX_TASK_QUAD, func(buf, color, shape));
+}
+
+// Draw a solid-colored triangle with anti-aliased edges.
+void pax_dispatch_unshaded_tri_aa(pax_buf_t *buf, pax_col_t color, pax_trif shape) {
+    CULL(culled_tri(buf, shape));
+    if (IMPLICIT_DIRTY(buf) && !buf->dlist) {
         clipped_mark_dirty1(buf, shape.x0, shape.y0);
         clipped_mark_dirty1(buf, shape.x1, shape.y1);
         clipped_mark_dirty1(buf, shape.x2, shape.y2);
     }
-    RENDERFUNC(unshaded_tri)(buf, color, shape);
+    // Render engines that can't anti-alias draw the triangle aliased instead.
+    void (*func)(pax_buf_t *, pax_col_t, pax_trif) = DISPATCH(buf, unshaded_tri_aa);
+    if (!func) {
+        func = DISPATCH(buf, unshaded_tri);
+    }
+    COUNTED(buf, PAX_TASK_TRI, func(buf, color, shape));
+}
+
+// Target of `unshaded_span_rect`.
+typedef struct {
+    pax_buf_t *buf;
+    pax_col_t  color;
+    void (*unshaded_rect)(pax_buf_t *buf, pax_col_t color, pax_rectf shape);
+} unshaded_span_t;
+
+// Draw one span of a polygon or ellipse as a rectangle, for render engines that can't draw those.
+static void unshaded_span_rect(void *args, int x, int y, int len) {
+    unshaded_span_t *ctx = args;
+    ctx->unshaded_rect(ctx->buf, ctx->color, (pax_rectf){x, y, len, 1});
+}
+
+// Draw a solid-colored polygon.
+void pax_dispatch_unshaded_poly(pax_buf_t *buf, pax_col_t color, pax_polyf shape) {
+    float x0, y0, x1, y1;
+    poly_bounds(shape, &x0, &y0, &x1, &y1);
+    CULL(x0 > x1 || CULLED(buf, x0, y0, x1, y1));
+    if (IMPLICIT_DIRTY(buf) && !buf->dlist) {
+        clipped_mark_dirty2(buf, floorf(x0), floorf(y0), ceilf(x1) - floorf(x0), ceilf(y1) - floorf(y0));
+    }
+    void (*func)(pax_buf_t *, pax_col_t, pax_polyf) = DISPATCH(buf, unshaded_poly);
+    if (func) {
+        COUNTED(buf, PAX_TASK_POLY, func(buf, color, shape));
+    } else {
+        // Render engines that can't draw polygons draw the spans of pixels inside it instead.
+        unshaded_span_t ctx = {buf, color, DISPATCH(buf, unshaded_rect)};
+        COUNTED(buf, PAX_TASK_POLY, pax_poly_spans(buf, shape, unshaded_span_rect, &ctx));
+    }
+}
+
+// Draw a solid-colored ellipse or elliptic ring.
+void pax_dispatch_unshaded_ellipse(pax_buf_t *buf, pax_col_t color, pax_ellipsef shape) {
+    pax_rectf bounds = pax_ellipse_bounds(shape);
+    CULL(CULLED(buf, bounds.x, bounds.y, bounds.x + bounds.w, bounds.y + bounds.h));
+    if (IMPLICIT_DIRTY(buf) && !buf->dlist) {
+        float x0 = floorf(bounds.x), y0 = floorf(bounds.y);
+        clipped_mark_dirty2(buf, x0, y0, ceilf(bounds.x + bounds.w) - x0, ceilf(bounds.y + bounds.h) - y0);
+    }
+    void (*func)(pax_buf_t *, pax_col_t, pax_ellipsef) = DISPATCH(buf, unshaded_ellipse);
+    if (func) {
+        COUNTED(buf, PAX_TASK_ELLIPSE, func(buf, color, shape));
+    } else {
+        // Render engines that can't draw ellipses draw the spans of pixels inside it instead.
+        unshaded_span_t ctx = {buf, color, DISPATCH(buf, unshaded_rect)};
+        COUNTED(buf, PAX_TASK_ELLIPSE, pax_ellipse_spans(buf, shape, unshaded_span_rect, &ctx));
+    }
+}
+
+// Cull, mark dirty and draw a rounded rectangle with `func`, or as spans if NULL.
+static void unshaded_round_rect(
+    pax_buf_t *buf, pax_col_t color, pax_round_rectf shape, void (*func)(pax_buf_t *, pax_col_t, pax_round_rectf)
+) {
+    CULL(culled_rect(buf, shape.x, shape.y, shape.w, shape.h));
+    if (IMPLICIT_DIRTY(buf) && !buf->dlist) {
+        float x0 = floorf(shape.x), y0 = floorf(shape.y);
+        clipped_mark_dirty2(buf, x0, y0, ceilf(shape.x + shape.w) - x0, ceilf(shape.y + shape.h) - y0);
+    }
+    if (func) {
+        COUNTED(buf, PAX_TASK_ROUND_RECT, func(buf, color, shape));
+    } else {
+        // Render engines that can't draw rounded rectangles draw the spans of pixels inside it instead.
+        unshaded_span_t ctx = {buf, color, DISPATCH(buf, unshaded_rect)};
+        COUNTED(buf, PAX_TASK_ROUND_RECT, pax_round_rect_spans(buf, shape, unshaded_span_rect, &ctx));
+    }
+}
+
+// Draw a solid-colored rectangle with rounded corners.
+void pax_dispatch_unshaded_round_rect(pax_buf_t *buf, pax_col_t color, pax_round_rectf shape) {
+    unshaded_round_rect(buf, color, shape, DISPATCH(buf, unshaded_round_rect));
+}
+
+// Draw a solid-colored rectangle with rounded corners and anti-aliased edges.
+void pax_dispatch_unshaded_round_rect_aa(pax_buf_t *buf, pax_col_t color, pax_round_rectf shape) {
+    // Render engines that can't anti-alias draw the rectangle aliased instead.
+    void (*func)(pax_buf_t *, pax_col_t, pax_round_rectf) = DISPATCH(buf, unshaded_round_rect_aa);
+    if (!func) {
+        func = DISPATCH(buf, unshaded_round_rect);
+    }
+    unshaded_round_rect(buf, color, shape, func);
 }
 
 
@@ -103,44 +363,48 @@ void pax_dispatch_unshaded_tri(pax_buf_t *buf, pax_col_t color, pax_trif shape)
 void pax_dispatch_shaded_line(
     pax_buf_t *buf, pax_col_t color, pax_linef shape, pax_shader_t const *shader, pax_linef uv
 ) {
-    if (implicit_dirty) {
+    CULL(culled_line(buf, shape));
+    if (IMPLICIT_DIRTY(buf) && !buf->dlist) {
         clipped_mark_dirty1(buf, shape.x0, shape.y0);
         clipped_mark_dirty1(buf, shape.x1, shape.y1);
     }
-    RENDERFUNC(shaded_line)(buf, color, shape, shader, uv);
+    COUNTED(buf, PAX_TASK_LINE, DISPATCH(buf, shaded_line)(buf, color, shape, shader, uv));
 }
 
 // Draw a rectangle with a shader.
 void pax_dispatch_shaded_rect(
     pax_buf_t *buf, pax_col_t color, pax_rectf shape, pax_shader_t const *shader, pax_quadf uv
 ) {
-    if (implicit_dirty) {
+    CULL(culled_rect(buf, shape.x, shape.y, shape.w, shape.h));
+    if (IMPLICIT_DIRTY(buf) && !buf->dlist) {
         clipped_mark_dirty2(buf, shape.x, shape.y, shape.w, shape.h);
     }
-    RENDERFUNC(shaded_rect)(buf, color, shape, shader, uv);
+    COUNTED(buf, PAX_TASK_RECT, DISPATCH(buf, shaded_rect)(buf, color, shape, shader, uv));
 }
 
 // Draw a quad with a shader.
 void pax_dispatch_shaded_quad(
     pax_buf_t *buf, pax_col_t color, pax_quadf shape, pax_shader_t const *shader, pax_quadf uv
 ) {
-    if (implicit_dirty) {
+    CULL(culled_quad(buf, shape));
+    if (IMPLICIT_DIRTY(buf) && !buf->dlist) {
         clipped_mark_dirty1(buf, shape.x0, shape.y0);
         clipped_mark_dirty1(buf, shape.x1, shape.y1);
         clipped_mark_dirty1(buf, shape.x2, shape.y2);
         clipped_mark_dirty1(buf, shape.x3, shape.y3);
     }
-    RENDERFUNC(shaded_quad)(buf, color, shape, shader, uv);
+    COUNTED(buf, PAX_TASK_QUAD, DISPATCH(buf, shaded_quad)(buf, color, shape, shader, uv));
 }
 
 // Draw a triangle with a shader.
 void pax_dispatch_shaded_tri(pax_buf_t *buf, pax_col_t color, pax_trif shape, pax_shader_t const *shader, pax_trif uv) {
-    if (implicit_dirty) {
+    CULL(culled_tri(buf, shape));
+    if (IMPLICIT_DIRTY(buf) && !buf->dlist) {
         clipped_mark_dirty1(buf, shape.x0, shape.y0);
         clipped_mark_dirty1(buf, shape.x1, shape.y1);
         clipped_mark_dirty1(buf, shape.x2, shape.y2);
     }
-    RENDERFUNC(shaded_tri)(buf, color, shape, shader, uv);
+    COUNTED(buf, PAX_TASK_TRI, DISPATCH(buf, shaded_tri)(buf, color, shape, shader, uv));
 }
 
 
@@ -148,30 +412,37 @@ void pax_dispatch_shaded_tri(pax_buf_t *buf, pax_col_t color, pax_trif shape, pa
 void pax_dispatch_scaled_image(
     pax_buf_t *base, pax_buf_t const *top, pax_recti base_pos, pax_orientation_t top_orientation, bool assume_opaque
 ) {
-    if (implicit_dirty) {
+    CULL(culled_rect(base, base_pos.x, base_pos.y, base_pos.w, base_pos.h));
+    if (IMPLICIT_DIRTY(base) && !base->dlist) {
         clipped_mark_dirty2(base, base_pos.x, base_pos.y, base_pos.w, base_pos.h);
     }
-    RENDERFUNC(scaled_image)(base, top, base_pos, top_orientation, assume_opaque);
+    COUNTED(
+        base,
+        PAX_TASK_SCALED_IMAGE,
+        DISPATCH(base, scaled_image)(base, top, base_pos, top_orientation, assume_opaque)
+    );
 }
 
 // Draw a sprite; like a blit, but use color blending if applicable.
 void pax_dispatch_sprite(
     pax_buf_t *base, pax_buf_t const *top, pax_recti base_pos, pax_orientation_t top_orientation, pax_vec2i top_pos
 ) {
-    if (implicit_dirty) {
+    CULL(culled_rect(base, base_pos.x, base_pos.y, base_pos.w, base_pos.h));
+    if (IMPLICIT_DIRTY(base) && !base->dlist) {
         clipped_mark_dirty2(base, base_pos.x, base_pos.y, base_pos.w, base_pos.h);
     }
-    RENDERFUNC(sprite)(base, top, base_pos, top_orientation, top_pos);
+    COUNTED(base, PAX_TASK_SPRITE, DISPATCH(base, sprite)(base, top, base_pos, top_orientation, top_pos));
 }
 
 // Perform a buffer copying operation with a PAX buffer.
 void pax_dispatch_blit(
     pax_buf_t *base, pax_buf_t const *top, pax_recti base_pos, pax_orientation_t top_orientation, pax_vec2i top_pos
 ) {
-    if (implicit_dirty) {
+    CULL(culled_rect(base, base_pos.x, base_pos.y, base_pos.w, base_pos.h));
+    if (IMPLICIT_DIRTY(base) && !base->dlist) {
         clipped_mark_dirty2(base, base_pos.x, base_pos.y, base_pos.w, base_pos.h);
     }
-    RENDERFUNC(blit)(base, top, base_pos, top_orientation, top_pos);
+    COUNTED(base, PAX_TASK_BLIT, DISPATCH(base, blit)(base, top, base_pos, top_orientation, top_pos));
 }
 
 // Perform a buffer copying operation with an unmanaged user buffer.
@@ -183,18 +454,24 @@ void pax_dispatch_blit_raw(
     pax_orientation_t top_orientation,
     pax_vec2i         top_pos
 ) {
-    if (implicit_dirty) {
+    CULL(culled_rect(base, base_pos.x, base_pos.y, base_pos.w, base_pos.h));
+    if (IMPLICIT_DIRTY(base) && !base->dlist) {
         clipped_mark_dirty2(base, base_pos.x, base_pos.y, base_pos.w, base_pos.h);
     }
-    RENDERFUNC(blit_raw)(base, top, top_dims, base_pos, top_orientation, top_pos);
+    COUNTED(
+        base,
+        PAX_TASK_BLIT_RAW,
+        DISPATCH(base, blit_raw)(base, top, top_dims, base_pos, top_orientation, top_pos)
+    );
 }
 
 // Blit one or more characters of text in the bitmapped format.
 void pax_dispatch_blit_char(pax_buf_t *buf, pax_col_t color, pax_vec2i pos, int scale, pax_text_rsdata_t rsdata) {
-    if (implicit_dirty) {
+    CULL(culled_char(buf, pos, scale, rsdata));
+    if (IMPLICIT_DIRTY(buf) && !buf->dlist) {
         clipped_mark_dirty2(buf, pos.x, pos.y, rsdata.w, rsdata.h);
     }
-    RENDERFUNC(blit_char)(buf, color, pos, scale, rsdata);
+    COUNTED(buf, PAX_TASK_BLIT_CHAR, DISPATCH(buf, blit_char)(buf, color, pos, scale, rsdata));
 }
 
 // Draw a string of text in the bitmapped format.
@@ -211,42 +488,159 @@ void pax_dispatch_text(
     pax_align_t       valign,
     ptrdiff_t         cursorpos
 ) {
-    RENDERFUNC(text)(buf, matrix, color, font, font_size, pos, text, text_len, halign, valign, cursorpos);
+    CULL(culled_text(buf, matrix, font_size, pos, text, text_len));
+    COUNTED(
+        buf,
+        PAX_TASK_TEXT,
+        DISPATCH(buf, text)(buf, matrix, color, font, font_size, pos, text, text_len, halign, valign, cursorpos)
+    );
 }
 
 
 
-#if DEFAULT_RENDERER_ONLY
+// Get the render context `buf` draws through.
+pax_render_ctx_t *pax_get_render_ctx(pax_buf_t const *buf) {
+    return RENDER_CTX(buf);
+}
+
+// Set the render context `buf` draws through; `NULL` selects the default context.
+// Waits for pending drawing operations of the previous context to finish.
+void pax_buf_set_render_ctx(pax_buf_t *buf, pax_render_ctx_t *ctx) {
+    pax_render_ctx_join(RENDER_CTX(buf));
+    buf->render_ctx = ctx;
+}
+
+// Wait for all pending drawing operations of `buf`'s render context to finish.
+void pax_buf_join(pax_buf_t *buf) {
+    pax_render_ctx_join(RENDER_CTX(buf));
+}
 
-// Wait for all pending drawing operations to finish.
+// Wait for all pending drawing operations of the default render context to finish.
 void pax_join() {
-    // Nothing to do; default renderer is completely synchronous.
+    pax_render_ctx_join(&default_ctx);
 }
 
+// Wait for all pending drawing operations of a render context to finish.
+void pax_render_ctx_join(pax_render_ctx_t *ctx) {
+    if (ctx->funcs->join) {
+        PAX_STATS_START(start);
+        ctx->funcs->join(ctx->state);
+        PAX_STATS_WAIT("join", start);
+    }
+}
+
+// Insert a fence after all drawing operations queued so far in the default render context.
+pax_fence_t pax_insert_fence() {
+    return pax_render_ctx_insert_fence(&default_ctx, NULL, NULL);
+}
+
+// Insert a fence after all drawing operations queued so far in the render context `buf` draws through.
+pax_fence_t pax_buf_insert_fence(pax_buf_t *buf, pax_fence_cb_t callback, void *cookie) {
+    return pax_render_ctx_insert_fence(RENDER_CTX(buf), callback, cookie);
+}
 
-// Change the active render engine.
+// Insert a fence after all drawing operations queued so far in a render context.
+// Engines that draw synchronously complete the fence right away.
+pax_fence_t pax_render_ctx_insert_fence(pax_render_ctx_t *ctx, pax_fence_cb_t callback, void *cookie) {
+    if (!ctx->funcs->insert_fence) {
+        if (callback) {
+            callback(cookie);
+        }
+        return (pax_fence_t){ctx, 0};
+    }
+    return (pax_fence_t){ctx, ctx->funcs->insert_fence(ctx->state, callback, cookie)};
+}
+
+// Wait for all drawing operations queued before a fence to finish.
+void pax_fence_wait(pax_fence_t fence) {
+    if (fence.seq && fence.ctx->funcs->wait_fence) {
+        PAX_STATS_START(start);
+        fence.ctx->funcs->wait_fence(fence.ctx->state, fence.seq, true);
+        PAX_STATS_WAIT("fence", start);
+    }
+}
+
+// Check whether all drawing operations queued before a fence have finished, without waiting.
+bool pax_fence_poll(pax_fence_t fence) {
+    if (fence.seq && fence.ctx->funcs->wait_fence) {
+        return fence.ctx->funcs->wait_fence(fence.ctx->state, fence.seq, false);
+    }
+    return true;
+}
+
+#if DEFAULT_RENDERER_ONLY
+
+// Create a new render context.
+pax_render_ctx_t *pax_render_ctx_create(pax_render_engine_t const *engine, void *init_cookie) {
+    PAX_LOGW("pax", "Only default renderer is compiled; pax_render_ctx_create call ignored");
+    return NULL;
+}
+
+// Destroy a render context.
+void pax_render_ctx_destroy(pax_render_ctx_t *ctx) {
+}
+
+// Change the render engine of the default render context.
 void pax_set_renderer(pax_render_engine_t const *new_renderer, void *init_cookie) {
     PAX_LOGW("pax", "Only default renderer is compiled; pax_set_renderer call ignored");
 }
 
 #else
 
-// Wait for all pending drawing operations to finish.
-void pax_join() {
-    if (renderfunc->join) {
-        renderfunc->join();
+// Start an instance of `engine` in `ctx`.
+static bool pax_render_ctx_init(pax_render_ctx_t *ctx, pax_render_engine_t const *engine, void *init_cookie) {
+    void                     *state = NULL;
+    pax_render_funcs_t const *funcs = engine->init(&state, init_cookie);
+    if (!funcs) {
+        return false;
+    }
+    ctx->engine = engine;
+    ctx->funcs  = funcs;
+    ctx->state  = state;
+    return true;
+}
+
+// Stop the engine instance in `ctx` after waiting for its pending drawing operations.
+static void pax_render_ctx_deinit(pax_render_ctx_t *ctx) {
+    pax_render_ctx_join(ctx);
+    if (ctx->engine->deinit) {
+        ctx->engine->deinit(ctx->state);
     }
 }
 
+// Create a new render context.
+// The context has its own instance of `engine`, so it can draw concurrently with other contexts.
+pax_render_ctx_t *pax_render_ctx_create(pax_render_engine_t const *engine, void *init_cookie) {
+    pax_render_ctx_t *ctx = malloc(sizeof(pax_render_ctx_t));
+    if (!ctx) {
+        pax_set_err(PAX_ERR_NOMEM);
+        return NULL;
+    }
+    if (!pax_render_ctx_init(ctx, engine, init_cookie)) {
+        free(ctx);
+        return NULL;
+    }
+    return ctx;
+}
+
+// Destroy a render context.
+// Waits for pending drawing operations to finish; no buffers may use the context afterwards.
+void pax_render_ctx_destroy(pax_render_ctx_t *ctx) {
+    if (!ctx) {
+        return;
+    }
+    pax_render_ctx_deinit(ctx);
+    free(ctx);
+}
 
-// Change the active render engine.
+// Change the render engine of the default render context.
+// The old engine is stopped first so that engines with shared resources can be restarted with different settings.
 void pax_set_renderer(pax_render_engine_t const *new_renderer, void *init_cookie) {
-    if (renderer->deinit) {
-        renderer->deinit();
+    pax_render_ctx_deinit(&default_ctx);
+    if (!pax_render_ctx_init(&default_ctx, new_renderer, init_cookie)) {
+        PAX_LOGE("pax", "Failed to start render engine; falling back to the software renderer");
+        pax_render_ctx_init(&default_ctx, &pax_render_engine_soft, NULL);
     }
-    implicit_dirty = new_renderer->implicit_dirty;
-    renderfunc     = new_renderer->init(init_cookie);
-    renderer       = new_renderer;
 }
 
 #endif
@@ -6,29 +6,6 @@
 
 #include <endian.h>
 
-static inline void __attribute__((always_inline))
-getter_setter_bounds_check(pax_buf_t const *buf, int index, int length) {
-#if !CONFIG_PAX_BOUNDS_CHECK
-    (void)buf;
-    (void)index;
-    (void)length;
-#else
-    if (index < 0 || (length > 0 && (index + length < index || index + length > buf->width * buf->height))) {
-        PAX_LOGE(
-            "pax",
-            "Frame buffer access out of bounds: index %d, length %d on a %dx%d buffer",
-            index,
-            length,
-            buf->width,
-            buf->height
-        );
-        abort();
-    }
-#endif
-}
-
-
-
 /* ===== GETTERS AND SETTERS ===== */
 
 // Gets the index getters and setters for the given buffer.
@@ -51,6 +28,12 @@ void pax_get_setters(
         case name: *range_merger = pax_range_merger_##r##g##b##rgb; break;
     #include "helpers/pax_buf_type.inc"
     }
+    #if PAX_SIMD_X86 || PAX_SIMD_NEON
+    pax_range_setter_t simd_merger = pax_get_simd_range_merger(buf->type);
+    if (simd_merger) {
+        *range_merger = simd_merger;
+    }
+    #endif
 #else
     *range_merger = pax_range_merger_generic;
 #endif
@@ -82,6 +65,12 @@ void pax_get_setters(
             }
             break;
     }
+    #if PAX_SIMD_X86 || PAX_SIMD_NEON
+    pax_range_setter_t simd_setter = pax_get_simd_range_setter(buf);
+    if (simd_setter) {
+        *range_setter = simd_setter;
+    }
+    #endif
 #else
     *range_setter = pax_range_setter_generic;
 #endif
@@ -308,6 +297,26 @@ void pax_index_setter_32bpp_rev(pax_buf_t *buf, pax_col_t color, int index) {
 #pragma endregion index_setter
 
 
+// Sets a raw value on rows `y0` up to `y1` of the buffer, like a background fill does.
+// Large fills use non-temporal stores where the CPU has them, because the buffer won't stay in the cache anyway.
+void pax_fill_rows(pax_buf_t *buf, pax_col_t value, int y0, int y1) {
+    int index = y0 * buf->width;
+    int count = (y1 - y0) * buf->width;
+    PAX_STATS_PIXELS(false, count);
+#if PAX_SIMD_X86 && CONFIG_PAX_RANGE_SETTER
+    if (pax_simd_stream_setter(buf, value, index, count)) {
+        return;
+    }
+#endif
+    if (value == 0) {
+        size_t start = pax_buf_calc_size_dynamic(buf->width, y0, buf->type);
+        size_t end   = pax_buf_calc_size_dynamic(buf->width, y1, buf->type);
+        memset(buf->buf_8bpp + start, 0, end - start);
+    } else {
+        buf->range_setter(buf, value, index, count);
+    }
+}
+
 #pragma region range_setter
 #if CONFIG_PAX_RANGE_SETTER
 // Sets a raw value range from a 1BPP buffer.
@@ -318,7 +327,7 @@ void pax_range_setter_1bpp(pax_buf_t *buf, pax_col_t color, int index, int count
     }
     color &= 0x1;
     int i  = index;
-    while (i & 7) {
+    while ((i & 7) && i < index + count) {
         pax_index_setter_1bpp(buf, color, i);
         i++;
     }
@@ -338,7 +347,7 @@ void pax_range_setter_2bpp(pax_buf_t *buf, pax_col_t color, int index, int count
     }
     color &= 0x3;
     int i  = index;
-    while (i & 3) {
+    while ((i & 3) && i < index + count) {
         pax_index_setter_2bpp(buf, color, i);
         i++;
     }
@@ -527,7 +536,9 @@ pax_index_setter_t pax_get_setter(pax_buf_t const *buf, pax_col_t *col_ptr, pax_
         return pax_do_draw_col(buf, col) ? buf->setter : NULL;
     }
 
-    if (shader && (shader->callback == pax_shader_texture || shader->callback == pax_shader_texture_aa)) {
+    if (shader
+        && (shader->callback == pax_shader_texture || shader->callback == pax_shader_texture_aa
+            || shader->callback == pax_shader_texture_span || shader->callback == pax_shader_texture_aa_span)) {
         // We can determine whether to factor in alpha based on buffer type.
         if (((pax_buf_t *)shader->callback_args)->type_info.fmt_type == PAX_BUF_SUBTYPE_PALETTE) {
             // If alpha needs factoring in, return the merging setter.
@@ -0,0 +1,373 @@
+// SPDX-License-Identifier: MIT
+
+#include "pax_internal.h"
+
+#include <stdatomic.h>
+
+#if PAX_SIMD_X86
+    #include <emmintrin.h>
+#endif
+
+#if PAX_SIMD_X86 || PAX_SIMD_NEON
+
+// The merging in here is exact; it produces the same results as `pax_col_merge`.
+// For every channel, `pax_lerp_mask` computes `base + (((top - base) * part) >> 8)` with `part` in 0-256,
+// which is equal to `(base * (256 - part) + top * part) >> 8` and fits in 16 bits without any sign handling.
+
+    #if PAX_SIMD_X86
+        #define PAX_SIMD_ATTR_128 __attribute__((target("sse2")))
+        #define PAX_SIMD_ATTR_256 __attribute__((target("avx2")))
+    #else
+        #define PAX_SIMD_ATTR_128
+    #endif
+
+// Convert alpha from 0-255 to 0-256 the same way `pax_lerp_mask` does.
+static inline uint16_t pax_simd_part(pax_col_t color) {
+    uint16_t part = color >> 24;
+    return part + (part >> 7);
+}
+
+// Fill `out` with `reps` copies of the bytes of a pixel as stored in `buf`.
+static inline void pax_simd_pattern(pax_buf_t const *buf, pax_col_t color, uint8_t *out, int reps) {
+    int bytes = buf->type_info.bpp / 8;
+    if (bytes == 4) {
+        // The alpha channel is merged with opaque white like `pax_col_merge` does.
+        color |= 0xff000000;
+    }
+    if (buf->reverse_endianness) {
+        color = bytes == 4 ? pax_rev_endian_32(color) : pax_rev_endian_24(color);
+    }
+    for (int i = 0; i < reps; i++) {
+        for (int j = 0; j < bytes; j++) {
+            out[i * bytes + j] = color >> (8 * j);
+        }
+    }
+}
+
+// Defines the vector types for one vector width.
+    #define PAX_SIMD_TYPES(width)                                                                                      \
+        typedef uint8_t  pax_u8x##width  __attribute__((vector_size(width)));                                          \
+        typedef uint16_t pax_u16x##width __attribute__((vector_size(width * 2)));                                      \
+        typedef uint16_t pax_u16h##width __attribute__((vector_size(width)));
+
+PAX_SIMD_TYPES(16)
+    #if PAX_SIMD_X86
+PAX_SIMD_TYPES(32)
+    #endif
+
+    #if CONFIG_PAX_RANGE_MERGER
+// Defines the range mergers for one vector width.
+// The channels of a pixel are merged in the same way regardless of which channel they are,
+// so 32bpp and 24bpp pixels are merged as a stream of bytes against a repeating pattern of the top color.
+        #define PAX_SIMD_RANGE_MERGERS(width, attr)                                                                    \
+        /* Merge `count` vectors of bytes against `period` vectors of precomputed top color times part. */             \
+        attr static inline __attribute__((always_inline)) void pax_simd_merge_bytes_##width(                           \
+            uint8_t *ptr, int count, pax_u16x##width const *top, int period, uint16_t inv                              \
+        ) {                                                                                                            \
+            while (count > 0) {                                                                                        \
+                for (int i = 0; i < period; i++) {                                                                     \
+                    pax_u8x##width vec;                                                                                \
+                    memcpy(&vec, ptr, width);                                                                          \
+                    pax_u16x##width wide = __builtin_convertvector(vec, pax_u16x##width);                              \
+                    wide                 = (wide * inv + top[i]) >> 8;                                                 \
+                    vec                  = __builtin_convertvector(wide, pax_u8x##width);                              \
+                    memcpy(ptr, &vec, width);                                                                          \
+                    ptr += width;                                                                                      \
+                }                                                                                                      \
+                count -= period;                                                                                       \
+            }                                                                                                          \
+        }                                                                                                              \
+                                                                                                                       \
+        /* Merges a single 32-bit ARGB color into a range of 32-bit ARGB pixels. */                                    \
+        attr PAX_PERF_CRITICAL_ATTR void pax_range_merger_8888argb_v##width(                                           \
+            pax_buf_t *buf, pax_col_t color, int index, int count                                                      \
+        ) {                                                                                                            \
+            getter_setter_bounds_check(buf, index, count);                                                             \
+            int             vecs = count / (width / 4);                                                                \
+            uint16_t        part = pax_simd_part(color);                                                               \
+            uint8_t         pattern[width];                                                                            \
+            pax_u8x##width  tmp;                                                                                       \
+            pax_u16x##width top[1];                                                                                    \
+            pax_simd_pattern(buf, color, pattern, width / 4);                                                          \
+            memcpy(&tmp, pattern, width);                                                                              \
+            top[0] = __builtin_convertvector(tmp, pax_u16x##width) * part;                                             \
+            pax_simd_merge_bytes_##width(buf->buf_8bpp + index * 4, vecs, top, 1, 256 - part);                         \
+            index += vecs * (width / 4);                                                                               \
+            pax_range_merger_8888argb(buf, color, index, count - vecs * (width / 4));                                  \
+        }                                                                                                              \
+                                                                                                                       \
+        /* Merges a single 32-bit ARGB color into a range of 24-bit RGB pixels. */                                     \
+        attr PAX_PERF_CRITICAL_ATTR void pax_range_merger_888rgb_v##width(                                             \
+            pax_buf_t *buf, pax_col_t color, int index, int count                                                      \
+        ) {                                                                                                            \
+            getter_setter_bounds_check(buf, index, count);                                                             \
+            /* Three vectors hold a whole number of pixels. */                                                         \
+            int             vecs = count / width * 3;                                                                  \
+            uint16_t        part = pax_simd_part(color);                                                               \
+            uint8_t         pattern[width * 3];                                                                        \
+            pax_u8x##width  tmp;                                                                                       \
+            pax_u16x##width top[3];                                                                                    \
+            pax_simd_pattern(buf, color, pattern, width);                                                              \
+            for (int i = 0; i < 3; i++) {                                                                              \
+                memcpy(&tmp, pattern + i * width, width);                                                              \
+                top[i] = __builtin_convertvector(tmp, pax_u16x##width) * part;                                         \
+            }                                                                                                          \
+            pax_simd_merge_bytes_##width(buf->buf_8bpp + index * 3, vecs, top, 3, 256 - part);                         \
+            index += vecs / 3 * width;                                                                                 \
+            pax_range_merger_888rgb(buf, color, index, count - vecs / 3 * width);                                      \
+        }                                                                                                              \
+                                                                                                                       \
+        /* Merges a single 32-bit ARGB color into a range of 16-bit RGB pixels. */                                     \
+        attr PAX_PERF_CRITICAL_ATTR void pax_range_merger_565rgb_v##width(                                             \
+            pax_buf_t *buf, pax_col_t color, int index, int count                                                      \
+        ) {                                                                                                            \
+            getter_setter_bounds_check(buf, index, count);                                                             \
+            int       vecs  = count / (width / 2);                                                                     \
+            uint16_t  part  = pax_simd_part(color);                                                                    \
+            uint16_t  inv   = 256 - part;                                                                              \
+            uint16_t  top_r = ((color >> 16) & 255) * part;                                                            \
+            uint16_t  top_g = ((color >> 8) & 255) * part;                                                             \
+            uint16_t  top_b = (color & 255) * part;                                                                    \
+            bool      rev   = buf->reverse_endianness;                                                                 \
+            uint16_t *ptr   = buf->buf_16bpp + index;                                                                  \
+            for (int i = 0; i < vecs; i++) {                                                                           \
+                pax_u16h##width vec;                                                                                   \
+                memcpy(&vec, ptr, width);                                                                              \
+                if (rev) {                                                                                             \
+                    vec = (vec << 8) | (vec >> 8);                                                                     \
+                }                                                                                                      \
+                /* Expand to 8 bits per channel like `pax_565rgb_to_col`. */                                           \
+                pax_u16h##width r = vec >> 11;                                                                         \
+                pax_u16h##width g = (vec >> 5) & 0x3f;                                                                 \
+                pax_u16h##width b = vec & 0x1f;                                                                        \
+                r                 = (r << 3) | (r >> 2);                                                               \
+                g                 = (g << 2) | (g >> 4);                                                               \
+                b                 = (b << 3) | (b >> 2);                                                               \
+                r                 = (r * inv + top_r) >> 8;                                                            \
+                g                 = (g * inv + top_g) >> 8;                                                            \
+                b                 = (b * inv + top_b) >> 8;                                                            \
+                vec               = ((r >> 3) << 11) | ((g >> 2) << 5) | (b >> 3);                                     \
+                if (rev) {                                                                                             \
+                    vec = (vec << 8) | (vec >> 8);                                                                     \
+                }                                                                                                      \
+                memcpy(ptr, &vec, width);                                                                              \
+                ptr += width / 2;                                                                                      \
+            }                                                                                                          \
+            index += vecs * (width / 2);                                                                               \
+            pax_range_merger_565rgb(buf, color, index, count - vecs * (width / 2));                                    \
+        }
+
+PAX_SIMD_RANGE_MERGERS(16, PAX_SIMD_ATTR_128)
+        #if PAX_SIMD_X86
+PAX_SIMD_RANGE_MERGERS(32, PAX_SIMD_ATTR_256)
+        #endif
+    #endif
+
+    #if CONFIG_PAX_RANGE_SETTER
+// Fill `out` with `len` bytes worth of a raw pixel value that is `size` bytes long.
+static inline void pax_simd_fill_pattern(pax_col_t value, int size, uint8_t *out, int len) {
+    for (int i = 0; i < len; i++) {
+        out[i] = value >> (8 * (i % size));
+    }
+}
+
+// Fills larger than this many bytes are written with non-temporal stores, if the CPU has them.
+// The fill would evict most of the cache anyway, so writing around it saves reading the old data back in.
+        #define PAX_SIMD_STREAM_MIN (1024 * 1024)
+
+        #if PAX_SIMD_X86
+// Fill `bytes` bytes at `ptr` with non-temporal stores.
+// `pattern` is 48 bytes of pixels to repeat, starting at `ptr`, which is a whole number of pixels of any size.
+PAX_SIMD_ATTR_128 static void pax_simd_stream(uint8_t *ptr, size_t bytes, uint8_t const *pattern) {
+    // Non-temporal stores need to be aligned.
+    size_t i = -(uintptr_t)ptr & 15;
+    if (i > bytes) {
+        i = bytes;
+    }
+    for (size_t j = 0; j < i; j++) {
+        ptr[j] = pattern[j];
+    }
+    __m128i vec[3];
+    for (int j = 0; j < 3; j++) {
+        uint8_t tmp[16];
+        for (int k = 0; k < 16; k++) {
+            tmp[k] = pattern[(i + j * 16 + k) % 48];
+        }
+        vec[j] = _mm_loadu_si128((__m128i const *)tmp);
+    }
+    for (int j = 0; i + 16 <= bytes; i += 16) {
+        _mm_stream_si128((__m128i *)(ptr + i), vec[j]);
+        j = j == 2 ? 0 : j + 1;
+    }
+    _mm_sfence();
+    for (; i < bytes; i++) {
+        ptr[i] = pattern[i % 48];
+    }
+}
+        #endif
+
+// Fill a range of `count` pixels that are `size` bytes each with non-temporal stores, if it is large enough.
+// Returns whether the range was filled.
+static inline bool pax_simd_stream_range(uint8_t *ptr, pax_col_t value, int size, int count) {
+        #if PAX_SIMD_X86
+    size_t bytes = (size_t)count * size;
+    if (bytes < PAX_SIMD_STREAM_MIN) {
+        return false;
+    }
+    uint8_t pattern[48];
+    pax_simd_fill_pattern(value, size, pattern, 48);
+    pax_simd_stream(ptr, bytes, pattern);
+    return true;
+        #else
+    (void)ptr;
+    (void)value;
+    (void)size;
+    (void)count;
+    return false;
+        #endif
+}
+
+// Sets a raw value on a large range of pixels with non-temporal stores, in the byte order of `buf`.
+// Returns false if the range is too small to benefit or the buffer type isn't supported.
+bool pax_simd_stream_setter(pax_buf_t *buf, pax_col_t value, int index, int count) {
+    getter_setter_bounds_check(buf, index, count);
+    int size = buf->type_info.bpp / 8;
+    if (buf->type_info.bpp % 8 || size < 1 || size > 4) {
+        return false;
+    }
+    if (buf->reverse_endianness) {
+        if (size == 2) {
+            value = pax_rev_endian_16(value);
+        } else if (size == 3) {
+            value = pax_rev_endian_24(value);
+        } else if (size == 4) {
+            value = pax_rev_endian_32(value);
+        }
+    }
+    return pax_simd_stream_range(buf->buf_8bpp + (size_t)index * size, value, size, count);
+}
+
+// Defines a range setter for one vector width and pixel size.
+// Pixels are written as a stream of bytes; `period` vectors hold a whole number of pixels.
+        #define PAX_SIMD_RANGE_SETTER(width, attr, bits, period)                                                       \
+            attr PAX_PERF_CRITICAL_ATTR void pax_range_setter_##bits##bpp_v##width(                                    \
+                pax_buf_t *buf, pax_col_t color, int index, int count                                                  \
+            ) {                                                                                                        \
+                getter_setter_bounds_check(buf, index, count);                                                         \
+                int      size = bits / 8;                                                                              \
+                uint8_t *ptr  = buf->buf_8bpp + (size_t)index * size;                                                  \
+                if (pax_simd_stream_range(ptr, color, size, count)) {                                                  \
+                    return;                                                                                            \
+                }                                                                                                      \
+                int vecs = count * size / (width * period) * period;                                                   \
+                if (vecs) {                                                                                            \
+                    uint8_t        pattern[width * period];                                                            \
+                    pax_u8x##width vec[period];                                                                        \
+                    pax_simd_fill_pattern(color, size, pattern, width * period);                                       \
+                    memcpy(vec, pattern, width * period);                                                              \
+                    for (int i = 0; i < vecs; i += period) {                                                           \
+                        for (int j = 0; j < period; j++) {                                                             \
+                            memcpy(ptr, &vec[j], width);                                                               \
+                            ptr += width;                                                                              \
+                        }                                                                                              \
+                    }                                                                                                  \
+                    index += vecs * width / size;                                                                      \
+                    count -= vecs * width / size;                                                                      \
+                }                                                                                                      \
+                pax_range_setter_##bits##bpp(buf, color, index, count);                                                \
+            }                                                                                                          \
+                                                                                                                       \
+            attr PAX_PERF_CRITICAL_ATTR void pax_range_setter_##bits##bpp_rev_v##width(                                \
+                pax_buf_t *buf, pax_col_t color, int index, int count                                                  \
+            ) {                                                                                                        \
+                pax_range_setter_##bits##bpp_v##width(buf, pax_rev_endian_##bits(color), index, count);                \
+            }
+
+        #define PAX_SIMD_RANGE_SETTERS(width, attr)                                                                    \
+            PAX_SIMD_RANGE_SETTER(width, attr, 16, 1)                                                                  \
+            PAX_SIMD_RANGE_SETTER(width, attr, 24, 3)                                                                  \
+            PAX_SIMD_RANGE_SETTER(width, attr, 32, 1)
+
+PAX_SIMD_RANGE_SETTERS(16, PAX_SIMD_ATTR_128)
+        #if PAX_SIMD_X86
+PAX_SIMD_RANGE_SETTERS(32, PAX_SIMD_ATTR_256)
+        #endif
+    #endif
+
+// Get the widest vector size in bytes that the CPU supports.
+static int pax_simd_width() {
+    #if PAX_SIMD_X86
+    // Buffers may be initialized on several threads at once; they all detect the same width, so relaxed is enough.
+    static _Atomic int cached = -1;
+    int                width  = atomic_load_explicit(&cached, memory_order_relaxed);
+    if (width < 0) {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            width = 32;
+        } else if (__builtin_cpu_supports("sse2")) {
+            width = 16;
+        } else {
+            width = 0;
+        }
+        atomic_store_explicit(&cached, width, memory_order_relaxed);
+    }
+    return width;
+    #else
+    return 16;
+    #endif
+}
+
+    #if CONFIG_PAX_RANGE_MERGER
+// Get a vectorized range merger for the given buffer type, if there is one for this CPU.
+pax_range_setter_t pax_get_simd_range_merger(pax_buf_type_t type) {
+    int width = pax_simd_width();
+        #if PAX_SIMD_X86
+    if (width >= 32) {
+        switch (type) {
+            case PAX_BUF_32_8888ARGB: return pax_range_merger_8888argb_v32;
+            case PAX_BUF_24_888RGB: return pax_range_merger_888rgb_v32;
+            case PAX_BUF_16_565RGB: return pax_range_merger_565rgb_v32;
+            default: return NULL;
+        }
+    }
+        #endif
+    if (width >= 16) {
+        switch (type) {
+            case PAX_BUF_32_8888ARGB: return pax_range_merger_8888argb_v16;
+            case PAX_BUF_24_888RGB: return pax_range_merger_888rgb_v16;
+            case PAX_BUF_16_565RGB: return pax_range_merger_565rgb_v16;
+            default: return NULL;
+        }
+    }
+    return NULL;
+}
+    #endif
+
+    #if CONFIG_PAX_RANGE_SETTER
+// Get a vectorized range setter for the given buffer, if there is one for this CPU.
+pax_range_setter_t pax_get_simd_range_setter(pax_buf_t const *buf) {
+    int  width = pax_simd_width();
+    bool rev   = buf->reverse_endianness;
+        #if PAX_SIMD_X86
+    if (width >= 32) {
+        switch (buf->type_info.bpp) {
+            case 16: return rev ? pax_range_setter_16bpp_rev_v32 : pax_range_setter_16bpp_v32;
+            case 24: return rev ? pax_range_setter_24bpp_rev_v32 : pax_range_setter_24bpp_v32;
+            case 32: return rev ? pax_range_setter_32bpp_rev_v32 : pax_range_setter_32bpp_v32;
+            default: return NULL;
+        }
+    }
+        #endif
+    if (width >= 16) {
+        switch (buf->type_info.bpp) {
+            case 16: return rev ? pax_range_setter_16bpp_rev_v16 : pax_range_setter_16bpp_v16;
+            case 24: return rev ? pax_range_setter_24bpp_rev_v16 : pax_range_setter_24bpp_v16;
+            case 32: return rev ? pax_range_setter_32bpp_rev_v16 : pax_range_setter_32bpp_v16;
+            default: return NULL;
+        }
+    }
+    return NULL;
+}
+    #endif
+
+#endif
@@ -44,10 +44,9 @@ static inline __attribute__((always_inline)) uint8_t sample_glyph(int x, int y,
 }
 
 // Texture shader for bitmap fonts on palette type buffers.
-pax_col_t pax_shader_font_bmp_pal(pax_col_t tint, pax_col_t existing, int x, int y, float u, float v, void *args0) {
+static inline __attribute__((always_inline)) pax_col_t
+    shade_font_bmp_pal(pax_col_t tint, pax_col_t existing, float u, float v, void *args0) {
     pax_text_rsdata_t const *args = args0;
-    (void)x;
-    (void)y;
 
     // Get texture coords.
     int glyph_x = u;
@@ -57,10 +56,9 @@ pax_col_t pax_shader_font_bmp_pal(pax_col_t tint, pax_col_t existing, int x, int
 }
 
 // Texture shader for bitmap fonts.
-pax_col_t pax_shader_font_bmp(pax_col_t tint, pax_col_t existing, int x, int y, float u, float v, void *args0) {
+static inline __attribute__((always_inline)) pax_col_t
+    shade_font_bmp(pax_col_t tint, pax_col_t existing, float u, float v, void *args0) {
     pax_text_rsdata_t const *args = args0;
-    (void)x;
-    (void)y;
 
     // Get texture coords.
     int glyph_x = u;
@@ -75,10 +73,9 @@ pax_col_t pax_shader_font_bmp(pax_col_t tint, pax_col_t existing, int x, int y,
 }
 
 // Texture shader for bitmap fonts with linear interpolation.
-pax_col_t pax_shader_font_bmp_aa(pax_col_t tint, pax_col_t existing, int x, int y, float u, float v, void *args0) {
+static inline __attribute__((always_inline)) pax_col_t
+    shade_font_bmp_aa(pax_col_t tint, pax_col_t existing, float u, float v, void *args0) {
     pax_text_rsdata_t const *args = args0;
-    (void)x;
-    (void)y;
 
     // Correct UVs for the offset caused by filtering.
     u                -= 0.5;
@@ -129,10 +126,9 @@ pax_col_t pax_shader_font_bmp_aa(pax_col_t tint, pax_col_t existing, int x, int
 
 
 // Texture shader without interpolation.
-pax_col_t pax_shader_texture(pax_col_t tint, pax_col_t existing, int x, int y, float u, float v, void *args) {
+static inline __attribute__((always_inline)) pax_col_t
+    shade_texture(pax_col_t tint, pax_col_t existing, float u, float v, void *args) {
     (void)tint;
-    (void)x;
-    (void)y;
     // Pointer cast to texture thingy.
     pax_buf_t const *image = (pax_buf_t const *)args;
 
@@ -169,10 +165,9 @@ static inline __attribute__((always_inline)) uint32_t
 }
 
 // Texture shader with interpolation.
-pax_col_t pax_shader_texture_aa(pax_col_t tint, pax_col_t existing, int x, int y, float u, float v, void *args) {
+static inline __attribute__((always_inline)) pax_col_t
+    shade_texture_aa(pax_col_t tint, pax_col_t existing, float u, float v, void *args) {
     (void)tint;
-    (void)x;
-    (void)y;
     // Pointer cast to texture thingy.
     pax_buf_t const *image = (pax_buf_t const *)args;
 
@@ -237,3 +232,38 @@ pax_col_t pax_shader_texture_aa(pax_col_t tint, pax_col_t existing, int x, int y
         return color;
     }
 }
+
+
+
+// Defines the per-pixel and span versions of a shader.
+#define PAX_DEF_SHADER(name, pixel_func)                                                                               \
+    pax_col_t name(pax_col_t tint, pax_col_t existing, int x, int y, float u, float v, void *args) {                   \
+        (void)x;                                                                                                       \
+        (void)y;                                                                                                       \
+        return pixel_func(tint, existing, u, v, args);                                                                 \
+    }                                                                                                                  \
+    void name##_span(                                                                                                  \
+        pax_col_t        tint,                                                                                         \
+        pax_col_t const *existing,                                                                                     \
+        pax_col_t       *out,                                                                                          \
+        int              x,                                                                                            \
+        int              y,                                                                                            \
+        int              count,                                                                                        \
+        float            u,                                                                                            \
+        float            v,                                                                                            \
+        float            du,                                                                                           \
+        float            dv,                                                                                           \
+        void            *args                                                                                          \
+    ) {                                                                                                                \
+        (void)x;                                                                                                       \
+        (void)y;                                                                                                       \
+        for (int i = 0; i < count; i++) {                                                                              \
+            out[i] = pixel_func(tint, existing[i], u + i * du, v + i * dv, args);                                      \
+        }                                                                                                              \
+    }
+
+PAX_DEF_SHADER(pax_shader_font_bmp_pal, shade_font_bmp_pal)
+PAX_DEF_SHADER(pax_shader_font_bmp, shade_font_bmp)
+PAX_DEF_SHADER(pax_shader_font_bmp_aa, shade_font_bmp_aa)
+PAX_DEF_SHADER(pax_shader_texture, shade_texture)
+PAX_DEF_SHADER(pax_shader_texture_aa, shade_texture_aa)
@@ -4,6 +4,7 @@
 #include "pax_shapes.h"
 
 #include "pax_internal.h"
+#include "pax_renderer.h"
 
 #include <assert.h>
 #include <malloc.h>
@@ -424,6 +425,75 @@ size_t pax_round_shape(pax_vec2f **output, size_t num_points, pax_vec2f *points,
 
 
 
+/* ======= POLYGON FILLING ======= */
+
+// Draw a shape made of one or more outlines, filled according to `rule`.
+// The points of all outlines are in `points`, one after the other, with the number of points of each in `contour_lens`.
+void pax_draw_shape_contours(
+    pax_buf_t       *buf,
+    pax_col_t        color,
+    size_t           num_contours,
+    size_t const    *contour_lens,
+    pax_vec2f const *points,
+    pax_fill_rule_t  rule
+) {
+    PAX_BUF_CHECK(buf);
+    if (!pax_do_draw_col(buf, color)) {
+        return;
+    }
+    size_t num_points = 0;
+    for (size_t i = 0; i < num_contours; i++) {
+        num_points += contour_lens[i];
+    }
+    if (num_points < 3) {
+        return;
+    }
+
+    // Apply the transforms to a copy of the points.
+    pax_vec2f *transformed = malloc(num_points * sizeof(pax_vec2f));
+    if (!transformed) {
+        PAX_ERROR(PAX_ERR_NOMEM);
+    }
+    for (size_t i = 0; i < num_points; i++) {
+        pax_vec2f point = points[i];
+        matrix_2d_transform(buf->stack_2d.value, &point.x, &point.y);
+        if (!isfinite(point.x) || !isfinite(point.y)) {
+            // We can't draw to infinity.
+            free(transformed);
+            PAX_ERROR(PAX_ERR_INF);
+        }
+#if CONFIG_PAX_COMPILE_ORIENTATION
+        point = pax_orient_det_vec2f(buf, point);
+#endif
+        transformed[i] = point;
+    }
+
+    pax_polyf shape = {
+        .points       = transformed,
+        .contour_lens = contour_lens,
+        .n_contours   = num_contours,
+        .rule         = rule,
+    };
+    pax_dispatch_unshaded_poly(buf, color, shape);
+    free(transformed);
+}
+
+// Draw a shape based on an outline, filled according to `rule`.
+// Closes the shape: no need to have the last point overlap the first.
+void pax_draw_shape_rule(
+    pax_buf_t *buf, pax_col_t color, size_t num_points, pax_vec2f const *points, pax_fill_rule_t rule
+) {
+    pax_draw_shape_contours(buf, color, 1, &num_points, points, rule);
+}
+
+// Draw a shape based on an outline, filled with the nonzero rule.
+// Closes the shape: no need to have the last point overlap the first.
+void pax_draw_shape(pax_buf_t *buf, pax_col_t color, size_t num_points, pax_vec2f const *points) {
+    pax_draw_shape_contours(buf, color, 1, &num_points, points, PAX_FILL_NONZERO);
+}
+
+
+
 /* ======== TRIANGULATION ======== */
 
 #if CONFIG_PAX_COMPILE_TRIANGULATE
@@ -656,31 +726,13 @@ void pax_draw_shape_triang(
         tri_index += 3;
     }
 }
-
-// Draw a shape based on an outline.
-// Closes the shape: no need to have the last point overlap the first.
-void pax_draw_shape(pax_buf_t *buf, pax_col_t color, size_t num_points, pax_vec2f const *points) {
-    // Simply outsource the triangulation.
-    size_t *tris   = NULL;
-    size_t  n_tris = pax_triang_concave(&tris, num_points, points);
-    if (!tris) {
-        return;
-    }
-    pax_draw_shape_triang(buf, color, num_points, points, n_tris, tris);
-    // And free el triangles.
-    free(tris);
-}
 #else
 // Stub method because the real one isn't compiled in.
 size_t pax_triang_complete(size_t **output, pax_vec2f **additional_points, size_t num_points, pax_vec2f *points) {
     PAX_ERROR(PAX_ERR_UNSUPPORTED, 0);
 }
 // Stub method because the real one isn't compiled in.
-void pax_triang_concave(size_t **output, size_t num_points, pax_vec2f *points) {
-    PAX_ERROR(PAX_ERR_UNSUPPORTED);
-}
-// Stub method because the real one isn't compiled in.
-void pax_draw_shape(pax_buf_t *buf, pax_col_t color, size_t num_points, pax_vec2f *points) {
-    PAX_ERROR(PAX_ERR_UNSUPPORTED);
+size_t pax_triang_concave(size_t **output, size_t num_points, pax_vec2f const *points) {
+    PAX_ERROR(PAX_ERR_UNSUPPORTED, 0);
 }
 #endif
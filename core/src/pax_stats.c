@@ -0,0 +1,331 @@
+
+// SPDX-License-Identifier: MIT
+
+#include "pax_stats.h"
+
+#include "pax_internal.h"
+
+#if !CONFIG_PAX_STATS
+
+// Get the rendering statistics gathered since startup or the last `pax_stats_reset`.
+// Returns `false` if PAX was compiled without `CONFIG_PAX_STATS`.
+bool pax_stats_get(pax_stats_t *out) {
+    (void)out;
+    return false;
+}
+
+// Set all rendering statistics to zero, for example at the start of a frame.
+void pax_stats_reset() {
+}
+
+// Start recording a trace of up to `max_events` draw calls, worker tasks and waits, discarding the previous trace.
+// Returns `false` if out of memory or PAX was compiled without `CONFIG_PAX_STATS`.
+bool pax_trace_start(size_t max_events) {
+    (void)max_events;
+    PAX_LOGW("pax-stats", "Statistics are not compiled in; pax_trace_start call ignored");
+    return false;
+}
+
+// Stop recording the trace; events recorded so far are kept until the next `pax_trace_start`.
+void pax_trace_stop() {
+}
+
+// Write the recorded trace as Chrome `trace_event` JSON, which can be opened in `chrome://tracing` or Perfetto.
+// Returns `false` if nothing was recorded or PAX was compiled without `CONFIG_PAX_STATS`.
+bool pax_trace_write(FILE *fd) {
+    (void)fd;
+    return false;
+}
+
+#else
+
+    #include <inttypes.h>
+    #include <stdatomic.h>
+    #include <string.h>
+
+    #ifdef PAX_ESP_IDF
+        #include <esp_timer.h>
+    #else
+        #include <time.h>
+    #endif
+
+// A single complete event in a trace.
+typedef struct {
+    // Name of the task type or wait.
+    char const *name;
+    // Category of the event: draw calls, worker tasks or waits.
+    char const *cat;
+    // Thread the event happened on.
+    int         tid;
+    // Start time and duration in nanoseconds.
+    uint64_t    start, dur;
+} pax_trace_event_t;
+
+// Names of the task types in traces.
+static char const *const task_names[PAX_N_TASK_TYPES] = {
+    [PAX_TASK_STOP]         = "stop",
+    [PAX_TASK_QUAD]         = "quad",
+    [PAX_TASK_RECT]         = "rect",
+    [PAX_TASK_TRI]          = "tri",
+    [PAX_TASK_LINE]         = "line",
+    [PAX_TASK_SPRITE]       = "sprite",
+    [PAX_TASK_BLIT]         = "blit",
+    [PAX_TASK_BLIT_RAW]     = "blit_raw",
+    [PAX_TASK_BLIT_CHAR]    = "blit_char",
+    [PAX_TASK_TEXT]         = "text",
+    [PAX_TASK_BACKGROUND]   = "background",
+    [PAX_TASK_SCALED_IMAGE] = "scaled_image",
+    [PAX_TASK_GLYPHS]       = "glyphs",
+    [PAX_TASK_POLY]         = "poly",
+    [PAX_TASK_ELLIPSE]      = "ellipse",
+    [PAX_TASK_ROUND_RECT]   = "round_rect",
+    [PAX_TASK_FENCE]        = "fence",
+};
+
+// Counters of the current thread.
+__thread pax_stats_local_t pax_stats_local;
+
+// Index of the async renderer worker running on the current thread, or -1 if it isn't a worker.
+static __thread int thread_worker = -1;
+// Trace thread ID of the current thread, or 0 if it has not been assigned yet.
+static __thread int thread_tid;
+// Next trace thread ID to assign.
+static atomic_int   next_tid = 1;
+// Trace thread IDs of the async renderer workers, or 0 for workers that have not started.
+static atomic_int   worker_tids[CONFIG_PAX_ASYNC_MAX_WORKERS];
+
+// Totals of the counters in `pax_stats_t`; times are in nanoseconds.
+static _Atomic uint64_t tasks[PAX_N_TASK_TYPES];
+static _Atomic uint64_t culled;
+static _Atomic uint64_t hidden;
+static _Atomic uint64_t pixels_filled;
+static _Atomic uint64_t pixels_blended;
+static _Atomic uint64_t shader_calls;
+static _Atomic uint64_t queue_high_water;
+static _Atomic uint64_t joins;
+static _Atomic uint64_t join_wait;
+static _Atomic uint64_t worker_busy[CONFIG_PAX_ASYNC_MAX_WORKERS];
+static _Atomic uint64_t worker_stolen[CONFIG_PAX_ASYNC_MAX_WORKERS];
+
+// Whether a trace is being recorded.
+static atomic_bool        tracing;
+// Events of the trace; `trace_len` may exceed `trace_cap` when events were dropped.
+static pax_trace_event_t *trace_events;
+static size_t             trace_cap;
+static atomic_size_t      trace_len;
+// Time the trace was started at.
+static uint64_t           trace_epoch;
+
+// Get the current time in nanoseconds.
+uint64_t pax_stats_time() {
+    #ifdef PAX_ESP_IDF
+    return esp_timer_get_time() * 1000;
+    #else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * (uint64_t)1000000000 + now.tv_nsec;
+    #endif
+}
+
+// Add the counters of the current thread to the totals.
+static void pax_stats_flush() {
+    if (pax_stats_local.pixels_filled) {
+        atomic_fetch_add_explicit(&pixels_filled, pax_stats_local.pixels_filled, memory_order_relaxed);
+    }
+    if (pax_stats_local.pixels_blended) {
+        atomic_fetch_add_explicit(&pixels_blended, pax_stats_local.pixels_blended, memory_order_relaxed);
+    }
+    if (pax_stats_local.shader_calls) {
+        atomic_fetch_add_explicit(&shader_calls, pax_stats_local.shader_calls, memory_order_relaxed);
+    }
+    pax_stats_local = (pax_stats_local_t){0};
+}
+
+// Add an event from `start` until now to the trace, if one is being recorded.
+// Returns the duration of the event.
+static uint64_t pax_trace_event(char const *name, char const *cat, uint64_t start) {
+    uint64_t dur = pax_stats_time() - start;
+    if (!atomic_load_explicit(&tracing, memory_order_acquire)) {
+        return dur;
+    }
+    size_t index = atomic_fetch_add_explicit(&trace_len, 1, memory_order_relaxed);
+    if (index >= trace_cap) {
+        return dur;
+    }
+    if (!thread_tid) {
+        thread_tid = atomic_fetch_add_explicit(&next_tid, 1, memory_order_relaxed);
+    }
+    trace_events[index] = (pax_trace_event_t){name, cat, thread_tid, start, dur};
+    return dur;
+}
+
+// Count a draw call that started at `start` and add the counters of the current thread to the totals.
+void pax_stats_task(pax_task_type_t type, uint64_t start) {
+    atomic_fetch_add_explicit(&tasks[type], 1, memory_order_relaxed);
+    pax_trace_event(task_names[type], "draw", start);
+    pax_stats_flush();
+}
+
+// Count a draw call that was dropped because it was entirely outside the clip rectangle.
+void pax_stats_cull() {
+    atomic_fetch_add_explicit(&culled, 1, memory_order_relaxed);
+}
+
+// Count `count` queued async renderer commands that were discarded because a later opaque draw covered them.
+void pax_stats_hide(size_t count) {
+    atomic_fetch_add_explicit(&hidden, count, memory_order_relaxed);
+}
+
+// Count a task that an async renderer worker ran for a band owned by worker `owner`, starting at `start`.
+void pax_stats_exec(pax_task_type_t type, int owner, uint64_t start) {
+    uint64_t dur = pax_trace_event(task_names[type], "worker", start);
+    if (thread_worker >= 0) {
+        atomic_fetch_add_explicit(&worker_busy[thread_worker], dur, memory_order_relaxed);
+        if (owner != thread_worker) {
+            atomic_fetch_add_explicit(&worker_stolen[thread_worker], 1, memory_order_relaxed);
+        }
+    }
+    pax_stats_flush();
+}
+
+// Count a wait for a render context or a fence that started at `start`.
+void pax_stats_wait(char const *name, uint64_t start) {
+    uint64_t dur = pax_trace_event(name, "wait", start);
+    atomic_fetch_add_explicit(&joins, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&join_wait, dur, memory_order_relaxed);
+}
+
+// Update the high-water mark of bytes of commands waiting in an async renderer band.
+void pax_stats_queue_depth(size_t depth) {
+    uint64_t old = atomic_load_explicit(&queue_high_water, memory_order_relaxed);
+    while (depth > old
+           && !atomic_compare_exchange_weak_explicit(
+               &queue_high_water,
+               &old,
+               depth,
+               memory_order_relaxed,
+               memory_order_relaxed
+           ));
+}
+
+// Called by async renderer worker threads when they start.
+void pax_stats_worker_start(int index) {
+    thread_worker = index;
+    thread_tid    = atomic_fetch_add_explicit(&next_tid, 1, memory_order_relaxed);
+    atomic_store_explicit(&worker_tids[index], thread_tid, memory_order_relaxed);
+}
+
+
+
+// Get the rendering statistics gathered since startup or the last `pax_stats_reset`.
+// Returns `false` if PAX was compiled without `CONFIG_PAX_STATS`.
+bool pax_stats_get(pax_stats_t *out) {
+    pax_stats_flush();
+    for (int i = 0; i < PAX_N_TASK_TYPES; i++) {
+        out->tasks[i] = atomic_load_explicit(&tasks[i], memory_order_relaxed);
+    }
+    out->culled           = atomic_load_explicit(&culled, memory_order_relaxed);
+    out->hidden           = atomic_load_explicit(&hidden, memory_order_relaxed);
+    out->pixels_filled    = atomic_load_explicit(&pixels_filled, memory_order_relaxed);
+    out->pixels_blended   = atomic_load_explicit(&pixels_blended, memory_order_relaxed);
+    out->shader_calls     = atomic_load_explicit(&shader_calls, memory_order_relaxed);
+    out->queue_high_water = atomic_load_explicit(&queue_high_water, memory_order_relaxed);
+    out->joins            = atomic_load_explicit(&joins, memory_order_relaxed);
+    out->join_wait_us     = atomic_load_explicit(&join_wait, memory_order_relaxed) / 1000;
+    for (int i = 0; i < CONFIG_PAX_ASYNC_MAX_WORKERS; i++) {
+        out->worker_busy_us[i] = atomic_load_explicit(&worker_busy[i], memory_order_relaxed) / 1000;
+        out->worker_stolen[i]  = atomic_load_explicit(&worker_stolen[i], memory_order_relaxed);
+    }
+    return true;
+}
+
+// Set all rendering statistics to zero, for example at the start of a frame.
+void pax_stats_reset() {
+    pax_stats_local = (pax_stats_local_t){0};
+    for (int i = 0; i < PAX_N_TASK_TYPES; i++) {
+        atomic_store_explicit(&tasks[i], 0, memory_order_relaxed);
+    }
+    atomic_store_explicit(&culled, 0, memory_order_relaxed);
+    atomic_store_explicit(&hidden, 0, memory_order_relaxed);
+    atomic_store_explicit(&pixels_filled, 0, memory_order_relaxed);
+    atomic_store_explicit(&pixels_blended, 0, memory_order_relaxed);
+    atomic_store_explicit(&shader_calls, 0, memory_order_relaxed);
+    atomic_store_explicit(&queue_high_water, 0, memory_order_relaxed);
+    atomic_store_explicit(&joins, 0, memory_order_relaxed);
+    atomic_store_explicit(&join_wait, 0, memory_order_relaxed);
+    for (int i = 0; i < CONFIG_PAX_ASYNC_MAX_WORKERS; i++) {
+        atomic_store_explicit(&worker_busy[i], 0, memory_order_relaxed);
+        atomic_store_explicit(&worker_stolen[i], 0, memory_order_relaxed);
+    }
+}
+
+// Start recording a trace of up to `max_events` draw calls, worker tasks and waits, discarding the previous trace.
+// Must not be called while drawing is in progress.
+// Returns `false` if out of memory or PAX was compiled without `CONFIG_PAX_STATS`.
+bool pax_trace_start(size_t max_events) {
+    atomic_store(&tracing, false);
+    free(trace_events);
+    trace_events = malloc(max_events * sizeof(pax_trace_event_t));
+    trace_cap    = trace_events ? max_events : 0;
+    atomic_store(&trace_len, 0);
+    if (!trace_events) {
+        PAX_ERROR(PAX_ERR_NOMEM, false);
+    }
+    trace_epoch = pax_stats_time();
+    atomic_store_explicit(&tracing, true, memory_order_release);
+    return true;
+}
+
+// Stop recording the trace; events recorded so far are kept until the next `pax_trace_start`.
+void pax_trace_stop() {
+    atomic_store(&tracing, false);
+}
+
+// Write the recorded trace as Chrome `trace_event` JSON, which can be opened in `chrome://tracing` or Perfetto.
+// Must not be called while drawing is in progress.
+// Returns `false` if nothing was recorded or PAX was compiled without `CONFIG_PAX_STATS`.
+bool pax_trace_write(FILE *fd) {
+    if (!trace_events) {
+        return false;
+    }
+    size_t len = atomic_load(&trace_len);
+    if (len > trace_cap) {
+        PAX_LOGW("pax-stats", "Trace is full; %zu events were dropped", len - trace_cap);
+        len = trace_cap;
+    }
+
+    fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n", fd);
+    for (int i = 0; i < CONFIG_PAX_ASYNC_MAX_WORKERS; i++) {
+        int tid = atomic_load_explicit(&worker_tids[i], memory_order_relaxed);
+        if (tid) {
+            fprintf(
+                fd,
+                "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"pax worker %d\"}},\n",
+                tid,
+                i
+            );
+        }
+    }
+    for (size_t i = 0; i < len; i++) {
+        pax_trace_event_t const *event = &trace_events[i];
+        // Timestamps are in microseconds; events from before the trace started are clamped to its start.
+        uint64_t                 ts    = event->start > trace_epoch ? event->start - trace_epoch : 0;
+        fprintf(
+            fd,
+            "{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%" PRIu64 ".%03u,\"dur\":%" PRIu64
+            ".%03u},\n",
+            event->name,
+            event->cat,
+            event->tid,
+            ts / 1000,
+            (unsigned)(ts % 1000),
+            event->dur / 1000,
+            (unsigned)(event->dur % 1000)
+        );
+    }
+    // The metadata event keeps the list free of a trailing comma.
+    fputs("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"pax\"}}\n]}\n", fd);
+    return !ferror(fd);
+}
+
+#endif
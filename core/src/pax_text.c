@@ -121,124 +121,116 @@ static uint64_t text_promise_callback_none(pax_buf_t *buf, pax_col_t tint, void
     return 0;
 }
 
+// Draw a glyph laid out by the text renderer.
+void pax_text_draw_glyph(
+    pax_render_funcs_t const *funcs, pax_buf_t *buf, pax_col_t color, pax_text_glyph_t const *glyph
+) {
+    if (glyph->type == PAX_GLYPH_BLIT_CHAR) {
+        funcs->blit_char(buf, color, glyph->blit_char.pos, glyph->blit_char.scale, glyph->rsdata);
+        return;
+    } else if (glyph->type == PAX_GLYPH_CURSOR) {
+        funcs->unshaded_line(buf, color, glyph->line);
+        return;
+    }
+
+    // Set up shader.
+    pax_shader_t shader = {
+        .schema_version    = 2,
+        .schema_complement = ~2,
+        .renderer_id       = PAX_RENDERER_ID_SWR,
+        .promise_callback  = glyph->cutout ? text_promise_callback_cutout : text_promise_callback_none,
+        .callback          = glyph->shader,
+        .callback_args     = (void *)&glyph->rsdata,
+        .alpha_promise_0   = true,
+        .alpha_promise_255 = false,
+    };
+
+    // Set UVs to pixel coordinates for the glyph.
+    pax_quadf uvs = {
+        .x0 = 0,
+        .y0 = 0,
+        .x1 = glyph->rsdata.w,
+        .y1 = 0,
+        .x2 = glyph->rsdata.w,
+        .y2 = glyph->rsdata.h,
+        .x3 = 0,
+        .y3 = glyph->rsdata.h,
+    };
+
+    if (glyph->type == PAX_GLYPH_RECT) {
+#if CONFIG_PAX_COMPILE_ORIENTATION
+        if (buf->orientation & 1) {
+            uvs = (pax_quadf){uvs.x0, uvs.y0, uvs.x3, uvs.y3, uvs.x2, uvs.y2, uvs.x1, uvs.y1};
+        }
+#endif
+        funcs->shaded_rect(buf, color, glyph->rect, &shader, uvs);
+    } else {
+        funcs->shaded_quad(buf, color, glyph->quad, &shader, uvs);
+    }
+}
+
+// Hand a laid out glyph to the glyph callback, or draw it right away if there is none.
+static inline void emit_glyph(pax_text_render_t *ctx, pax_text_glyph_t const *glyph) {
+    if (ctx->glyph_cb) {
+        ctx->glyph_cb(ctx->glyph_args, glyph);
+    } else {
+        pax_text_draw_glyph(ctx->renderfuncs, ctx->buf, ctx->color, glyph);
+    }
+}
+
 // Pixel-aligned optimisation of pax_shade_rect, used for text.
 static void pixel_aligned_render(
-    pax_text_render_t  *ctx,
-    pax_shader_t const *shader,
-    pax_quadf const    *uvs,
-    float               x,
-    float               y,
-    float               width,
-    float               height
+    pax_text_render_t *ctx, pax_text_glyph_t *glyph, float x, float y, float width, float height
 ) {
     // Offset and pixel-align co-ordinates.
     x = floorf(0.5 + x + ctx->matrix.a2);
     y = floorf(0.5 + y + ctx->matrix.b2);
     pax_mark_dirty2(ctx->buf, x, y, width, height);
 
+    glyph->type = PAX_GLYPH_RECT;
 #if CONFIG_PAX_COMPILE_ORIENTATION
-    pax_rectf tmp = pax_orient_det_rectf(ctx->buf, (pax_rectf){x, y, width, height});
-    x             = tmp.x;
-    y             = tmp.y;
-    width         = tmp.w;
-    height        = tmp.h;
-
-    pax_quadf uvs_rotated;
-    if (ctx->buf->orientation & 1) {
-        uvs_rotated = (pax_quadf){
-            uvs->x0,
-            uvs->y0,
-            uvs->x3,
-            uvs->y3,
-            uvs->x2,
-            uvs->y2,
-            uvs->x1,
-            uvs->y1,
-        };
-        uvs = &uvs_rotated;
-    }
+    glyph->rect = pax_orient_det_rectf(ctx->buf, (pax_rectf){x, y, width, height});
+#else
+    glyph->rect = (pax_rectf){x, y, width, height};
 #endif
-
-    // Single core option.
-    ctx->renderfuncs->shaded_rect(
-        ctx->buf,
-        ctx->color,
-        (pax_rectf){
-            x,
-            y,
-            width,
-            height,
-        },
-        shader,
-        (pax_quadf){
-            uvs->x0,
-            uvs->y0,
-            uvs->x1,
-            uvs->y1,
-            uvs->x2,
-            uvs->y2,
-            uvs->x3,
-            uvs->y3,
-        }
-    );
+    emit_glyph(ctx, glyph);
 }
 
-// Dispatch the correct draw call for a glyph.
+// Lay out the correct draw call for a glyph.
 static void dispatch_glyph(
     pax_text_render_t *ctx, pax_vec2f pos, float scale, pax_font_range_t const *range, pax_text_rsdata_t rsdata
 ) {
-    float mat_scale = ctx->matrix.a0 * scale;
+    pax_text_glyph_t glyph     = {.rsdata = rsdata};
+    float            mat_scale = ctx->matrix.a0 * scale;
     if (ctx->matrix.a0 > 0 && fabsf(ctx->matrix.a0 - ctx->matrix.b1) < 0.01 && fabsf(mat_scale - (int)mat_scale) < 0.01
         && matrix_2d_is_identity2(ctx->matrix)) {
         // This can be optimized to the special text blitting function.
         // Apply the matrix's scale and translation to the glyph position (no rotation/shear possible here).
-        pax_vec2i blit_pos = {
+        glyph.type            = PAX_GLYPH_BLIT_CHAR;
+        glyph.blit_char.pos   = (pax_vec2i){
             (int)floorf(ctx->matrix.a0 * pos.x + ctx->matrix.a2 + 0.5f),
             (int)floorf(ctx->matrix.a0 * pos.y + ctx->matrix.b2 + 0.5f),
         };
-        ctx->renderfuncs->blit_char(ctx->buf, ctx->color, blit_pos, floorf(mat_scale + 0.5), rsdata);
+        glyph.blit_char.scale = floorf(mat_scale + 0.5);
+        emit_glyph(ctx, &glyph);
         return;
     }
 
-    // Set up shader.
-    pax_shader_t shader = {
-        .schema_version    = 1,
-        .schema_complement = ~1,
-        .renderer_id       = PAX_RENDERER_ID_SWR,
-        .callback_args     = (void *)&rsdata,
-        .alpha_promise_0   = true,
-        .alpha_promise_255 = false,
-    };
-
     // Select correct shader function.
     if ((ctx->buf->type_info.fmt_type == PAX_BUF_SUBTYPE_PALETTE)
         || (range->bitmap_mono.bpp == 1 && ctx->color >> 24 == 255)) {
-        shader.promise_callback = text_promise_callback_cutout;
-        shader.callback         = pax_shader_font_bmp_pal;
+        glyph.cutout = true;
+        glyph.shader = pax_shader_font_bmp_pal_span;
     } else if (ctx->font->recommend_aa) {
-        shader.promise_callback = text_promise_callback_none;
-        shader.callback         = pax_shader_font_bmp_aa;
+        glyph.shader = pax_shader_font_bmp_aa_span;
     } else {
-        shader.promise_callback = text_promise_callback_none;
-        shader.callback         = pax_shader_font_bmp;
+        glyph.shader = pax_shader_font_bmp_span;
     }
 
-    // Set UVs to pixel coordinates for the glyph.
-    pax_quadf uvs = {
-        .x0 = 0,
-        .y0 = 0,
-        .x1 = rsdata.w,
-        .y1 = 0,
-        .x2 = rsdata.w,
-        .y2 = rsdata.h,
-        .x3 = 0,
-        .y3 = rsdata.h,
-    };
-
     // Start drawing, boy!
     if (matrix_2d_is_identity2(ctx->matrix)) {
         // Pixel-aligned optimisation.
-        pixel_aligned_render(ctx, &shader, &uvs, pos.x, pos.y, scale * rsdata.w, scale * rsdata.h);
+        pixel_aligned_render(ctx, &glyph, pos.x, pos.y, scale * rsdata.w, scale * rsdata.h);
     } else {
         // Generic shader draw required.
         pax_vec2f p0 = matrix_2d_transform_alt(ctx->matrix, (pax_vec2f){pos.x, pos.y});
@@ -251,12 +243,24 @@ static void dispatch_glyph(
         p2 = pax_orient_det_vec2f(ctx->buf, p2);
         p3 = pax_orient_det_vec2f(ctx->buf, p3);
 #endif
-        pax_quadf shape
-            = {.x0 = p0.x, .y0 = p0.y, .x1 = p1.x, .y1 = p1.y, .x2 = p2.x, .y2 = p2.y, .x3 = p3.x, .y3 = p3.y};
-        ctx->renderfuncs->shaded_quad(ctx->buf, ctx->color, shape, &shader, uvs);
+        glyph.type = PAX_GLYPH_QUAD;
+        glyph.quad = (pax_quadf){p0.x, p0.y, p1.x, p1.y, p2.x, p2.y, p3.x, p3.y};
+        emit_glyph(ctx, &glyph);
     }
 }
 
+// Lay out the text cursor at `pos`.
+static void dispatch_cursor(pax_text_render_t *ctx, pax_vec2f pos, float scale) {
+    pax_vec2f p0 = pos;
+    pax_vec2f p1 = matrix_2d_transform_alt(ctx->matrix, (pax_vec2f){pos.x, pos.y + scale * ctx->font->default_size});
+
+    pax_text_glyph_t glyph = {
+        .type = PAX_GLYPH_CURSOR,
+        .line = {p0.x, p0.y, p1.x, p1.y},
+    };
+    emit_glyph(ctx, &glyph);
+}
+
 // Internal method for monospace bitmapped characters.
 static pax_vec2f text_bitmap_mono(
     pax_text_render_t *ctx, bool do_render, pax_vec2f pos, float scale, pax_font_range_t const *range, uint32_t glyph
@@ -339,11 +343,7 @@ static pax_vec2f text_line_generic_impl(
         // Draw cursor.
         if ((size_t)cursorpos == i) {
             if (do_render) {
-                pax_vec2f p0 = pos;
-                pax_vec2f p1
-                    = matrix_2d_transform_alt(ctx->matrix, (pax_vec2f){pos.x, pos.y + scale * ctx->font->default_size});
-                pax_linef shape = {p0.x, p0.y, p1.x, p1.y};
-                ctx->renderfuncs->unshaded_line(ctx->buf, ctx->color, shape);
+                dispatch_cursor(ctx, pos, scale);
             }
             cursor_x = x;
         }
@@ -382,11 +382,7 @@ static pax_vec2f text_line_generic_impl(
     // Edge case: Cursor at the end.
     if ((size_t)cursorpos == i) {
         if (do_render) {
-            pax_vec2f p0 = pos;
-            pax_vec2f p1
-                = matrix_2d_transform_alt(ctx->matrix, (pax_vec2f){pos.x, pos.y + scale * ctx->font->default_size});
-            pax_linef shape = {p0.x, p0.y, p1.x, p1.y};
-            ctx->renderfuncs->unshaded_line(ctx->buf, ctx->color, shape);
+            dispatch_cursor(ctx, pos, scale);
         }
         cursor_x = x;
     }
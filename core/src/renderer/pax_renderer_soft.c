@@ -31,11 +31,7 @@ void pax_swr_background(pax_buf_t *buf, pax_col_t color) {
         value = buf->col2buf(buf, color);
     }
 
-    if (value == 0) {
-        memset(buf->buf, 0, pax_buf_calc_size_dynamic(buf->width, buf->height, buf->type));
-    } else {
-        buf->range_setter(buf, value, 0, buf->width * buf->height);
-    }
+    pax_fill_rows(buf, value, 0, buf->height);
 }
 
 // Draw a solid-colored line.
@@ -58,6 +54,36 @@ void pax_swr_unshaded_tri(pax_buf_t *buf, pax_col_t color, pax_trif shape) {
     pax_tri_unshaded(buf, color, shape.x0, shape.y0, shape.x1, shape.y1, shape.x2, shape.y2);
 }
 
+// Draw a solid-colored quad with anti-aliased edges.
+void pax_swr_unshaded_quad_aa(pax_buf_t *buf, pax_col_t color, pax_quadf shape) {
+    pax_quad_unshaded_aa(buf, color, shape.x0, shape.y0, shape.x1, shape.y1, shape.x2, shape.y2, shape.x3, shape.y3);
+}
+
+// Draw a solid-colored triangle with anti-aliased edges.
+void pax_swr_unshaded_tri_aa(pax_buf_t *buf, pax_col_t color, pax_trif shape) {
+    pax_tri_unshaded_aa(buf, color, shape.x0, shape.y0, shape.x1, shape.y1, shape.x2, shape.y2);
+}
+
+// Draw a solid-colored polygon.
+void pax_swr_unshaded_poly(pax_buf_t *buf, pax_col_t color, pax_polyf shape) {
+    pax_poly_unshaded(buf, color, shape);
+}
+
+// Draw a solid-colored ellipse or elliptic ring.
+void pax_swr_unshaded_ellipse(pax_buf_t *buf, pax_col_t color, pax_ellipsef shape) {
+    pax_ellipse_unshaded(buf, color, shape);
+}
+
+// Draw a solid-colored rectangle with rounded corners.
+void pax_swr_unshaded_round_rect(pax_buf_t *buf, pax_col_t color, pax_round_rectf shape) {
+    pax_round_rect_unshaded(buf, color, shape);
+}
+
+// Draw a solid-colored rectangle with rounded corners and anti-aliased edges.
+void pax_swr_unshaded_round_rect_aa(pax_buf_t *buf, pax_col_t color, pax_round_rectf shape) {
+    pax_round_rect_unshaded_aa(buf, color, shape);
+}
+
 
 // Draw a line with a shader.
 void pax_swr_shaded_line(pax_buf_t *buf, pax_col_t color, pax_linef shape, pax_shader_t const *shader, pax_linef uv) {
@@ -181,53 +207,11 @@ void pax_swr_scaled_image(
     tex_end.x   *= top->width;
     tex_end.y   *= top->height;
 
-    {
-        float dx = (tex_end.x - tex_start.x) / base_pos.w;
-        float dy = (tex_end.y - tex_start.y) / base_pos.h;
-
-        if (base_pos.x < base->clip.x) {
-            int diff = base->clip.x - base_pos.x;
-            if (top_orientation & 1) {
-                tex_start.y += diff * dy;
-            } else {
-                tex_start.x += diff * dx;
-            }
-            base_pos.w -= diff;
-            base_pos.x += diff;
-        }
-        if (base_pos.x + base_pos.w > base->clip.x + base->clip.w) {
-            int diff = (base_pos.x + base_pos.w) - (base->clip.x + base->clip.w);
-            if (top_orientation & 1) {
-                tex_end.y -= diff * dy;
-            } else {
-                tex_end.x -= diff * dx;
-            }
-            base_pos.w -= diff;
-        }
-        if (base_pos.y < base->clip.y) {
-            int diff = base->clip.y - base_pos.y;
-            if (top_orientation & 1) {
-                tex_start.x += diff * dx;
-            } else {
-                tex_start.y += diff * dy;
-            }
-            base_pos.h -= diff;
-            base_pos.y += diff;
-        }
-        if (base_pos.y + base_pos.h > base->clip.y + base->clip.h) {
-            int diff = (base_pos.y + base_pos.h) - (base->clip.y + base->clip.h);
-            if (top_orientation & 1) {
-                tex_end.x -= diff * dx;
-            } else {
-                tex_end.y -= diff * dy;
-            }
-            base_pos.h -= diff;
-        }
-        if (base_pos.w < 0 || base_pos.h < 0) {
-            return;
-        }
+    if (base_pos.w <= 0 || base_pos.h <= 0) {
+        return;
     }
 
+    // Texture steps are derived from the unclipped image so that clipping does not affect sampling.
     pax_vec2f tex_dx = {0};
     pax_vec2f tex_dy = {0};
     if (!swap_xy) {
@@ -237,13 +221,22 @@ void pax_swr_scaled_image(
         tex_dy.x = (tex_end.x - tex_start.x) / base_pos.h;
         tex_dx.y = (tex_end.y - tex_start.y) / base_pos.w;
     }
-    tex_dy.x -= base_pos.w * tex_dx.x;
-    tex_dy.y -= base_pos.w * tex_dx.y;
 
-    int       bindex  = base_pos.x + base->width * base_pos.y;
-    pax_vec2f tex_pos = tex_start;
-    for (int y = base_pos.y; y < base_pos.y + base_pos.h; y++) {
-        for (int x = base_pos.x; x < base_pos.x + base_pos.w; x++) {
+    pax_recti dims = pax_recti_intersect(base_pos, base->clip);
+    if (dims.w <= 0 || dims.h <= 0) {
+        return;
+    }
+
+    PAX_STATS_PIXELS(!assume_opaque, dims.w * dims.h);
+    int bindex = dims.x + base->width * dims.y;
+    for (int y = dims.y; y < dims.y + dims.h; y++) {
+        int       row_y   = y - base_pos.y;
+        int       row_x   = dims.x - base_pos.x;
+        pax_vec2f tex_pos = {
+            tex_start.x + row_y * tex_dy.x + row_x * tex_dx.x,
+            tex_start.y + row_y * tex_dy.y + row_x * tex_dx.y,
+        };
+        for (int x = dims.x; x < dims.x + dims.w; x++) {
             pax_col_t col = scaled_image_get_pixel(top, tex_pos, tget, tbuf2col);
             if (!assume_opaque) {
                 col = pax_col_merge_inlined(bbuf2col(base, bget(base, bindex)), col);
@@ -254,9 +247,7 @@ void pax_swr_scaled_image(
             tex_pos.x += tex_dx.x;
             tex_pos.y += tex_dx.y;
         }
-        bindex    += base->width - base_pos.w;
-        tex_pos.x += tex_dy.x;
-        tex_pos.y += tex_dy.y;
+        bindex += base->width - dims.w;
     }
 }
 
@@ -374,6 +365,8 @@ __attribute__((always_inline)) static inline void swr_blit_impl(
         return;
     }
 
+    PAX_STATS_PIXELS(is_merge, base_pos.w * base_pos.h);
+
     // Determine copying parameters for bottom buffer.
     int base_dy     = base->width - base_pos.w;
     int base_index  = base_pos.x + base->width * base_pos.y;
@@ -521,6 +514,8 @@ __attribute__((always_inline)) static inline void pax_swr_blit_char_impl(
 #if CONFIG_PAX_COMPILE_ORIENTATION
         pos = pax_orient_det_vec2i(buf, pos);
 #endif
+        PAX_STATS_PIXELS(!direct_set, dims.w * dims.h);
+
         // Calculate drawing parameters.
         int bits_dy = rsdata.row_stride << 3;
         int offset  = (pos.x + pos.y * buf->width) + (dims.x * dx + dims.y * dy);
@@ -607,25 +602,32 @@ void pax_swr_text(
 
 // Software rendering functions.
 pax_render_funcs_t const pax_render_funcs_soft = {
-    .background    = pax_swr_background,
-    .unshaded_line = pax_swr_unshaded_line,
-    .unshaded_rect = pax_swr_unshaded_rect,
-    .unshaded_quad = pax_swr_unshaded_quad,
-    .unshaded_tri  = pax_swr_unshaded_tri,
-    .shaded_line   = pax_swr_shaded_line,
-    .shaded_rect   = pax_swr_shaded_rect,
-    .shaded_quad   = pax_swr_shaded_quad,
-    .shaded_tri    = pax_swr_shaded_tri,
-    .scaled_image  = pax_swr_scaled_image,
-    .sprite        = pax_swr_sprite,
-    .blit          = pax_swr_blit,
-    .blit_raw      = pax_swr_blit_raw,
-    .blit_char     = pax_swr_blit_char,
-    .text          = pax_swr_text,
-    .join          = NULL,
+    .background             = pax_swr_background,
+    .unshaded_line          = pax_swr_unshaded_line,
+    .unshaded_rect          = pax_swr_unshaded_rect,
+    .unshaded_quad          = pax_swr_unshaded_quad,
+    .unshaded_tri           = pax_swr_unshaded_tri,
+    .unshaded_quad_aa       = pax_swr_unshaded_quad_aa,
+    .unshaded_tri_aa        = pax_swr_unshaded_tri_aa,
+    .unshaded_poly          = pax_swr_unshaded_poly,
+    .unshaded_ellipse       = pax_swr_unshaded_ellipse,
+    .unshaded_round_rect    = pax_swr_unshaded_round_rect,
+    .unshaded_round_rect_aa = pax_swr_unshaded_round_rect_aa,
+    .shaded_line            = pax_swr_shaded_line,
+    .shaded_rect            = pax_swr_shaded_rect,
+    .shaded_quad            = pax_swr_shaded_quad,
+    .shaded_tri             = pax_swr_shaded_tri,
+    .scaled_image           = pax_swr_scaled_image,
+    .sprite                 = pax_swr_sprite,
+    .blit                   = pax_swr_blit,
+    .blit_raw               = pax_swr_blit_raw,
+    .blit_char              = pax_swr_blit_char,
+    .text                   = pax_swr_text,
+    .join                   = NULL,
 };
 
-static pax_render_funcs_t const *init(void *ignored) {
+static pax_render_funcs_t const *init(void **state, void *ignored) {
+    (void)state;
     (void)ignored;
     return &pax_render_funcs_soft;
 }
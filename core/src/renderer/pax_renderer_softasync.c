@@ -1,22 +1,26 @@
-
 // SPDX-License-Identifier: MIT
 
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+    // For `pthread_attr_setaffinity_np`.
+    #define _GNU_SOURCE
+#endif
+
 #include "renderer/pax_renderer_softasync.h"
 
-#include "helpers/pax_drawing_helpers.h"
 #include "pax_internal.h"
 #include "pax_types.h"
-#include "ptq.h"
 #include "renderer/pax_renderer_soft.h"
-#include "semaphore.h"
 
+#include <math.h>
 #include <sched.h>
 #include <stdbool.h>
+#include <string.h>
 
 #if CONFIG_PAX_USE_FREERTOS
     #include <freertos/FreeRTOS.h>
 #else
     #include <pthread.h>
+    #include <unistd.h>
 #endif
 #include <stdatomic.h>
 
@@ -24,7 +28,7 @@
 
 // Enable the asynchronous renderer.
 // If `multithreaded` is `true` and `CONFIG_PAX_COMPILE_ASYNC_RENDERER` is set to `2`,
-// This will use two threads for rendering instead of just one.
+// This will use one thread per CPU core for rendering instead of just one.
 void pax_set_renderer_async(bool multithreaded) {
     PAX_LOGE(
         "pax-sasr",
@@ -32,1084 +36,1410 @@ void pax_set_renderer_async(bool multithreaded) {
     );
 }
 
+// Enable the asynchronous renderer with a specific number of worker threads.
+// If `workers` is less than 1, one worker is started per CPU core.
+void pax_set_renderer_async_workers(int workers) {
+    PAX_LOGE(
+        "pax-sasr",
+        "Async renderer is not compiled in, please define CONFIG_PAX_COMPILE_ASYNC_RENDERER to be 1 or 2."
+    );
+}
+
+// Get the arena statistics of a render context.
+// Returns `false` if `ctx` does not use the async renderer.
+bool pax_sasr_get_arena_stats(pax_render_ctx_t const *ctx, pax_sasr_arena_stats_t *out) {
+    return false;
+}
+
 #else
 
 // Enable the asynchronous renderer.
 // If `multithreaded` is `true` and `CONFIG_PAX_COMPILE_ASYNC_RENDERER` is set to `2`,
-// This will use two threads for rendering instead of just one.
+// This will use one thread per CPU core for rendering instead of just one.
 void pax_set_renderer_async(bool multithreaded) {
-    pax_set_renderer(&pax_render_engine_softasync, (void *)multithreaded);
+    pax_sasr_config_t config = {.workers = multithreaded ? -1 : 1};
+    pax_set_renderer(&pax_render_engine_softasync, &config);
 }
 
-// Args for software async renderer.
-typedef struct {
-    ptq_queue_t               queue;
-    pax_render_funcs_t const *renderfuncs;
-} pax_sasr_worker_args_t;
-
-
-
-static bool is_multithreaded;
-
-static pax_sasr_worker_args_t args0;
+// Enable the asynchronous renderer with a specific number of worker threads.
+// If `workers` is less than 1, one worker is started per CPU core.
+void pax_set_renderer_async_workers(int workers) {
+    pax_sasr_config_t config = {.workers = workers < 1 ? -1 : workers};
+    pax_set_renderer(&pax_render_engine_softasync, &config);
+}
 
-    #if CONFIG_PAX_COMPILE_ASYNC_RENDERER == 2
-static pax_sasr_worker_args_t args1;
+    #if defined(__linux__) && !CONFIG_PAX_USE_FREERTOS
+        // Whether worker threads can be pinned to a set of CPUs.
+        #define PAX_SASR_HAS_AFFINITY 1
+    #else
+        // Whether worker threads can be pinned to a set of CPUs.
+        #define PAX_SASR_HAS_AFFINITY 0
     #endif
 
-static pthread_mutex_t joinmtx;
-
-// Queue a draw call.
-static void pax_sasr_queue(pax_task_t *task);
-
-    #if CONFIG_PAX_USE_FREERTOS
-// Worker thread function for software async renderer.
-static void pax_sasr_worker(void *_args);
+// Assumed size of a cache line, used to keep data written by different threads apart.
+    #define PAX_SASR_CACHE_LINE    64
+// Number of times a worker polls for tasks before going to sleep.
+    #define PAX_SASR_SPIN_COUNT    64
+// Maximum number of tasks a worker takes from one render context before checking the others.
+    #define PAX_SASR_BATCH_SIZE    32
+// Number of glyphs per chunk of the glyph run of a long string.
+    #define PAX_SASR_GLYPH_RUN_CAP 32
+// Alignment of allocations from a render context's arena.
+    #define PAX_SASR_ARENA_ALIGN   16
+// Size in bytes of each lane's command ring; room for at least `CONFIG_PAX_QUEUE_SIZE` of the largest tasks.
+    #define PAX_SASR_RING_SIZE                                                                                         \
+        ((CONFIG_PAX_QUEUE_SIZE * sizeof(pax_task_t) + PAX_SASR_CACHE_LINE - 1) & ~(size_t)(PAX_SASR_CACHE_LINE - 1))
+// Maximum number of lanes each render context can have.
+    #define PAX_SASR_MAX_LANES     (CONFIG_PAX_ASYNC_MAX_WORKERS * CONFIG_PAX_ASYNC_BANDS_PER_WORKER)
+// Alignment and size granularity of commands in a lane's ring.
+    #define PAX_SASR_CMD_ALIGN     8
+    #if CONFIG_PAX_USE_FIXED_POINT && !(CONFIG_PAX_USE_LONG_FIXED_POINT && defined(__SIZEOF_INT128__))
+// Largest coordinate the rectangle filler handles without overflowing its 12 integer bits of fixed point.
+        #define PAX_SASR_COORD_MAX 2047
+    #elif CONFIG_PAX_USE_FIXED_POINT
+// Largest coordinate the rectangle filler handles without overflowing its 16 integer bits of fixed point.
+        #define PAX_SASR_COORD_MAX 32767
     #else
-// Worker thread function for software async renderer.
-static void *pax_sasr_worker(void *_args);
+// Largest coordinate the rectangle filler handles without losing integer precision.
+        #define PAX_SASR_COORD_MAX 16777216
     #endif
 
-// Number of completions that still need to happen.
-static atomic_int outstanding;
-// Semaphore posted every time a piece of work finishes.
-static sem_t      complete_sem;
-
-// Initialize the async renderer.
-static pax_render_funcs_t const *pax_sasr_init(void *arg) {
-    sem_init(&complete_sem, 0, 0);
-    outstanding = 0;
-    pthread_mutex_init(&joinmtx, NULL);
-
-    args0.queue       = ptq_create_max(sizeof(pax_task_t), CONFIG_PAX_QUEUE_SIZE);
-    args0.renderfuncs = &pax_render_funcs_soft;
+// The command uses a shader.
+    #define PAX_SASR_CMD_SHADED 0x01
+// The command is followed by a new shader; otherwise it uses the same shader as the previous shaded command.
+    #define PAX_SASR_CMD_SHADER 0x02
+// The command is padding up to the end of the ring and should be skipped.
+    #define PAX_SASR_CMD_PAD    0x04
+// The command was hidden by a later opaque command before it was published; only its shader is used.
+    #define PAX_SASR_CMD_HIDDEN 0x08
+// The command is an unshaded triangle or quad with anti-aliased edges.
+    #define PAX_SASR_CMD_AA     0x10
+
+// Header of a command in a lane's ring.
+// It is followed by the part of the task's shape data that its type uses and then by the shader, if any.
+typedef struct {
+    // Task type; a `pax_task_type_t`.
+    uint8_t    type;
+    // Bitwise OR of `PAX_SASR_CMD_*` flags.
+    uint8_t    flags;
+    // Size of the entire command in bytes; a multiple of `PAX_SASR_CMD_ALIGN`.
+    uint16_t   size;
+    // Color to use.
+    pax_col_t  color;
+    // The buffer to apply this task to.
+    pax_buf_t *buffer;
+    // Bounds of the task, already intersected with the clip rectangle.
+    pax_recti  bounds;
+} pax_sasr_cmd_t;
+
+// A block of memory in a render context's arena.
+typedef struct pax_sasr_block pax_sasr_block_t;
+struct pax_sasr_block {
+    // Next block of the arena.
+    pax_sasr_block_t *next;
+    // Size of `data` in bytes.
+    size_t            size;
+    // Number of bytes of `data` allocated so far.
+    size_t            used;
+    // The fence after which the data in this block is no longer needed; 0 while it may still be allocated from.
+    uint64_t          fence;
+    // Block data.
+    _Alignas(PAX_SASR_ARENA_ALIGN) uint8_t data[];
+};
 
-    #if CONFIG_PAX_COMPILE_ASYNC_RENDERER == 2
-    is_multithreaded = arg;
-    if (is_multithreaded) {
-        args0.renderfuncs = &pax_render_funcs_mcr_thread0;
-        args1.renderfuncs = &pax_render_funcs_mcr_thread1;
-        args1.queue       = ptq_create_max(sizeof(pax_task_t), CONFIG_PAX_QUEUE_SIZE);
-        #if CONFIG_PAX_USE_FREERTOS
-        TaskHandle_t dummy_handle;
-        xTaskCreatePinnedToCore(pax_sasr_worker, "MCRW1", 4096, &args1, 1, &dummy_handle, 1);
-        #else
-        pthread_t handle;
-        pthread_create(&handle, NULL, pax_sasr_worker, &args1);
-        pthread_detach(handle);
-        #endif
+// Bump allocator for the data tasks point to, so the workers never need to free anything.
+// Blocks are retired by the next fence and reused once it completes; `pax_sasr_join` reuses all of them at once.
+typedef struct {
+    // Guards everything except `producers`.
+    pthread_mutex_t   mtx;
+    // Number of threads between allocating from the arena and queueing the tasks that use the allocation.
+    atomic_int        producers;
+    // All blocks.
+    pax_sasr_block_t *blocks;
+    // Block allocations are currently made from.
+    pax_sasr_block_t *current;
+    // Arena statistics.
+    pax_sasr_arena_stats_t stats;
+} pax_sasr_arena_t;
+
+// A fence that has been inserted into every lane of a render context.
+typedef struct {
+    // Number of lanes that have yet to reach the fence; the slot is free when this is 0.
+    atomic_int     remaining;
+    // Fence number.
+    uint64_t       seq;
+    // Called by the worker that passes the fence in the last lane to reach it.
+    pax_fence_cb_t callback;
+    // Argument passed to `callback`.
+    void          *cookie;
+} pax_sasr_fence_t;
+
+// Tasks of one render context for one worker, stored as a stream of variable-length commands.
+typedef struct {
+    // Ring of `PAX_SASR_RING_SIZE` bytes that commands are written to.
+    uint8_t     *ring;
+    // The shader most recently written to the ring; guarded by the queue mutex.
+    pax_shader_t last_shader;
+    // Whether `last_shader` is valid.
+    bool         has_shader;
+    // Commands before this byte read from a buffer, so they are never hidden; guarded by the queue mutex.
+    size_t       barrier;
+    // Number of bytes published to the workers so far.
+    _Alignas(PAX_SASR_CACHE_LINE) atomic_size_t head;
+    // Number of bytes written by producers so far; ahead of `head` while a deferred context holds commands back.
+    atomic_size_t written;
+    // Number of bytes of commands finished by workers so far.
+    _Alignas(PAX_SASR_CACHE_LINE) atomic_size_t tail;
+    // Whether a worker is running this lane's tasks; only that worker may read from the lane.
+    atomic_bool  busy;
+    // The shader used by the most recently read shaded command; only accessed by the worker running the lane.
+    pax_shader_t shader;
+} pax_sasr_lane_t;
+
+// State of a render context using the software async renderer.
+// Contexts are kept by the worker pool after they are destroyed and reused by the next one.
+typedef struct {
+    // One lane per worker in the pool.
+    pax_sasr_lane_t *lanes;
+    // Whether a render context currently uses this; guarded by the pool mutex.
+    bool             in_use;
+    // Mutex and condition used by `pax_sasr_join` to wait for the workers.
+    pthread_mutex_t  joinmtx;
+    pthread_cond_t   joincond;
+    // Number of threads waiting in `pax_sasr_join`.
+    atomic_int       join_waiting;
+    // Memory that task data is allocated from.
+    pax_sasr_arena_t arena;
+    // Guards writing to the lanes, so that every lane receives tasks and fences in the same order.
+    pthread_mutex_t  queuemtx;
+    // Whether tasks are held back until the next join or fence, see `pax_sasr_config_t`.
+    bool             deferred;
+    // Number of fences inserted so far.
+    size_t           n_fences;
+    // Number of the most recent fence that has completed; fences complete in the order they are inserted.
+    _Atomic uint64_t fence_done;
+    // Slots for the fences that have not completed yet.
+    pax_sasr_fence_t fences[CONFIG_PAX_QUEUE_SIZE];
+} pax_sasr_t;
+
+// A glyph run being built by `pax_sasr_text`.
+typedef struct {
+    // The buffer the text is drawn to.
+    pax_buf_t const *buf;
+    // The render context whose arena the glyphs are allocated from.
+    pax_sasr_t      *sasr;
+    // The first chunk of glyphs; NULL if out of memory.
+    pax_glyph_run_t *run;
+    // The chunk glyphs are currently added to.
+    pax_glyph_run_t *tail;
+    // Number of glyphs `tail` has room for.
+    uint32_t         cap;
+    // Bounds of the glyphs so far.
+    pax_vec2f        min, max;
+} pax_sasr_layout_t;
+
+// State of a single software async renderer worker.
+typedef struct {
+    // Index of this worker; it owns the bands whose index is equal to this modulo the number of workers.
+    int             index;
+    // Whether the worker is waiting on `cond` for new tasks.
+    atomic_bool     sleeping;
+    // Mutex and condition used to wake the worker up when it is sleeping.
+    pthread_mutex_t mtx;
+    pthread_cond_t  cond;
+} pax_sasr_worker_t;
+
+
+
+// Guards the worker pool's lifetime and the `in_use` flag of contexts.
+static pthread_mutex_t pool_mtx  = PTHREAD_MUTEX_INITIALIZER;
+// Signalled when a worker stops.
+static pthread_cond_t  pool_cond = PTHREAD_COND_INITIALIZER;
+// Number of render contexts using the worker pool; the pool is stopped when this reaches 0.
+static int             pool_refs;
+// Number of worker threads that have not stopped yet; guarded by `pool_mtx`.
+static int             pool_running;
+// Whether `pax_sasr_pool_stop` is waiting for the workers; guarded by `pool_mtx`.
+static bool            pool_stopping;
+// Tells the workers to stop once they are out of tasks.
+static atomic_bool     pool_stop;
+
+// Number of worker threads.
+static int                n_workers;
+// Number of bands of rows buffers are split into; every render context has one lane of tasks per band.
+// Each worker owns several bands spread over the buffer and helps out with the bands of other workers when idle,
+// so a worker that is slow or descheduled holds up at most the band it is running.
+static int                n_lanes;
+// Worker thread states.
+static pax_sasr_worker_t *workers;
+// Number of the most recent fence inserted into any render context.
+// Fence numbers are never reused, so fences of a context that has been deinitialized are never confused with
+// the fences of the next context to use the same state.
+static _Atomic uint64_t   fence_seq;
+// Render contexts known to the workers; only the first `n_contexts` are valid.
+static pax_sasr_t        *contexts[CONFIG_PAX_ASYNC_MAX_CONTEXTS];
+// Number of valid entries in `contexts`.
+static atomic_int         n_contexts;
+
+// Get the render context state that draw calls to `buf` go to.
+static inline pax_sasr_t *pax_sasr_get(pax_buf_t const *buf) {
+    return pax_get_render_ctx(buf)->state;
+}
+
+// Initialize a render context's arena.
+static void pax_sasr_arena_init(pax_sasr_arena_t *arena) {
+    pthread_mutex_init(&arena->mtx, NULL);
+    atomic_init(&arena->producers, 0);
+    arena->blocks  = NULL;
+    arena->current = NULL;
+    arena->stats   = (pax_sasr_arena_stats_t){0};
+}
+
+// Free all memory held by a render context's arena and clear its statistics.
+// There may not be any tasks left that use it.
+static void pax_sasr_arena_clear(pax_sasr_arena_t *arena) {
+    pax_sasr_block_t *block = arena->blocks;
+    while (block) {
+        pax_sasr_block_t *next = block->next;
+        free(block);
+        block = next;
     }
-    #else
-    if (is_multithreaded) {
-        PAX_LOGW(
-            "pax-sasr",
-            "Async renderer is compiled in single-threaded mode; please define CONFIG_PAX_COMPILE_ASYNC_RENDERER to be "
-            "2 to use multithreaded mode."
-        );
+    arena->blocks  = NULL;
+    arena->current = NULL;
+    arena->stats   = (pax_sasr_arena_stats_t){0};
+}
+
+// Find a block with room for `size` bytes that is not in use, or allocate a new one.
+// Must be called with the arena mutex held.
+static pax_sasr_block_t *pax_sasr_arena_block(pax_sasr_t *sasr, size_t size) {
+    pax_sasr_arena_t *arena = &sasr->arena;
+    uint64_t          done  = atomic_load_explicit(&sasr->fence_done, memory_order_acquire);
+    for (pax_sasr_block_t *block = arena->blocks; block; block = block->next) {
+        bool unused = block->fence ? block->fence <= done : !block->used;
+        if (block != arena->current && unused && block->size >= size) {
+            block->used  = 0;
+            block->fence = 0;
+            return block;
+        }
     }
-    #endif
 
-    #if CONFIG_PAX_USE_FREERTOS
-    TaskHandle_t dummy_handle;
-    xTaskCreatePinnedToCore(pax_sasr_worker, "MCRW0", 4096, &args0, 1, &dummy_handle, 0);
-    #else
-    pthread_t handle;
-    pthread_create(&handle, NULL, pax_sasr_worker, &args0);
-    pthread_detach(handle);
-    #endif
-
-    return &pax_render_funcs_softasync;
-}
-
-// Deinitialize the async renderer.
-static void pax_sasr_deinit() {
-    pax_task_t task = {
-        .type = PAX_TASK_STOP,
-    };
-    pax_sasr_queue(&task);
-    pax_sasr_join();
-    #if CONFIG_PAX_COMPILE_ASYNC_RENDERER == 2
-    if (is_multithreaded) {
-        ptq_destroy(args1.queue);
+    // Allocations bigger than a block get one of their own.
+    size_t            cap   = size > CONFIG_PAX_ASYNC_ARENA_BLOCK ? size : CONFIG_PAX_ASYNC_ARENA_BLOCK;
+    pax_sasr_block_t *block = malloc(sizeof(pax_sasr_block_t) + cap);
+    if (!block) {
+        return NULL;
+    }
+    block->next            = arena->blocks;
+    block->size            = cap;
+    block->used            = 0;
+    block->fence           = 0;
+    arena->blocks          = block;
+    arena->stats.capacity += cap;
+    return block;
+}
+
+// Allocate memory that lives until the next fence completes or the render context is joined.
+// Returns NULL if out of memory.
+static void *pax_sasr_arena_alloc(pax_sasr_t *sasr, size_t size) {
+    pax_sasr_arena_t *arena = &sasr->arena;
+    size                    = (size + PAX_SASR_ARENA_ALIGN - 1) & ~(size_t)(PAX_SASR_ARENA_ALIGN - 1);
+    pthread_mutex_lock(&arena->mtx);
+
+    pax_sasr_block_t *block = arena->current;
+    if (!block || block->used + size > block->size) {
+        block = pax_sasr_arena_block(sasr, size);
+        if (!block) {
+            pthread_mutex_unlock(&arena->mtx);
+            return NULL;
+        }
+        arena->current = block;
     }
-    #endif
-    ptq_destroy(args0.queue);
-    sem_destroy(&complete_sem);
-    pthread_mutex_destroy(&joinmtx);
-}
-
 
-// Queue a draw call.
-static void pax_sasr_queue(pax_task_t *task) {
-    atomic_fetch_add_explicit(&outstanding, 1 + is_multithreaded, memory_order_relaxed);
-    ptq_send_block(args0.queue, task, NULL);
-    #if CONFIG_PAX_COMPILE_ASYNC_RENDERER == 2
-    if (is_multithreaded) {
-        ptq_send_block(args1.queue, task, NULL);
+    void *mem          = block->data + block->used;
+    block->used       += size;
+    arena->stats.used += size;
+    if (arena->stats.used > arena->stats.peak) {
+        arena->stats.peak = arena->stats.used;
     }
-    #endif
+    pthread_mutex_unlock(&arena->mtx);
+    return mem;
+}
+
+// Retire the blocks allocated from since the last fence, so they can be reused once fence `seq` completes.
+// Must be called before the fence is queued.
+static void pax_sasr_arena_retire(pax_sasr_t *sasr, uint64_t seq) {
+    pax_sasr_arena_t *arena = &sasr->arena;
+    pthread_mutex_lock(&arena->mtx);
+    // Memory allocated by a producer that is still busy may be used by tasks queued after the fence.
+    if (!atomic_load(&arena->producers)) {
+        for (pax_sasr_block_t *block = arena->blocks; block; block = block->next) {
+            if (block->used && !block->fence) {
+                block->fence = seq;
+            }
+        }
+        arena->current           = NULL;
+        arena->stats.last_frame  = arena->stats.used;
+        arena->stats.used        = 0;
+        arena->stats.frames     += 1;
+    }
+    pthread_mutex_unlock(&arena->mtx);
+}
+
+// Shrink an allocation from the arena, if it is the most recent one.
+static void pax_sasr_arena_shrink(pax_sasr_arena_t *arena, void *mem, size_t size, size_t new_size) {
+    size     = (size + PAX_SASR_ARENA_ALIGN - 1) & ~(size_t)(PAX_SASR_ARENA_ALIGN - 1);
+    new_size = (new_size + PAX_SASR_ARENA_ALIGN - 1) & ~(size_t)(PAX_SASR_ARENA_ALIGN - 1);
+    pthread_mutex_lock(&arena->mtx);
+    pax_sasr_block_t *block = arena->current;
+    if (block && (uint8_t *)mem + size == block->data + block->used) {
+        block->used       -= size - new_size;
+        arena->stats.used -= size - new_size;
+    }
+    pthread_mutex_unlock(&arena->mtx);
 }
 
     #if CONFIG_PAX_USE_FREERTOS
 // Worker thread function for software async renderer.
-static void pax_sasr_worker(void *_args)
+static void pax_sasr_worker(void *_args);
     #else
 // Worker thread function for software async renderer.
-static void *pax_sasr_worker(void *_args)
+static void *pax_sasr_worker(void *_args);
     #endif
-{
-    pax_sasr_worker_args_t *args = _args;
-
-    while (1) {
-        pax_task_t task;
-        ptq_receive_block(args->queue, &task, NULL);
-        atomic_thread_fence(memory_order_acquire);
 
-        if (task.type == PAX_TASK_STOP) {
-            sem_post(&complete_sem);
+// Get the number of CPU cores available for rendering.
+static int pax_sasr_cpu_count() {
     #if CONFIG_PAX_USE_FREERTOS
-            vTaskDelete(NULL);
+    return portNUM_PROCESSORS;
     #else
-            return NULL;
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? count : 1;
     #endif
-        } else if (task.type == PAX_TASK_BACKGROUND) {
-            args->renderfuncs->background(task.buffer, task.color);
-        } else if (task.type == PAX_TASK_QUAD) {
-            if (task.use_shader) {
-                args->renderfuncs->shaded_quad(task.buffer, task.color, task.quadf.shape, &task.shader, task.quadf.uvs);
-            } else {
-                args->renderfuncs->unshaded_quad(task.buffer, task.color, task.quadf.shape);
-            }
-        } else if (task.type == PAX_TASK_RECT) {
-            if (task.use_shader) {
-                args->renderfuncs->shaded_rect(task.buffer, task.color, task.rectf.shape, &task.shader, task.rectf.uvs);
-            } else {
-                args->renderfuncs->unshaded_rect(task.buffer, task.color, task.rectf.shape);
-            }
-        } else if (task.type == PAX_TASK_TRI) {
-            if (task.use_shader) {
-                args->renderfuncs->shaded_tri(task.buffer, task.color, task.trif.shape, &task.shader, task.trif.uvs);
-            } else {
-                args->renderfuncs->unshaded_tri(task.buffer, task.color, task.trif.shape);
-            }
-        } else if (task.type == PAX_TASK_LINE) {
-            if (task.use_shader) {
-                args->renderfuncs->shaded_line(task.buffer, task.color, task.linef.shape, &task.shader, task.linef.uvs);
-            } else {
-                args->renderfuncs->unshaded_line(task.buffer, task.color, task.linef.shape);
-            }
-        } else if (task.type == PAX_TASK_SPRITE) {
-            args->renderfuncs
-                ->sprite(task.buffer, task.blit.top, task.blit.base_pos, task.blit.top_orientation, task.blit.top_pos);
-        } else if (task.type == PAX_TASK_BLIT) {
-            args->renderfuncs
-                ->blit(task.buffer, task.blit.top, task.blit.base_pos, task.blit.top_orientation, task.blit.top_pos);
-        } else if (task.type == PAX_TASK_BLIT_RAW) {
-            args->renderfuncs->blit_raw(
-                task.buffer,
-                task.blit.top,
-                task.blit.top_dims,
-                task.blit.base_pos,
-                task.blit.top_orientation,
-                task.blit.top_pos
-            );
-        } else if (task.type == PAX_TASK_BLIT_CHAR) {
-            args->renderfuncs
-                ->blit_char(task.buffer, task.color, task.blit_char.pos, task.blit_char.scale, task.blit_char.rsdata);
-        } else if (task.type == PAX_TASK_TEXT) {
-            args->renderfuncs->text(
-                task.buffer,
-                task.text_matrix,
-                task.color,
-                task.text.font,
-                task.text.font_size,
-                task.text.pos,
-                task.text.str.len > PAX_SSO_BUF_LEN ? task.text.str.ptr->data : task.text.str.sso,
-                task.text.str.len,
-                task.text.halign,
-                task.text.valign,
-                task.text.cursorpos
-            );
-            if (task.text.str.len > PAX_SSO_BUF_LEN) {
-                if (atomic_fetch_sub_explicit(&task.text.str.ptr->refcount, 1, memory_order_relaxed) == 1) {
-                    free(task.text.str.ptr);
-                }
-            }
-        } else if (task.type == PAX_TASK_SCALED_IMAGE) {
-            args->renderfuncs->scaled_image(
-                task.buffer,
-                task.scaled_image.top,
-                task.scaled_image.base_pos,
-                task.scaled_image.top_orientation,
-                task.scaled_image.assume_opaque
-            );
-        }
-
-        sem_post(&complete_sem);
-    }
 }
 
-
-    #if CONFIG_PAX_COMPILE_ASYNC_RENDERER == 2
-
-// Background fill.
-static void pax_sasr_background_impl(bool odd_scanline, pax_buf_t *buf, pax_col_t color) {
-    uint32_t value;
-    if (buf->type_info.fmt_type == PAX_BUF_SUBTYPE_PALETTE) {
-        if (color > buf->palette_size)
-            value = 0;
-        else
-            value = color;
-    } else {
-        value = buf->col2buf(buf, color);
-    }
-
-    pax_range_setter_t setter = buf->range_setter;
-    int                width  = buf->width;
-    int                height = buf->height;
-    for (int row = odd_scanline; row < height; row += 2) {
-        setter(buf, value, row * width, width);
-    }
-}
-
-// Read a single pixel from a raw buffer type by index.
-__attribute__((always_inline)) static inline pax_col_t raw_get_pixel(void const *buf, uint8_t bpp, int index) {
-    uint8_t const  *buf_8bpp  = buf;
-    uint16_t const *buf_16bpp = buf;
-    uint32_t const *buf_32bpp = buf;
-    switch (bpp) {
-        case 1: return (buf_8bpp[index / 8] >> ((index % 8) * 1)) & 0x01;
-        case 2: return (buf_8bpp[index / 4] >> ((index % 4) * 2)) & 0x03;
-        case 4: return (buf_8bpp[index / 2] >> ((index % 2) * 4)) & 0x0f;
-        case 8: return buf_8bpp[index];
-        case 16: return buf_16bpp[index];
-        #if BYTE_ORDER == LITTLE_ENDIAN
-        case 24: return buf_8bpp[index * 3] | (buf_8bpp[index * 3 + 1] << 8) | (buf_8bpp[index * 3 + 2] << 16);
-        #else
-        case 24: return buf_8bpp[index * 3 + 2] | (buf_8bpp[index * 3 + 1] << 8) | (buf_8bpp[index * 3] << 16);
-        #endif
-        case 32: return buf_32bpp[index];
-        default: __builtin_unreachable();
+// Get the CPU affinity mask of a worker; 0 if it may run on any CPU.
+static uint64_t pax_sasr_affinity(pax_sasr_config_t const *config, int index) {
+    if (!config->affinity || !config->n_affinity) {
+        return 0;
     }
+    return config->affinity[index % config->n_affinity];
 }
 
-// Perform a buffer copying operation.
-__attribute__((always_inline)) static inline void sasr_blit_impl_2(
-    bool              odd_scanline,
-    pax_buf_t        *base,
-    void const       *top,
-    pax_vec2i         top_dims,
-    pax_recti         base_pos,
-    pax_orientation_t top_orientation,
-    pax_vec2i         top_pos,
-    bool              is_merge,
-    bool              is_raw_buf,
-    bool              is_pal_buf
-) {
-        // Clipping: dimensions of top buffer.
-        #if CONFIG_PAX_COMPILE_ORIENTATION
-    if (top_orientation & 1) {
-        // Flip X and Y before size check.
-        if (base_pos.w > top_dims.y) {
-            base_pos.w = top_dims.y;
-        }
-        if (base_pos.h > top_dims.x) {
-            base_pos.h = top_dims.x;
-        }
-    } else
-        #endif
-    {
-        if (base_pos.w > top_dims.x) {
-            base_pos.w = top_dims.x;
-        }
-        if (base_pos.h > top_dims.y) {
-            base_pos.h = top_dims.y;
-        }
+// Start the thread of a worker with the settings in `config`, falling back to the defaults if they can't be applied.
+// Returns whether the thread was started.
+static bool pax_sasr_spawn(pax_sasr_worker_t *worker, pax_sasr_config_t const *config) {
+    uint64_t affinity = pax_sasr_affinity(config, worker->index);
+    #if CONFIG_PAX_USE_FREERTOS
+    char name[8];
+    snprintf(name, sizeof(name), "MCRW%d", worker->index);
+    // FreeRTOS tasks can only be pinned to one core, so the lowest one in the mask is used.
+    BaseType_t core = worker->index % portNUM_PROCESSORS;
+    if (affinity) {
+        core = __builtin_ctzll(affinity) < portNUM_PROCESSORS ? __builtin_ctzll(affinity) : tskNO_AFFINITY;
     }
-
-        // Determine copying parameters for top buffer.
-        #if CONFIG_PAX_COMPILE_ORIENTATION
-    // clang-format off
-    int dx = 0, dy = 0;
-    bool swap = false;
-    int top_dx, top_dy, top_index;
-    pax_vec2i top_pos0 = top_pos;
-    switch (top_orientation & 7) {
-        case PAX_O_UPRIGHT:         top_pos.x =              top_pos0.x; top_pos.y =              top_pos0.y; break;
-        case PAX_O_ROT_CCW:         top_pos.y =              top_pos0.y; top_pos.x = top_dims.x-1-top_pos0.x; break;
-        case PAX_O_ROT_HALF:        top_pos.x = top_dims.x-1-top_pos0.x; top_pos.y = top_dims.y-1-top_pos0.y; break;
-        case PAX_O_ROT_CW:          top_pos.y = top_dims.y-1-top_pos0.y; top_pos.x =              top_pos0.x; break;
-        case PAX_O_FLIP_H:          top_pos.x = top_dims.x-1-top_pos0.x; top_pos.y =              top_pos0.y; break;
-        case PAX_O_ROT_CCW_FLIP_H:  top_pos.y = top_dims.y-1-top_pos0.y; top_pos.x = top_dims.x-1-top_pos0.x; break;
-        case PAX_O_ROT_HALF_FLIP_H: top_pos.x =              top_pos0.x; top_pos.y = top_dims.y-1-top_pos0.y; break;
-        case PAX_O_ROT_CW_FLIP_H:   top_pos.y =              top_pos0.y; top_pos.x =              top_pos0.x; break;
-    }
-    switch (top_orientation & 7) {
-        case PAX_O_UPRIGHT:         dx =  1; dy =  1; swap = false; break;
-        case PAX_O_ROT_CCW:         dx =  1; dy = -1; swap = true;  break;
-        case PAX_O_ROT_HALF:        dx = -1; dy = -1; swap = false; break;
-        case PAX_O_ROT_CW:          dx = -1; dy =  1; swap = true;  break;
-        case PAX_O_FLIP_H:          dx = -1; dy =  1; swap = false; break;
-        case PAX_O_ROT_CCW_FLIP_H:  dx = -1; dy = -1; swap = true;  break;
-        case PAX_O_ROT_HALF_FLIP_H: dx =  1; dy = -1; swap = false; break;
-        case PAX_O_ROT_CW_FLIP_H:   dx =  1; dy =  1; swap = true;  break;
-    }
-    // clang-format on
-    if (swap) {
-        top_dx = top_dims.x * dx;
-        top_dy = dy;
-    } else {
-        top_dx = dx;
-        top_dy = top_dims.x * dy;
+    TaskHandle_t dummy_handle;
+    return xTaskCreatePinnedToCore(
+               pax_sasr_worker,
+               name,
+               config->stack_size ? config->stack_size : 4096,
+               worker,
+               config->set_sched ? config->priority : 1,
+               &dummy_handle,
+               core
+           )
+           == pdPASS;
+    #else
+    pthread_attr_t attr;
+    int            res = pthread_attr_init(&attr);
+    if (!res) {
+        res = pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
     }
-    top_index = top_pos.x + top_pos.y * top_dims.x;
-        #else
-    int top_dx    = 1;
-    int top_dy    = top_dims.x;
-    int top_index = top_pos.x + top_dims.x * top_pos.y;
-        #endif
-
-    // Clipping: clip rect of bottom buffer.
-    if (base_pos.x < base->clip.x) {
-        top_index  += top_dx * (base->clip.x - base_pos.x);
-        base_pos.w -= base->clip.x - base_pos.x;
-        base_pos.x  = base->clip.x;
+    if (!res && config->stack_size) {
+        res = pthread_attr_setstacksize(&attr, config->stack_size);
     }
-    if (base_pos.x + base_pos.w > base->clip.x + base->clip.w) {
-        base_pos.w = base->clip.x + base->clip.w - base_pos.x;
+    if (!res && config->set_sched) {
+        struct sched_param param = {.sched_priority = config->priority};
+        res                      = pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+        res                      = res ? res : pthread_attr_setschedpolicy(&attr, config->policy);
+        res                      = res ? res : pthread_attr_setschedparam(&attr, &param);
     }
-    if (base_pos.y < base->clip.y) {
-        top_index  += top_dy * (base->clip.y - base_pos.y);
-        base_pos.h -= base->clip.y - base_pos.y;
-        base_pos.y  = base->clip.y;
+        #if PAX_SASR_HAS_AFFINITY
+    if (!res && affinity) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu = 0; cpu < 64; cpu++) {
+            if (affinity & ((uint64_t)1 << cpu)) {
+                CPU_SET(cpu, &set);
+            }
+        }
+        res = pthread_attr_setaffinity_np(&attr, sizeof(set), &set);
     }
-    if (base_pos.y + base_pos.h > base->clip.y + base->clip.h) {
-        base_pos.h = base->clip.y + base->clip.h - base_pos.y;
+        #else
+    if (affinity && worker->index == 0) {
+        PAX_LOGW("pax-sasr", "Pinning worker threads to CPUs is not supported on this platform");
     }
+        #endif
 
-    if (base_pos.h <= 0 || base_pos.w <= 0) {
-        return;
+    pthread_t handle;
+    if (!res) {
+        res = pthread_create(&handle, &attr, pax_sasr_worker, worker);
     }
-
-    // Determine copying parameters for bottom buffer.
-    int base_dy    = base->width * 2 - base_pos.w;
-    int base_index = base_pos.x + base->width * base_pos.y;
-
-    int y = base_pos.y;
-    if ((y & 1) != odd_scanline) {
-        base_index += base->width;
-        top_index  += top_dy;
-        y++;
-    }
-    top_dy *= 2;
-    top_dy -= base_pos.w * top_dx;
-    for (; y < base_pos.y + base_pos.h; y += 2) {
-        for (int x = base_pos.x; x < base_pos.x + base_pos.w; x++) {
-            if (is_merge) {
-                pax_buf_t const *_top     = top;
-                pax_col_t        base_col = base->buf2col(base, base->getter(base, base_index));
-                pax_col_t        top_col  = _top->buf2col(_top, _top->getter(_top, top_index));
-                base->setter(base, base->col2buf(base, pax_col_merge(base_col, top_col)), base_index);
-            } else if (is_raw_buf) {
-                pax_col_t col = raw_get_pixel(top, base->type_info.bpp, top_index);
-                base->setter(base, col, base_index);
-            } else if (is_pal_buf) {
-                pax_buf_t const *_top = top;
-                pax_col_t        col  = _top->getter(_top, top_index);
-                base->setter(base, pax_closest_in_palette(base->palette, base->palette_size, col), base_index);
-            } else {
-                pax_buf_t const *_top = top;
-                pax_col_t        col  = _top->buf2col(_top, _top->getter(_top, top_index));
-                base->setter(base, base->col2buf(base, col), base_index);
-            }
-            base_index += 1;
-            top_index  += top_dx;
-        }
-        base_index += base_dy;
-        top_index  += top_dy;
+    pthread_attr_destroy(&attr);
+    if (!res) {
+        return true;
     }
-}
 
-// Draw a sprite; like a blit, but use color blending if applicable.
-static void pax_sasr_sprite_impl(
-    bool              odd_scanline,
-    pax_buf_t        *base,
-    pax_buf_t const  *top,
-    pax_recti         base_pos,
-    pax_orientation_t top_orientation,
-    pax_vec2i         top_pos
-) {
-    sasr_blit_impl_2(
-        odd_scanline,
-        base,
-        top,
-        (pax_vec2i){top->width, top->height},
-        base_pos,
-        top_orientation,
-        top_pos,
-        1,
-        0,
-        0
+    PAX_LOGW(
+        "pax-sasr",
+        "Can't start worker %d with the requested settings (%s); using the defaults",
+        worker->index,
+        strerror(res)
     );
+    if (pthread_create(&handle, NULL, pax_sasr_worker, worker)) {
+        return false;
+    }
+    pthread_detach(handle);
+    return true;
+    #endif
 }
 
-// Perform a buffer copying operation with an unmanaged user buffer.
-__attribute__((noinline)) static void pax_sasr_blit_raw_impl(
-    bool              odd_scanline,
-    pax_buf_t        *base,
-    void const       *top,
-    pax_vec2i         top_dims,
-    pax_recti         base_pos,
-    pax_orientation_t top_orientation,
-    pax_vec2i         top_pos
-) {
-    sasr_blit_impl_2(odd_scanline, base, top, top_dims, base_pos, top_orientation, top_pos, false, true, false);
-}
-
-// Perform a buffer copying operation with a PAX buffer.
-static void pax_sasr_blit_impl(
-    bool              odd_scanline,
-    pax_buf_t        *base,
-    pax_buf_t const  *top,
-    pax_recti         base_pos,
-    pax_orientation_t top_orientation,
-    pax_vec2i         top_pos
-) {
-    if (top->type == base->type) {
-        // Equal buffer types; no color conversion required.
-        pax_sasr_blit_raw_impl(
-            odd_scanline,
-            base,
-            top->buf,
-            (pax_vec2i){top->width, top->height},
-            base_pos,
-            top_orientation,
-            top_pos
-        );
-    } else if (
-        base->type_info.fmt_type == PAX_BUF_SUBTYPE_PALETTE && top->type_info.fmt_type != PAX_BUF_SUBTYPE_PALETTE
-    ) {
-        // Bottom is palette, top is not; do palette special case.
-        sasr_blit_impl_2(
-            odd_scanline,
-            base,
-            top,
-            (pax_vec2i){top->width, top->height},
-            base_pos,
-            top_orientation,
-            top_pos,
-            0,
-            0,
-            1
+// Start the worker pool with the settings in `config`.
+// Must be called with `pool_mtx` held.
+static bool pax_sasr_pool_start(pax_sasr_config_t const *config) {
+    int count = config->workers;
+    #if CONFIG_PAX_COMPILE_ASYNC_RENDERER == 2
+    if (count < 0) {
+        count = pax_sasr_cpu_count();
+    }
+    if (count < 1) {
+        count = 1;
+    } else if (count > CONFIG_PAX_ASYNC_MAX_WORKERS) {
+        PAX_LOGW(
+            "pax-sasr",
+            "Requested %d workers but CONFIG_PAX_ASYNC_MAX_WORKERS is %d",
+            count,
+            CONFIG_PAX_ASYNC_MAX_WORKERS
         );
-    } else {
-        // Different buffer types; color conversion required.
-        sasr_blit_impl_2(
-            odd_scanline,
-            base,
-            top,
-            (pax_vec2i){top->width, top->height},
-            base_pos,
-            top_orientation,
-            top_pos,
-            0,
-            0,
-            0
+        count = CONFIG_PAX_ASYNC_MAX_WORKERS;
+    }
+    #else
+    if (count != 0 && count != 1) {
+        PAX_LOGW(
+            "pax-sasr",
+            "Async renderer is compiled in single-threaded mode; please define CONFIG_PAX_COMPILE_ASYNC_RENDERER to be "
+            "2 to use multithreaded mode."
         );
     }
-}
-
-// Clipping routine for text characters.
-// Returns `true` if the character should be drawn at all.
-__attribute__((always_inline)) static inline bool
-    blit_char_clip(pax_recti clip, pax_vec2i pos, int scale, pax_recti *dims_out, pax_text_rsdata_t rsdata) {
-    pax_recti dims = {0, 0, rsdata.w * scale, rsdata.h * scale};
-
-    // Offset to calculate clipping.
-    dims.x += pos.x;
-    dims.y += pos.y;
+    count = 1;
+    #endif
 
-    // Actual clipping calculation.
-    if (dims.x < clip.x) {
-        dims.w -= clip.x - dims.x;
-        dims.x  = clip.x;
+    workers = malloc(sizeof(pax_sasr_worker_t) * count);
+    if (!workers) {
+        pax_set_err(PAX_ERR_NOMEM);
+        return false;
     }
-    if (dims.y < clip.y) {
-        dims.h -= clip.y - dims.y;
-        dims.y  = clip.y;
+    for (int i = 0; i < count; i++) {
+        pax_sasr_worker_t *worker = &workers[i];
+        worker->index             = i;
+        atomic_init(&worker->sleeping, false);
+        pthread_mutex_init(&worker->mtx, NULL);
+        pthread_cond_init(&worker->cond, NULL);
     }
-    if (dims.x + dims.w > clip.x + clip.w) {
-        dims.w = clip.x + clip.w - dims.x;
+    atomic_store(&pool_stop, false);
+    atomic_store(&n_contexts, 0);
+
+    // The workers don't look at the worker count until there are render contexts, so the pool can still shrink.
+    int started = 0;
+    while (started < count && pax_sasr_spawn(&workers[started], config)) {
+        started++;
     }
-    if (dims.y + dims.h > clip.y + clip.h) {
-        dims.h = clip.y + clip.h - dims.y;
+    if (started < count) {
+        PAX_LOGE("pax-sasr", "Can't start worker %d; continuing with %d workers", started, started);
+        for (int i = started; i < count; i++) {
+            pthread_cond_destroy(&workers[i].cond);
+            pthread_mutex_destroy(&workers[i].mtx);
+        }
     }
-
-    // Undo the offset.
-    dims.x -= pos.x;
-    dims.y -= pos.y;
-
-    *dims_out = dims;
-    return dims.w > 0 && dims.h > 0;
+    n_workers    = started;
+    n_lanes      = started > 1 ? started * CONFIG_PAX_ASYNC_BANDS_PER_WORKER : 1;
+    pool_running = started;
+    if (!started) {
+        free(workers);
+        workers = NULL;
+        pax_set_err(PAX_ERR_UNKNOWN);
+        return false;
+    }
+    return true;
 }
 
-// Blit one or more characters of text in the bitmapped format.
-__attribute__((always_inline)) static inline void pax_sasr_blit_char_impl_2(
-    bool              odd_scanline,
-    pax_buf_t        *buf,
-    pax_col_t         color,
-    pax_vec2i         pos,
-    int               scale,
-    pax_text_rsdata_t rsdata,
-    bool              direct_set
-) {
-    // clang-format off
-    int dx = 0, dy = 0;
-    pax_recti effective_clip;
-#if CONFIG_PAX_COMPILE_ORIENTATION
-    effective_clip = pax_get_clip(buf);
-    switch (buf->orientation) {
-        case PAX_O_UPRIGHT:         dx =  1;          dy =  buf->width; break;
-        case PAX_O_ROT_CCW:         dx = -buf->width; dy =  1;          break;
-        case PAX_O_ROT_HALF:        dx = -1;          dy = -buf->width; break;
-        case PAX_O_ROT_CW:          dx =  buf->width; dy = -1;          break;
-        case PAX_O_FLIP_H:          dx = -1;          dy =  buf->width; break;
-        case PAX_O_ROT_CCW_FLIP_H:  dx = -buf->width; dy = -1;          break;
-        case PAX_O_ROT_HALF_FLIP_H: dx =  1;          dy = -buf->width; break;
-        case PAX_O_ROT_CW_FLIP_H:   dx =  buf->width; dy =  1;          break;
+// Stop the worker pool after the workers run out of tasks and free all contexts.
+// Must be called with `pool_mtx` held.
+static void pax_sasr_pool_stop() {
+    atomic_store(&pool_stop, true);
+    for (int i = 0; i < n_workers; i++) {
+        pthread_mutex_lock(&workers[i].mtx);
+        pthread_cond_signal(&workers[i].cond);
+        pthread_mutex_unlock(&workers[i].mtx);
     }
-#else
-    dx = 1;
-    dy = buf->width;
-    effective_clip = buf->clip;
-#endif
-    // clang-format on
-
-    // Calculate correct multiplier for alpha.
-    uint8_t  bitmask   = (1 << rsdata.bpp) - 1;
-    uint16_t alpha_mul = (0xff00 / bitmask);
-    if (!direct_set) {
-        // Premultiply the color's alpha.
-        alpha_mul  = alpha_mul * ((color >> 24) + (color >> 31)) / 256;
-        color     &= 0x00ffffff;
-    } else {
-        // Pre-convert the color.
-        color = buf->col2buf(buf, color);
+    // Wait for the workers to exit; they must not touch any of the state after this.
+    pool_stopping = true;
+    while (pool_running) {
+        pthread_cond_wait(&pool_cond, &pool_mtx);
     }
+    pool_stopping = false;
+    pthread_cond_broadcast(&pool_cond);
+
+    int count = atomic_load(&n_contexts);
+    for (int i = 0; i < count; i++) {
+        pax_sasr_t *sasr = contexts[i];
+        for (int j = 0; j < n_lanes; j++) {
+            free(sasr->lanes[j].ring);
+        }
+        free(sasr->lanes);
+        pax_sasr_arena_clear(&sasr->arena);
+        pthread_mutex_destroy(&sasr->arena.mtx);
+        pthread_mutex_destroy(&sasr->queuemtx);
+        pthread_cond_destroy(&sasr->joincond);
+        pthread_mutex_destroy(&sasr->joinmtx);
+        free(sasr);
+        contexts[i] = NULL;
+    }
+    atomic_store(&n_contexts, 0);
 
-    // Clip char.
-    pax_recti dims;
-    if (blit_char_clip(effective_clip, pos, scale, &dims, rsdata)) {
-        // Char is not (entirely) outside framebuffer.
-        int x_increment = 1, y_increment = 2;
-        #if CONFIG_PAX_COMPILE_ORIENTATION
-        pos = pax_orient_det_vec2i(buf, pos);
-
-        if (buf->orientation & 1) {
-            x_increment = 2, y_increment = 1;
-
-            if (((pos.y + dims.x) & 1) != odd_scanline) {
-                dims.x++;
-                dims.w--;
+    for (int i = 0; i < n_workers; i++) {
+        pthread_cond_destroy(&workers[i].cond);
+        pthread_mutex_destroy(&workers[i].mtx);
+    }
+    free(workers);
+    workers   = NULL;
+    n_workers = 0;
+    n_lanes   = 0;
+}
+
+// Allocate the state for a new render context and make it known to the workers.
+// Must be called with `pool_mtx` held.
+static pax_sasr_t *pax_sasr_context_create() {
+    int count = atomic_load(&n_contexts);
+    if (count >= CONFIG_PAX_ASYNC_MAX_CONTEXTS) {
+        PAX_LOGE(
+            "pax-sasr",
+            "Can't have more than CONFIG_PAX_ASYNC_MAX_CONTEXTS (%d) render contexts",
+            CONFIG_PAX_ASYNC_MAX_CONTEXTS
+        );
+        return NULL;
+    }
+    pax_sasr_t *sasr = malloc(sizeof(pax_sasr_t));
+    if (!sasr) {
+        pax_set_err(PAX_ERR_NOMEM);
+        return NULL;
+    }
+    sasr->lanes = aligned_alloc(PAX_SASR_CACHE_LINE, sizeof(pax_sasr_lane_t) * n_lanes);
+    if (!sasr->lanes) {
+        free(sasr);
+        pax_set_err(PAX_ERR_NOMEM);
+        return NULL;
+    }
+    for (int i = 0; i < n_lanes; i++) {
+        pax_sasr_lane_t *lane = &sasr->lanes[i];
+        lane->ring = aligned_alloc(PAX_SASR_CACHE_LINE, PAX_SASR_RING_SIZE);
+        if (!lane->ring) {
+            while (i--) {
+                free(sasr->lanes[i].ring);
             }
-        } else
-        #endif
-            if (((pos.y + dims.y) & 1) != odd_scanline) {
-            dims.y++;
-            dims.h--;
+            free(sasr->lanes);
+            free(sasr);
+            pax_set_err(PAX_ERR_NOMEM);
+            return NULL;
         }
+        lane->has_shader = false;
+        lane->barrier    = 0;
+        atomic_init(&lane->head, 0);
+        atomic_init(&lane->written, 0);
+        atomic_init(&lane->tail, 0);
+        atomic_init(&lane->busy, false);
+    }
+    sasr->in_use = true;
+    pthread_mutex_init(&sasr->joinmtx, NULL);
+    pthread_cond_init(&sasr->joincond, NULL);
+    atomic_init(&sasr->join_waiting, 0);
+    pax_sasr_arena_init(&sasr->arena);
+    pthread_mutex_init(&sasr->queuemtx, NULL);
+    sasr->n_fences = 0;
+    atomic_init(&sasr->fence_done, atomic_load(&fence_seq));
+    for (size_t i = 0; i < CONFIG_PAX_QUEUE_SIZE; i++) {
+        atomic_init(&sasr->fences[i].remaining, 0);
+    }
 
+    // Publish the context to the workers.
+    contexts[count] = sasr;
+    atomic_store_explicit(&n_contexts, count + 1, memory_order_release);
+    return sasr;
+}
+
+// Initialize a render context using the async renderer.
+// The init cookie is a `pax_sasr_config_t const *`; NULL for a single worker with the default settings.
+// All contexts share one pool of workers, which is started by the first context.
+static pax_render_funcs_t const *pax_sasr_init(void **state, void *arg) {
+    pax_sasr_config_t const defaults = {0};
+    pax_sasr_config_t const *config  = arg ? arg : &defaults;
+    pthread_mutex_lock(&pool_mtx);
+    while (pool_stopping) {
+        pthread_cond_wait(&pool_cond, &pool_mtx);
+    }
+    if (!pool_refs && !pax_sasr_pool_start(config)) {
+        pthread_mutex_unlock(&pool_mtx);
+        return NULL;
+    }
 
-        // Calculate drawing parameters.
-        int bits_dy = rsdata.row_stride << 3;
-        int offset  = (pos.x + pos.y * buf->width) + (dims.x * dx + dims.y * dy);
-
-        // Actual blit loop.
-        for (int y = dims.y; y < dims.y + dims.h; y += y_increment) {
-            int next_y_offset = offset + y_increment * dy;
-            for (int x = dims.x; x < dims.x + dims.w; x += x_increment) {
-                // Extract value from character bitmap.
-                int     bit   = x / scale * rsdata.bpp + y / scale * bits_dy;
-                uint8_t value = (rsdata.bitmap[bit >> 3] >> (bit & 7)) & bitmask;
-                // Multiply value into 0-255 range.
-                value         = (value * alpha_mul) >> 8;
-
-                if (direct_set) {
-                    // Directly set the pixel.
-                    if (value >= 128) {
-                        buf->setter(buf, color, offset);
-                    }
-                } else {
-                    // Perform correct alpha-blending.
-                    pax_col_t top    = color | (value << 24);
-                    pax_col_t base   = buf->buf2col(buf, buf->getter(buf, offset));
-                    pax_col_t merged = pax_col_merge(base, top);
-                    buf->setter(buf, buf->col2buf(buf, merged), offset);
-                }
-
-                offset += x_increment * dx;
-            }
-            offset = next_y_offset;
+    // Reuse the state of a context that has been destroyed if possible.
+    pax_sasr_t *sasr = NULL;
+    for (int i = 0; i < atomic_load(&n_contexts); i++) {
+        if (!contexts[i]->in_use) {
+            sasr         = contexts[i];
+            sasr->in_use = true;
+            // Fences inserted before this point belong to the previous user and count as completed.
+            atomic_store(&sasr->fence_done, atomic_load(&fence_seq));
+            break;
         }
     }
-}
-
-// Blit one or more characters of text in the bitmapped format.
-__attribute__((noinline)) static void pax_sasr_blit_char_direct_set(
-    bool odd_scanline, pax_buf_t *buf, pax_col_t color, pax_vec2i pos, int scale, pax_text_rsdata_t rsdata
-) {
-    pax_sasr_blit_char_impl_2(odd_scanline, buf, color, pos, scale, rsdata, true);
-}
+    if (!sasr) {
+        sasr = pax_sasr_context_create();
+    }
+    if (!sasr) {
+        if (!pool_refs) {
+            pax_sasr_pool_stop();
+        }
+        pthread_mutex_unlock(&pool_mtx);
+        return NULL;
+    }
+    pool_refs++;
+    pthread_mutex_unlock(&pool_mtx);
 
-// Blit one or more characters of text in the bitmapped format.
-__attribute__((noinline)) static void pax_sasr_blit_char_alpha_blend(
-    bool odd_scanline, pax_buf_t *buf, pax_col_t color, pax_vec2i pos, int scale, pax_text_rsdata_t rsdata
-) {
-    pax_sasr_blit_char_impl_2(odd_scanline, buf, color, pos, scale, rsdata, false);
+    sasr->deferred = config->deferred;
+    *state         = sasr;
+    return &pax_render_funcs_softasync;
 }
 
-// Blit one or more characters of text in the bitmapped format.
-static void pax_sasr_blit_char_impl(
-    bool odd_scanline, pax_buf_t *buf, pax_col_t color, pax_vec2i pos, int scale, pax_text_rsdata_t rsdata
-) {
-    if ((rsdata.bpp == 1 && color >> 24 == 255) || buf->type_info.fmt_type == PAX_BUF_SUBTYPE_PALETTE) {
-        // If the BPP is 1 and the color is fully opaque OR the buffer is of palette type, no alpha blending happens.
-        pax_sasr_blit_char_direct_set(odd_scanline, buf, color, pos, scale, rsdata);
-    } else {
-        // Otherwise, alpha blending is necessary.
-        pax_sasr_blit_char_alpha_blend(odd_scanline, buf, color, pos, scale, rsdata);
+// Deinitialize a render context using the async renderer.
+// The worker pool is stopped when the last context is deinitialized.
+static void pax_sasr_deinit(void *state) {
+    pax_sasr_t *sasr = state;
+    pax_sasr_join(sasr);
+    pax_sasr_arena_clear(&sasr->arena);
+    pthread_mutex_lock(&pool_mtx);
+    sasr->in_use = false;
+    if (--pool_refs == 0) {
+        pax_sasr_pool_stop();
     }
+    pthread_mutex_unlock(&pool_mtx);
 }
 
-// Image reading helper for `pax_swr_scaled_image`.
-static inline __attribute__((always_inline)) pax_col_t
-    scaled_image_get_pixel(pax_buf_t const *buf, pax_vec2f pos, pax_index_getter_t get, pax_col_conv_t conv) {
-    pos.x -= 0.5f;
-    pos.y -= 0.5f;
-
-    int tex_x = floorf(pos.x);
-    int tex_y = floorf(pos.y);
-
-    int       idx0 = pax_clamped_index(buf, tex_x, tex_y);
-    int       idx1 = pax_clamped_index(buf, tex_x + 1, tex_y);
-    int       idx2 = pax_clamped_index(buf, tex_x + 1, tex_y + 1);
-    int       idx3 = pax_clamped_index(buf, tex_x, tex_y + 1);
-    uint32_t  raw0 = get(buf, idx0);
-    uint32_t  raw1 = get(buf, idx1);
-    uint32_t  raw2 = get(buf, idx2);
-    uint32_t  raw3 = get(buf, idx3);
-    pax_col_t col0 = conv(buf, raw0);
-    pax_col_t col1 = conv(buf, raw1);
-    pax_col_t col2 = conv(buf, raw2);
-    pax_col_t col3 = conv(buf, raw3);
 
-    uint32_t coeffx  = (pos.x - tex_x) * 255;
-    uint32_t coeffy  = (pos.y - tex_y) * 255;
-    coeffx          &= 255;
-    coeffy          &= 255;
-
-    pax_col_t col01_a = pax_lerp_mask(0xff00ff00, coeffx, col0, col1);
-    pax_col_t col32_a = pax_lerp_mask(0xff00ff00, coeffx, col3, col2);
-    pax_col_t color_a = pax_lerp_mask(0xff00ff00, coeffy, col01_a, col32_a);
-    pax_col_t col01_b = pax_lerp_mask(0x00ff00ff, coeffx, col0, col1);
-    pax_col_t col32_b = pax_lerp_mask(0x00ff00ff, coeffx, col3, col2);
-    pax_col_t color_b = pax_lerp_mask(0x00ff00ff, coeffy, col01_b, col32_b);
+// Get the first row of a band in a buffer of `height` rows.
+// Bands start on a multiple of 8 rows so that workers never share a byte of sub-byte pixel formats.
+static inline int pax_sasr_band_start(int height, int index) {
+    if (index >= n_lanes) {
+        return height;
+    }
+    int start = (height * index / n_lanes + 7) & ~7;
+    return start < height ? start : height;
+}
+
+// Get the conservative integer bounds of a number of points.
+static pax_recti pax_sasr_points_bounds(pax_buf_t const *buf, pax_vec2f const *points, size_t n_points) {
+    float x0 = INFINITY, y0 = INFINITY, x1 = -INFINITY, y1 = -INFINITY;
+    for (size_t i = 0; i < n_points; i++) {
+        x0 = fminf(x0, points[i].x);
+        y0 = fminf(y0, points[i].y);
+        x1 = fmaxf(x1, points[i].x);
+        y1 = fmaxf(y1, points[i].y);
+    }
+    // Clamp to just outside the buffer so the conversion to int can't overflow.
+    x0 = fmaxf(floorf(x0) - 1, -1);
+    y0 = fmaxf(floorf(y0) - 1, -1);
+    x1 = fminf(ceilf(x1) + 1, buf->width);
+    y1 = fminf(ceilf(y1) + 1, buf->height);
+    if (!(x0 <= x1 && y0 <= y1)) {
+        return (pax_recti){0, 0, 0, 0};
+    }
+    return (pax_recti){x0, y0, x1 - x0 + 1, y1 - y0 + 1};
+}
 
-    return color_a | color_b;
+// Get the bounds of a character blit.
+static pax_recti pax_sasr_blit_char_bounds(pax_buf_t const *buf, pax_vec2i pos, int scale, pax_text_rsdata_t rsdata) {
+    pax_recti rect = {pos.x, pos.y, rsdata.w * scale, rsdata.h * scale};
+    #if CONFIG_PAX_COMPILE_ORIENTATION
+    return pax_recti_abs(pax_orient_det_recti(buf, rect));
+    #else
+    (void)buf;
+    return rect;
+    #endif
 }
 
-// Draw an axis-aligned image with fractional scaling.
-void pax_sasr_scaled_image_impl(
-    bool              odd_scanline,
-    pax_buf_t        *base,
-    pax_buf_t const  *top,
-    pax_recti         base_pos,
-    pax_orientation_t top_orientation,
-    bool              assume_opaque
-) {
-    pax_index_getter_t tget     = top->getter;
-    pax_col_conv_t     tbuf2col = top->buf2col;
-    pax_index_getter_t bget     = base->getter;
-    pax_index_setter_t bset     = base->setter;
-    pax_col_conv_t     bcol2buf = base->col2buf;
-    pax_col_conv_t     bbuf2col = base->buf2col;
-
-    pax_vec2f tex_start, tex_end;
-    bool      swap_xy = false;
-
-    switch (top_orientation & 3) {
-        case PAX_O_UPRIGHT:
-            tex_start = (pax_vec2f){0, 0};
-            tex_end   = (pax_vec2f){1, 1};
-            swap_xy   = false;
-            break;
-        case PAX_O_ROT_CCW:
-            tex_start = (pax_vec2f){1, 0};
-            tex_end   = (pax_vec2f){0, 1};
-            swap_xy   = true;
-            break;
-        case PAX_O_ROT_HALF:
-            tex_start = (pax_vec2f){1, 1};
-            tex_end   = (pax_vec2f){0, 0};
-            swap_xy   = false;
-            break;
-        case PAX_O_ROT_CW:
-            tex_start = (pax_vec2f){0, 1};
-            tex_end   = (pax_vec2f){1, 0};
-            swap_xy   = true;
-            break;
-    }
-    if (top_orientation & 4) {
-        tex_start = (pax_vec2f){1 - tex_start.x, tex_start.y};
-        tex_end   = (pax_vec2f){1 - tex_end.x, tex_end.y};
-    }
-    tex_start.x *= top->width;
-    tex_start.y *= top->height;
-    tex_end.x   *= top->width;
-    tex_end.y   *= top->height;
-
-    {
-        float dx = (tex_end.x - tex_start.x) / base_pos.w;
-        float dy = (tex_end.y - tex_start.y) / base_pos.h;
-
-        if (base_pos.x < base->clip.x) {
-            int diff = base->clip.x - base_pos.x;
-            if (top_orientation & 1) {
-                tex_start.y += diff * dy;
-            } else {
-                tex_start.x += diff * dx;
-            }
-            base_pos.w -= diff;
-            base_pos.x += diff;
-        }
-        if (base_pos.x + base_pos.w > base->clip.x + base->clip.w) {
-            int diff = (base_pos.x + base_pos.w) - (base->clip.x + base->clip.w);
-            if (top_orientation & 1) {
-                tex_end.y -= diff * dy;
-            } else {
-                tex_end.x -= diff * dx;
-            }
-            base_pos.w -= diff;
+// Get the conservative bounds of the area a task may draw to.
+static pax_recti pax_sasr_task_bounds(pax_task_t const *task) {
+    pax_buf_t const *buf = task->buffer;
+    switch (task->type) {
+        default: return (pax_recti){0, 0, buf->width, buf->height};
+        case PAX_TASK_RECT: {
+            pax_rectf shape     = task->rectf.shape;
+            pax_vec2f points[2] = {{shape.x, shape.y}, {shape.x + shape.w, shape.y + shape.h}};
+            return pax_sasr_points_bounds(buf, points, 2);
         }
-        if (base_pos.y < base->clip.y) {
-            int diff = base->clip.y - base_pos.y;
-            if (top_orientation & 1) {
-                tex_start.x += diff * dx;
-            } else {
-                tex_start.y += diff * dy;
+        case PAX_TASK_QUAD: return pax_sasr_points_bounds(buf, (pax_vec2f const *)&task->quadf.shape, 4);
+        case PAX_TASK_TRI: return pax_sasr_points_bounds(buf, (pax_vec2f const *)&task->trif.shape, 3);
+        case PAX_TASK_LINE: return pax_sasr_points_bounds(buf, (pax_vec2f const *)&task->linef.shape, 2);
+        case PAX_TASK_SPRITE:
+        case PAX_TASK_BLIT:
+        case PAX_TASK_BLIT_RAW: return pax_recti_abs(task->blit.base_pos);
+        case PAX_TASK_SCALED_IMAGE: return pax_recti_abs(task->scaled_image.base_pos);
+        case PAX_TASK_BLIT_CHAR:
+            return pax_sasr_blit_char_bounds(buf, task->blit_char.pos, task->blit_char.scale, task->blit_char.rsdata);
+        // Glyph runs have their bounds computed while the text is laid out.
+        case PAX_TASK_GLYPHS: return task->bounds;
+        case PAX_TASK_POLY: {
+            size_t n_points = 0;
+            for (size_t i = 0; i < task->polyf.n_contours; i++) {
+                n_points += task->polyf.contour_lens[i];
             }
-            base_pos.h -= diff;
-            base_pos.y += diff;
+            return pax_sasr_points_bounds(buf, task->polyf.points, n_points);
         }
-        if (base_pos.y + base_pos.h > base->clip.y + base->clip.h) {
-            int diff = (base_pos.y + base_pos.h) - (base->clip.y + base->clip.h);
-            if (top_orientation & 1) {
-                tex_end.x -= diff * dx;
-            } else {
-                tex_end.y -= diff * dy;
-            }
-            base_pos.h -= diff;
-        }
-        if (base_pos.w < 0 || base_pos.h < 0) {
-            return;
+        case PAX_TASK_ELLIPSE: {
+            pax_rectf bounds    = pax_ellipse_bounds(task->ellipsef);
+            pax_vec2f points[2] = {{bounds.x, bounds.y}, {bounds.x + bounds.w, bounds.y + bounds.h}};
+            return pax_sasr_points_bounds(buf, points, 2);
         }
-    }
-
-    pax_vec2f tex_dx = {0};
-    pax_vec2f tex_dy = {0};
-    if (!swap_xy) {
-        tex_dx.x = (tex_end.x - tex_start.x) / base_pos.w;
-        tex_dy.y = (tex_end.y - tex_start.y) / base_pos.h;
-    } else {
-        tex_dy.x = (tex_end.x - tex_start.x) / base_pos.h;
-        tex_dx.y = (tex_end.y - tex_start.y) / base_pos.w;
-    }
-
-    int       bindex  = base_pos.x + base->width * base_pos.y;
-    pax_vec2f tex_pos = tex_start;
-    int       y       = base_pos.y;
-    if (odd_scanline != (y & 1)) {
-        bindex    += base->width;
-        tex_pos.x += tex_dy.x;
-        tex_pos.y += tex_dy.y;
-    }
-    for (; y < base_pos.y + base_pos.h; y += 2) {
-        for (int x = base_pos.x; x < base_pos.x + base_pos.w; x++) {
-            pax_col_t col = scaled_image_get_pixel(top, tex_pos, tget, tbuf2col);
-            if (!assume_opaque) {
-                col = pax_col_merge_inlined(bbuf2col(base, bget(base, bindex)), col);
-            }
-            bset(base, bcol2buf(base, col), bindex);
-            bindex++;
-
-            tex_pos.x += tex_dx.x;
-            tex_pos.y += tex_dx.y;
+        case PAX_TASK_ROUND_RECT: {
+            pax_round_rectf shape     = task->round_rectf;
+            pax_vec2f       points[2] = {{shape.x, shape.y}, {shape.x + shape.w, shape.y + shape.h}};
+            return pax_sasr_points_bounds(buf, points, 2);
         }
-        bindex    += 2 * base->width - base_pos.w;
-        tex_pos.x += 2 * tex_dy.x - base_pos.w * tex_dx.x;
-        tex_pos.y += 2 * tex_dy.y - base_pos.w * tex_dx.y;
     }
 }
 
 
-
-// Background fill.
-void pax_mcrw0_background(pax_buf_t *buf, pax_col_t color) {
-    pax_sasr_background_impl(0, buf, color);
-}
-
-// Draw a solid-colored line.
-void pax_mcrw0_unshaded_line(pax_buf_t *buf, pax_col_t color, pax_linef shape) {
-    paxmcr_line_unshaded(0, buf, color, shape.x0, shape.y0, shape.x1, shape.y1);
-}
-
-// Draw a solid-colored rectangle.
-void pax_mcrw0_unshaded_rect(pax_buf_t *buf, pax_col_t color, pax_rectf shape) {
-    paxmcr_rect_unshaded(0, buf, color, shape.x, shape.y, shape.w, shape.h);
-}
-
-// Draw a solid-colored quad.
-void pax_mcrw0_unshaded_quad(pax_buf_t *buf, pax_col_t color, pax_quadf shape) {
-    paxmcr_quad_unshaded(0, buf, color, shape.x0, shape.y0, shape.x1, shape.y1, shape.x2, shape.y2, shape.x3, shape.y3);
+// Get the number of bytes of shape data a task of this type stores in the command stream.
+// This is a prefix of the task's shape union; the UVs come after the shape, so unshaded tasks leave them out.
+static size_t pax_sasr_payload_size(pax_task_t const *task) {
+    switch (task->type) {
+        default: return 0;
+        case PAX_TASK_RECT: return task->use_shader ? sizeof(task->rectf) : sizeof(task->rectf.shape);
+        case PAX_TASK_QUAD: return task->use_shader ? sizeof(task->quadf) : sizeof(task->quadf.shape);
+        case PAX_TASK_TRI: return task->use_shader ? sizeof(task->trif) : sizeof(task->trif.shape);
+        case PAX_TASK_LINE: return task->use_shader ? sizeof(task->linef) : sizeof(task->linef.shape);
+        case PAX_TASK_SPRITE:
+        case PAX_TASK_BLIT:
+        case PAX_TASK_BLIT_RAW: return sizeof(task->blit);
+        case PAX_TASK_BLIT_CHAR: return sizeof(task->blit_char);
+        case PAX_TASK_GLYPHS: return sizeof(task->glyphs);
+        case PAX_TASK_POLY: return sizeof(task->polyf);
+        case PAX_TASK_ELLIPSE: return sizeof(task->ellipsef);
+        case PAX_TASK_ROUND_RECT: return sizeof(task->round_rectf);
+        case PAX_TASK_FENCE: return sizeof(task->fence);
+        case PAX_TASK_SCALED_IMAGE: return sizeof(task->scaled_image);
+    }
 }
 
-// Draw a solid-colored triangle.
-void pax_mcrw0_unshaded_tri(pax_buf_t *buf, pax_col_t color, pax_trif shape) {
-    paxmcr_tri_unshaded(0, buf, color, shape.x0, shape.y0, shape.x1, shape.y1, shape.x2, shape.y2);
+// Whether two shaders are the same.
+static inline bool pax_sasr_shader_eq(pax_shader_t const *a, pax_shader_t const *b) {
+    return a->schema_version == b->schema_version && a->schema_complement == b->schema_complement
+           && a->renderer_id == b->renderer_id && a->promise_callback == b->promise_callback
+           && a->callback == b->callback && a->callback_args == b->callback_args
+           && a->alpha_promise_0 == b->alpha_promise_0 && a->alpha_promise_255 == b->alpha_promise_255;
 }
 
-// Draw a line with a shader.
-void pax_mcrw0_shaded_line(pax_buf_t *buf, pax_col_t color, pax_linef shape, pax_shader_t const *shader, pax_linef uv) {
-    paxmcr_line_shaded(0, buf, color, shader, shape.x0, shape.y0, shape.x1, shape.y1, uv.x0, uv.y0, uv.x1, uv.y1);
+// Round a size up to a multiple of `PAX_SASR_CMD_ALIGN`.
+static inline size_t pax_sasr_cmd_align(size_t size) {
+    return (size + PAX_SASR_CMD_ALIGN - 1) & ~(size_t)(PAX_SASR_CMD_ALIGN - 1);
 }
 
-// Draw a rectangle with a shader.
-void pax_mcrw0_shaded_rect(pax_buf_t *buf, pax_col_t color, pax_rectf shape, pax_shader_t const *shader, pax_quadf uv) {
-    // clang-format off
-    paxmcr_rect_shaded(
-        0, buf, color, shader,
-        shape.x, shape.y, shape.w, shape.h,
-        uv.x0, uv.y0, uv.x1, uv.y1, uv.x2, uv.y2, uv.x3, uv.y3
-    );
-    // clang-format on
+// Wake up a worker if it is sleeping.
+// Must be preceded by a sequentially consistent fence after the tasks are published.
+static void pax_sasr_wake(pax_sasr_worker_t *worker) {
+    if (atomic_load_explicit(&worker->sleeping, memory_order_relaxed)) {
+        pthread_mutex_lock(&worker->mtx);
+        pthread_cond_signal(&worker->cond);
+        pthread_mutex_unlock(&worker->mtx);
+    }
 }
 
-// Draw a quad with a shader.
-void pax_mcrw0_shaded_quad(pax_buf_t *buf, pax_col_t color, pax_quadf shape, pax_shader_t const *shader, pax_quadf uv) {
-    // clang-format off
-    paxmcr_quad_shaded(
-        0, buf, color, shader,
-        shape.x0, shape.y0, shape.x1, shape.y1, shape.x2, shape.y2, shape.x3, shape.y3,
-        uv.x0, uv.y0, uv.x1, uv.y1, uv.x2, uv.y2, uv.x3, uv.y3
+// Publish the commands written to a lane so far to the workers; the worker is not woken up.
+// Must be called with the queue mutex held.
+static inline void pax_sasr_publish(pax_sasr_lane_t *lane) {
+    atomic_store_explicit(
+        &lane->head,
+        atomic_load_explicit(&lane->written, memory_order_relaxed),
+        memory_order_release
     );
-    // clang-format on
 }
 
-// Draw a triangle with a shader.
-void pax_mcrw0_shaded_tri(pax_buf_t *buf, pax_col_t color, pax_trif shape, pax_shader_t const *shader, pax_trif uv) {
-    // clang-format off
-    paxmcr_tri_shaded(
-        0, buf, color, shader,
-        shape.x0, shape.y0, shape.x1, shape.y1, shape.x2, shape.y2,
-        uv.x0, uv.y0, uv.x1, uv.y1, uv.x2, uv.y2
-    );
-    // clang-format on
+// Whether a task reads the pixels of a buffer, which may be one that earlier commands draw to.
+static bool pax_sasr_reads_buf(pax_task_t const *task) {
+    switch (task->type) {
+        default:
+            return task->use_shader
+                   && (task->shader.callback == pax_shader_texture || task->shader.callback == pax_shader_texture_aa
+                       || task->shader.callback == pax_shader_texture_span
+                       || task->shader.callback == pax_shader_texture_aa_span);
+        case PAX_TASK_SPRITE:
+        case PAX_TASK_BLIT:
+        case PAX_TASK_BLIT_RAW:
+        case PAX_TASK_SCALED_IMAGE: return true;
+    }
 }
 
+// Encode a task into the ring of a band's lane, waiting for room if it is full.
+// Must be called with the queue mutex held; the worker is only woken up if a deferred context ran out of room.
+static void pax_sasr_push(pax_sasr_t *sasr, int band, pax_task_t const *task) {
+    pax_sasr_lane_t *lane = &sasr->lanes[band];
+    // A shader is only stored if it differs from the one the previous shaded command in this lane used.
+    bool   new_shader = task->use_shader && !(lane->has_shader && pax_sasr_shader_eq(&lane->last_shader, &task->shader));
+    size_t payload    = pax_sasr_cmd_align(pax_sasr_payload_size(task));
+    size_t size       = sizeof(pax_sasr_cmd_t) + payload + (new_shader ? sizeof(pax_shader_t) : 0);
+
+    // Commands are never split over the end of the ring; the rest of it is padded out instead.
+    size_t head = atomic_load_explicit(&lane->written, memory_order_relaxed);
+    size_t pad  = head % PAX_SASR_RING_SIZE + size > PAX_SASR_RING_SIZE ? PAX_SASR_RING_SIZE - head % PAX_SASR_RING_SIZE
+                                                                        : 0;
+    if (head + pad + size - atomic_load_explicit(&lane->tail, memory_order_acquire) > PAX_SASR_RING_SIZE
+        && atomic_load_explicit(&lane->head, memory_order_relaxed) != head) {
+        // The ring is full of commands held back by a deferred context; let the worker start on them.
+        pax_sasr_publish(lane);
+        atomic_thread_fence(memory_order_seq_cst);
+        pax_sasr_wake(&workers[band % n_workers]);
+    }
+    while (head + pad + size - atomic_load_explicit(&lane->tail, memory_order_acquire) > PAX_SASR_RING_SIZE) {
+        // The ring is full; wait for the worker to catch up.
+        sched_yield();
+    }
+    if (pad) {
+        pax_sasr_cmd_t *cmd = (pax_sasr_cmd_t *)(lane->ring + head % PAX_SASR_RING_SIZE);
+        cmd->flags          = PAX_SASR_CMD_PAD;
+        cmd->size           = pad;
+        head               += pad;
+    }
 
-// Draw an axis-aligned image with fractional scaling.
-void pax_mcrw0_scaled_image(
-    pax_buf_t *base, pax_buf_t const *top, pax_recti base_pos, pax_orientation_t top_orientation, bool assume_opaque
-) {
-    pax_sasr_scaled_image_impl(0, base, top, base_pos, top_orientation, assume_opaque);
+    uint8_t        *mem = lane->ring + head % PAX_SASR_RING_SIZE;
+    pax_sasr_cmd_t *cmd = (pax_sasr_cmd_t *)mem;
+    cmd->type           = task->type;
+    cmd->flags          = (task->use_shader ? PAX_SASR_CMD_SHADED : 0) | (new_shader ? PAX_SASR_CMD_SHADER : 0)
+                        | (task->antialias ? PAX_SASR_CMD_AA : 0);
+    cmd->size           = size;
+    cmd->color          = task->color;
+    cmd->buffer         = task->buffer;
+    cmd->bounds         = task->bounds;
+    // All members of the shape union start at the same address.
+    memcpy(mem + sizeof(pax_sasr_cmd_t), &task->linef, pax_sasr_payload_size(task));
+    if (new_shader) {
+        memcpy(mem + sizeof(pax_sasr_cmd_t) + payload, &task->shader, sizeof(pax_shader_t));
+        lane->last_shader = task->shader;
+        lane->has_shader  = true;
+    }
+    if (pax_sasr_reads_buf(task)) {
+        lane->barrier = head + size;
+    }
+    atomic_store_explicit(&lane->written, head + size, memory_order_relaxed);
+    if (!sasr->deferred) {
+        atomic_store_explicit(&lane->head, head + size, memory_order_release);
+    }
+    PAX_STATS_QUEUE_DEPTH(head + size - atomic_load_explicit(&lane->tail, memory_order_relaxed));
+}
+
+// Decode a command read from a lane's ring back into a task.
+static void pax_sasr_decode(pax_sasr_lane_t *lane, pax_sasr_cmd_t const *cmd, pax_task_t *task) {
+    uint8_t const *mem = (uint8_t const *)cmd;
+    task->type         = cmd->type;
+    task->use_shader   = cmd->flags & PAX_SASR_CMD_SHADED;
+    task->antialias    = cmd->flags & PAX_SASR_CMD_AA;
+    task->color        = cmd->color;
+    task->buffer       = cmd->buffer;
+    task->bounds       = cmd->bounds;
+    size_t payload     = pax_sasr_payload_size(task);
+    memcpy(&task->linef, mem + sizeof(pax_sasr_cmd_t), payload);
+    if (cmd->flags & PAX_SASR_CMD_SHADER) {
+        memcpy(&lane->shader, mem + sizeof(pax_sasr_cmd_t) + pax_sasr_cmd_align(payload), sizeof(pax_shader_t));
+    }
+    if (task->use_shader) {
+        task->shader = lane->shader;
+    }
 }
 
-// Draw a sprite; like a blit, but use color blending if applicable.
-void pax_mcrw0_sprite(
-    pax_buf_t *base, pax_buf_t const *top, pax_recti base_pos, pax_orientation_t top_orientation, pax_vec2i top_pos
-) {
-    pax_sasr_sprite_impl(0, base, top, base_pos, top_orientation, top_pos);
+// Whether a color is drawn without blending by unshaded shapes.
+static inline bool pax_sasr_col_opaque(pax_buf_t const *buf, pax_col_t color) {
+    if (buf->type_info.fmt_type == PAX_BUF_SUBTYPE_PALETTE) {
+        return color < buf->palette_size;
+    }
+    return (color & 0xff000000) == 0xff000000;
+}
+
+// Whether the rectangle filler represents a coordinate exactly; NaN and values that overflow its number format
+// are not, and neither are infinities.
+static inline bool pax_sasr_coord_exact(float value) {
+    return fabsf(value) <= PAX_SASR_COORD_MAX;
+}
+
+// Get the area a task overwrites entirely, regardless of what was drawn there before.
+// Returns an empty rectangle for tasks that blend or may leave some pixels of their bounds untouched.
+static pax_recti pax_sasr_task_cover(pax_task_t const *task) {
+    pax_buf_t const *buf   = task->buffer;
+    pax_recti        cover = {0, 0, 0, 0};
+    switch (task->type) {
+        default: break;
+        case PAX_TASK_BACKGROUND: cover = task->bounds; break;
+        case PAX_TASK_RECT: {
+            if (task->use_shader || !pax_sasr_col_opaque(buf, task->color)) {
+                break;
+            }
+            pax_rectf shape = task->rectf.shape;
+            if (!pax_sasr_coord_exact(shape.x) || !pax_sasr_coord_exact(shape.w)
+                || !pax_sasr_coord_exact(shape.x + shape.w) || !pax_sasr_coord_exact(shape.y)
+                || !pax_sasr_coord_exact(shape.h) || !pax_sasr_coord_exact(shape.y + shape.h)) {
+                break;
+            }
+            // Only the pixels entirely inside the rectangle are certain to be filled.
+            float x0 = fmaxf(ceilf(fminf(shape.x, shape.x + shape.w)), 0);
+            float y0 = fmaxf(ceilf(fminf(shape.y, shape.y + shape.h)), 0);
+            float x1 = fminf(floorf(fmaxf(shape.x, shape.x + shape.w)), buf->width);
+            float y1 = fminf(floorf(fmaxf(shape.y, shape.y + shape.h)), buf->height);
+            if (x0 < x1 && y0 < y1) {
+                cover = (pax_recti){x0, y0, x1 - x0, y1 - y0};
+            }
+            break;
+        }
+        case PAX_TASK_BLIT:
+        case PAX_TASK_BLIT_RAW: {
+            // Blits copy pixels without blending, but only as many as the top buffer has.
+            // A blit from the buffer to itself may read what the commands it covers drew.
+            pax_vec2i      dims = task->blit.top_dims;
+            uint8_t const *top  = task->blit.top;
+            uint8_t const *mem  = buf->buf;
+            if (task->type == PAX_TASK_BLIT) {
+                pax_buf_t const *top_buf = task->blit.top;
+                dims                     = (pax_vec2i){top_buf->width, top_buf->height};
+                top                      = top_buf->buf;
+            }
+            if (top >= mem && top < mem + pax_buf_calc_size_dynamic(buf->width, buf->height, buf->type)) {
+                break;
+            }
+    #if CONFIG_PAX_COMPILE_ORIENTATION
+            if (task->blit.top_orientation & 1) {
+                dims = (pax_vec2i){dims.y, dims.x};
+            }
+    #endif
+            cover   = task->blit.base_pos;
+            cover.w = cover.w < dims.x ? cover.w : dims.x;
+            cover.h = cover.h < dims.y ? cover.h : dims.y;
+            break;
+        }
+        case PAX_TASK_SCALED_IMAGE:
+            if (task->scaled_image.assume_opaque && task->scaled_image.top != buf) {
+                cover = task->scaled_image.base_pos;
+            }
+            break;
+    }
+    if (cover.w <= 0 || cover.h <= 0) {
+        return (pax_recti){0, 0, 0, 0};
+    }
+    return pax_recti_intersect(cover, task->bounds);
 }
 
-// Perform a buffer copying operation with a PAX buffer.
-void pax_mcrw0_blit(
-    pax_buf_t *base, pax_buf_t const *top, pax_recti base_pos, pax_orientation_t top_orientation, pax_vec2i top_pos
-) {
-    pax_sasr_blit_impl(0, base, top, base_pos, top_orientation, top_pos);
+// Whether rectangle `inner` lies entirely within `outer`.
+static inline bool pax_sasr_recti_contains(pax_recti outer, pax_recti inner) {
+    return inner.x >= outer.x && inner.y >= outer.y && inner.x + inner.w <= outer.x + outer.w
+           && inner.y + inner.h <= outer.y + outer.h;
 }
 
-// Perform a buffer copying operation with an unmanaged user buffer.
-void pax_mcrw0_blit_raw(
-    pax_buf_t        *base,
-    void const       *top,
-    pax_vec2i         top_dims,
-    pax_recti         base_pos,
-    pax_orientation_t top_orientation,
-    pax_vec2i         top_pos
-) {
-    pax_sasr_blit_raw_impl(0, base, top, top_dims, base_pos, top_orientation, top_pos);
+// Hide the commands a deferred context has written to a band's lane but not yet published that draw to `buf` only
+// within `cover`, which a command about to be written overwrites entirely.
+// Must be called with the queue mutex held.
+static void pax_sasr_hide(pax_sasr_t *sasr, int band, pax_buf_t const *buf, pax_recti cover) {
+    pax_sasr_lane_t *lane  = &sasr->lanes[band];
+    size_t           head  = atomic_load_explicit(&lane->head, memory_order_relaxed);
+    size_t           start = lane->barrier > head ? lane->barrier : head;
+    size_t           end   = atomic_load_explicit(&lane->written, memory_order_relaxed);
+    pax_recti        rows  = {
+        0,
+        pax_sasr_band_start(buf->height, band),
+        buf->width,
+        pax_sasr_band_start(buf->height, band + 1) - pax_sasr_band_start(buf->height, band),
+    };
+    cover = pax_recti_intersect(cover, rows);
+
+    size_t hidden = 0;
+    bool   all    = true;
+    for (size_t pos = start; pos != end;) {
+        pax_sasr_cmd_t *cmd  = (pax_sasr_cmd_t *)(lane->ring + pos % PAX_SASR_RING_SIZE);
+        pos                 += cmd->size;
+        if (cmd->flags & (PAX_SASR_CMD_PAD | PAX_SASR_CMD_HIDDEN)) {
+            continue;
+        }
+        if (cmd->buffer == buf && pax_sasr_recti_contains(cover, pax_recti_intersect(cmd->bounds, rows))) {
+            cmd->flags |= PAX_SASR_CMD_HIDDEN;
+            hidden++;
+        } else {
+            all = false;
+        }
+    }
+
+    if (all && start != end) {
+        // Nothing after `start` is left to run, so reuse that part of the ring.
+        // The shaders of the discarded commands never reach the worker, so the next shaded command stores its own.
+        atomic_store_explicit(&lane->written, start, memory_order_relaxed);
+        lane->has_shader = false;
+    }
+    PAX_STATS_HIDE(hidden);
 }
 
-// Blit one or more characters of text in the bitmapped format.
-void pax_mcrw0_blit_char(pax_buf_t *buf, pax_col_t color, pax_vec2i pos, int scale, pax_text_rsdata_t rsdata) {
-    pax_sasr_blit_char_impl(0, buf, color, pos, scale, rsdata);
+// Queue a draw call.
+// The task's bounds are computed here so workers can skip tasks outside their band without any setup,
+// and so that changing the clip rectangle afterwards does not affect tasks that are already queued.
+// With more than one worker, the task is only sent to the lanes of the bands it touches.
+static void pax_sasr_queue(pax_sasr_t *sasr, pax_task_t *task) {
+    pax_buf_t const *buf = task->buffer;
+    if (task->type == PAX_TASK_BACKGROUND) {
+        // Background fills ignore the clip rectangle.
+        task->bounds = (pax_recti){0, 0, buf->width, buf->height};
+    } else {
+        task->bounds = pax_recti_intersect(pax_sasr_task_bounds(task), buf->clip);
+    }
+    if (task->bounds.w <= 0 || task->bounds.h <= 0) {
+        return;
+    }
+
+    // A deferred context discards the commands this one hides and wakes the workers when it is joined or fenced.
+    pax_recti cover = sasr->deferred ? pax_sasr_task_cover(task) : (pax_recti){0, 0, 0, 0};
+
+    // Publish the task to every band it touches before waking any of the workers up.
+    int first = n_lanes, last = -1;
+    pthread_mutex_lock(&sasr->queuemtx);
+    for (int i = 0; i < n_lanes; i++) {
+        int start = pax_sasr_band_start(buf->height, i);
+        int end   = pax_sasr_band_start(buf->height, i + 1);
+        if (start < end && start < task->bounds.y + task->bounds.h && end > task->bounds.y) {
+            if (cover.w > 0 && cover.y < end && cover.y + cover.h > start) {
+                pax_sasr_hide(sasr, i, buf, cover);
+            }
+            pax_sasr_push(sasr, i, task);
+            first = i < first ? i : first;
+            last  = i;
+        }
+    }
+    pthread_mutex_unlock(&sasr->queuemtx);
+    if (sasr->deferred) {
+        return;
+    }
+
+    // The bands are interleaved between the workers, so consecutive bands have different owners.
+    atomic_thread_fence(memory_order_seq_cst);
+    for (int i = first; i <= last && i < first + n_workers; i++) {
+        pax_sasr_wake(&workers[i % n_workers]);
+    }
 }
 
-// Draw a string of text in the bitmapped format.
-void pax_mcrw0_text(
-    pax_buf_t        *buf,
-    matrix_2d_t       matrix,
-    pax_col_t         color,
-    pax_font_t const *font,
-    float             font_size,
-    pax_vec2f         pos,
-    char const       *text,
-    size_t            text_len,
-    pax_align_t       halign,
-    pax_align_t       valign,
-    ptrdiff_t         cursorpos
-) {
-    pax_text_render_t ctx = {
-        .do_render   = true,
-        .renderfuncs = &pax_render_funcs_mcr_thread0,
-        .buf         = buf,
-        .color       = color,
-        .font        = font,
-        .font_size   = font_size,
-        .matrix      = matrix,
-    };
-    pax_internal_text_generic(&ctx, pos, text, text_len, cursorpos, halign, valign);
+// Perform a task using the software renderer.
+static void pax_sasr_exec(pax_task_t const *task) {
+    pax_render_funcs_t const *funcs = &pax_render_funcs_soft;
+    if (task->type == PAX_TASK_BACKGROUND) {
+        funcs->background(task->buffer, task->color);
+    } else if (task->type == PAX_TASK_QUAD) {
+        if (task->use_shader) {
+            funcs->shaded_quad(task->buffer, task->color, task->quadf.shape, &task->shader, task->quadf.uvs);
+        } else if (task->antialias) {
+            funcs->unshaded_quad_aa(task->buffer, task->color, task->quadf.shape);
+        } else {
+            funcs->unshaded_quad(task->buffer, task->color, task->quadf.shape);
+        }
+    } else if (task->type == PAX_TASK_RECT) {
+        if (task->use_shader) {
+            funcs->shaded_rect(task->buffer, task->color, task->rectf.shape, &task->shader, task->rectf.uvs);
+        } else {
+            funcs->unshaded_rect(task->buffer, task->color, task->rectf.shape);
+        }
+    } else if (task->type == PAX_TASK_TRI) {
+        if (task->use_shader) {
+            funcs->shaded_tri(task->buffer, task->color, task->trif.shape, &task->shader, task->trif.uvs);
+        } else if (task->antialias) {
+            funcs->unshaded_tri_aa(task->buffer, task->color, task->trif.shape);
+        } else {
+            funcs->unshaded_tri(task->buffer, task->color, task->trif.shape);
+        }
+    } else if (task->type == PAX_TASK_LINE) {
+        if (task->use_shader) {
+            funcs->shaded_line(task->buffer, task->color, task->linef.shape, &task->shader, task->linef.uvs);
+        } else {
+            funcs->unshaded_line(task->buffer, task->color, task->linef.shape);
+        }
+    } else if (task->type == PAX_TASK_SPRITE) {
+        funcs->sprite(task->buffer, task->blit.top, task->blit.base_pos, task->blit.top_orientation, task->blit.top_pos);
+    } else if (task->type == PAX_TASK_BLIT) {
+        funcs->blit(task->buffer, task->blit.top, task->blit.base_pos, task->blit.top_orientation, task->blit.top_pos);
+    } else if (task->type == PAX_TASK_BLIT_RAW) {
+        funcs->blit_raw(
+            task->buffer,
+            task->blit.top,
+            task->blit.top_dims,
+            task->blit.base_pos,
+            task->blit.top_orientation,
+            task->blit.top_pos
+        );
+    } else if (task->type == PAX_TASK_BLIT_CHAR) {
+        funcs->blit_char(task->buffer, task->color, task->blit_char.pos, task->blit_char.scale, task->blit_char.rsdata);
+    } else if (task->type == PAX_TASK_GLYPHS) {
+        for (pax_glyph_run_t const *run = task->glyphs; run; run = run->next) {
+            for (uint32_t i = 0; i < run->len; i++) {
+                pax_text_draw_glyph(funcs, task->buffer, task->color, &run->glyphs[i]);
+            }
+        }
+    } else if (task->type == PAX_TASK_POLY) {
+        funcs->unshaded_poly(task->buffer, task->color, task->polyf);
+    } else if (task->type == PAX_TASK_ELLIPSE) {
+        funcs->unshaded_ellipse(task->buffer, task->color, task->ellipsef);
+    } else if (task->type == PAX_TASK_ROUND_RECT) {
+        if (task->antialias) {
+            funcs->unshaded_round_rect_aa(task->buffer, task->color, task->round_rectf);
+        } else {
+            funcs->unshaded_round_rect(task->buffer, task->color, task->round_rectf);
+        }
+    } else if (task->type == PAX_TASK_SCALED_IMAGE) {
+        funcs->scaled_image(
+            task->buffer,
+            task->scaled_image.top,
+            task->scaled_image.base_pos,
+            task->scaled_image.top_orientation,
+            task->scaled_image.assume_opaque
+        );
+    }
 }
 
+// Background fill of the rows from `y0` up to but excluding `y1`.
+static void pax_sasr_background_rows(pax_buf_t *buf, pax_col_t color, int y0, int y1) {
+    uint32_t value;
+    if (buf->type_info.fmt_type == PAX_BUF_SUBTYPE_PALETTE) {
+        if (color > buf->palette_size)
+            value = 0;
+        else
+            value = color;
+    } else {
+        value = buf->col2buf(buf, color);
+    }
 
-// Background fill.
-void pax_mcrw1_background(pax_buf_t *buf, pax_col_t color) {
-    pax_sasr_background_impl(1, buf, color);
+    pax_fill_rows(buf, value, y0, y1);
+}
+
+// Copy the parts of a buffer that the software renderer reads.
+// The producer keeps changing the matrix stack and dirty area while workers run, so those are not copied.
+static void pax_sasr_band_buf(pax_buf_t *band, pax_buf_t const *buf) {
+    *band = (pax_buf_t){
+        .type               = buf->type,
+        .reverse_endianness = buf->reverse_endianness,
+        .buf                = buf->buf,
+        .type_info          = buf->type_info,
+        .palette            = buf->palette,
+        .palette_size       = buf->palette_size,
+        .width              = buf->width,
+        .height             = buf->height,
+        .col2buf            = buf->col2buf,
+        .buf2col            = buf->buf2col,
+        .setter             = buf->setter,
+        .getter             = buf->getter,
+        .range_setter       = buf->range_setter,
+        .range_merger       = buf->range_merger,
+        .orientation        = buf->orientation,
+    };
 }
 
-// Draw a solid-colored line.
-void pax_mcrw1_unshaded_line(pax_buf_t *buf, pax_col_t color, pax_linef shape) {
-    paxmcr_line_unshaded(1, buf, color, shape.x0, shape.y0, shape.x1, shape.y1);
-}
+// Perform a task, restricted to one band of rows.
+static void pax_sasr_exec_band(int index, pax_task_t *task) {
+    pax_buf_t *buf = task->buffer;
+    int        y0  = pax_sasr_band_start(buf->height, index);
+    int        y1  = pax_sasr_band_start(buf->height, index + 1);
 
-// Draw a solid-colored rectangle.
-void pax_mcrw1_unshaded_rect(pax_buf_t *buf, pax_col_t color, pax_rectf shape) {
-    paxmcr_rect_unshaded(1, buf, color, shape.x, shape.y, shape.w, shape.h);
-}
+    if (task->type == PAX_TASK_BACKGROUND) {
+        pax_sasr_background_rows(buf, task->color, y0, y1);
+        return;
+    }
 
-// Draw a solid-colored quad.
-void pax_mcrw1_unshaded_quad(pax_buf_t *buf, pax_col_t color, pax_quadf shape) {
-    paxmcr_quad_unshaded(1, buf, color, shape.x0, shape.y0, shape.x1, shape.y1, shape.x2, shape.y2, shape.x3, shape.y3);
+    // The software renderer respects the clip rectangle, so render into a copy that is clipped to this band.
+    // The task's bounds already include the clip rectangle as it was when the task was queued.
+    pax_buf_t band;
+    pax_sasr_band_buf(&band, buf);
+    band.clip = pax_recti_intersect(task->bounds, (pax_recti){0, y0, buf->width, y1 - y0});
+    if (band.clip.w <= 0 || band.clip.h <= 0) {
+        return;
+    }
+    task->buffer = &band;
+    pax_sasr_exec(task);
+    task->buffer = buf;
+}
+
+// Wake up any threads waiting in `pax_sasr_join` so they can re-check the workers' progress.
+// Must be preceded by a sequentially consistent fence after the worker's tail is updated.
+static void pax_sasr_notify_join(pax_sasr_t *sasr) {
+    if (atomic_load_explicit(&sasr->join_waiting, memory_order_relaxed)) {
+        pthread_mutex_lock(&sasr->joinmtx);
+        pthread_cond_broadcast(&sasr->joincond);
+        pthread_mutex_unlock(&sasr->joinmtx);
+    }
 }
 
-// Draw a solid-colored triangle.
-void pax_mcrw1_unshaded_tri(pax_buf_t *buf, pax_col_t color, pax_trif shape) {
-    paxmcr_tri_unshaded(1, buf, color, shape.x0, shape.y0, shape.x1, shape.y1, shape.x2, shape.y2);
+// Called by a worker when a lane reaches a fence; the last lane to reach it completes the fence.
+static void pax_sasr_pass_fence(pax_sasr_t *sasr, pax_sasr_fence_t *fence) {
+    // The slot may be reused as soon as `remaining` reaches 0, so copy the fence first.
+    uint64_t       seq      = fence->seq;
+    pax_fence_cb_t callback = fence->callback;
+    void          *cookie   = fence->cookie;
+    if (atomic_fetch_sub_explicit(&fence->remaining, 1, memory_order_acq_rel) != 1) {
+        return;
+    }
+    if (callback) {
+        callback(cookie);
+    }
+    atomic_store(&sasr->fence_done, seq);
+    // Pairs with the fence in `pax_sasr_wait_fence`.
+    atomic_thread_fence(memory_order_seq_cst);
+    pax_sasr_notify_join(sasr);
+}
+
+// Whether the next task in a lane is ready to be read.
+static inline bool pax_sasr_lane_ready(pax_sasr_lane_t *lane) {
+    return atomic_load_explicit(&lane->tail, memory_order_relaxed)
+           != atomic_load_explicit(&lane->head, memory_order_acquire);
+}
+
+// Whether any render context has tasks ready that no worker is running.
+static bool pax_sasr_has_work() {
+    int count = atomic_load_explicit(&n_contexts, memory_order_acquire);
+    for (int i = 0; i < count; i++) {
+        for (int j = 0; j < n_lanes; j++) {
+            pax_sasr_lane_t *lane = &contexts[i]->lanes[j];
+            if (pax_sasr_lane_ready(lane) && !atomic_load_explicit(&lane->busy, memory_order_relaxed)) {
+                return true;
+            }
+        }
+    }
+    return false;
 }
 
-// Draw a line with a shader.
-void pax_mcrw1_shaded_line(pax_buf_t *buf, pax_col_t color, pax_linef shape, pax_shader_t const *shader, pax_linef uv) {
-    paxmcr_line_shaded(1, buf, color, shader, shape.x0, shape.y0, shape.x1, shape.y1, uv.x0, uv.y0, uv.x1, uv.y1);
-}
+// Run up to `PAX_SASR_BATCH_SIZE` tasks from one lane of a render context, unless another worker is running it.
+// Returns whether any tasks were run.
+static bool pax_sasr_run_lane(pax_sasr_t *sasr, int band) {
+    pax_sasr_lane_t *lane = &sasr->lanes[band];
+    if (!pax_sasr_lane_ready(lane) || atomic_exchange_explicit(&lane->busy, true, memory_order_acquire)) {
+        return false;
+    }
+    size_t pos  = atomic_load_explicit(&lane->tail, memory_order_relaxed);
+    size_t head = atomic_load_explicit(&lane->head, memory_order_acquire);
+    int    done = 0;
+
+    while (done < PAX_SASR_BATCH_SIZE) {
+        if (pos == head) {
+            head = atomic_load_explicit(&lane->head, memory_order_acquire);
+            if (pos == head) {
+                break;
+            }
+        }
+        pax_sasr_cmd_t const *cmd  = (pax_sasr_cmd_t const *)(lane->ring + pos % PAX_SASR_RING_SIZE);
+        pos                       += cmd->size;
+        if (cmd->flags & PAX_SASR_CMD_PAD) {
+            // Producers publish padding together with the command after it.
+            continue;
+        }
+        pax_task_t task;
+        pax_sasr_decode(lane, cmd, &task);
+
+        if (task.type == PAX_TASK_FENCE) {
+            pax_sasr_pass_fence(sasr, task.fence);
+        } else if (!(cmd->flags & PAX_SASR_CMD_HIDDEN)) {
+            PAX_STATS_START(start);
+            pax_sasr_exec_band(band, &task);
+            PAX_STATS_EXEC(task.type, band % n_workers, start);
+        }
 
-// Draw a rectangle with a shader.
-void pax_mcrw1_shaded_rect(pax_buf_t *buf, pax_col_t color, pax_rectf shape, pax_shader_t const *shader, pax_quadf uv) {
-    // clang-format off
-    paxmcr_rect_shaded(
-        1, buf, color, shader,
-        shape.x, shape.y, shape.w, shape.h,
-        uv.x0, uv.y0, uv.x1, uv.y1, uv.x2, uv.y2, uv.x3, uv.y3
-    );
-    // clang-format on
-}
+        atomic_store_explicit(&lane->tail, pos, memory_order_release);
+        done++;
+    }
+    atomic_store_explicit(&lane->busy, false, memory_order_release);
 
-// Draw a quad with a shader.
-void pax_mcrw1_shaded_quad(pax_buf_t *buf, pax_col_t color, pax_quadf shape, pax_shader_t const *shader, pax_quadf uv) {
-    // clang-format off
-    paxmcr_quad_shaded(
-        1, buf, color, shader,
-        shape.x0, shape.y0, shape.x1, shape.y1, shape.x2, shape.y2, shape.x3, shape.y3,
-        uv.x0, uv.y0, uv.x1, uv.y1, uv.x2, uv.y2, uv.x3, uv.y3
-    );
-    // clang-format on
+    if (done && !pax_sasr_lane_ready(lane)) {
+        // The lane ran dry; the fence pairs with the one in `pax_sasr_join`.
+        atomic_thread_fence(memory_order_seq_cst);
+        pax_sasr_notify_join(sasr);
+    }
+    return done;
 }
 
-// Draw a triangle with a shader.
-void pax_mcrw1_shaded_tri(pax_buf_t *buf, pax_col_t color, pax_trif shape, pax_shader_t const *shader, pax_trif uv) {
-    // clang-format off
-    paxmcr_tri_shaded(
-        1, buf, color, shader,
-        shape.x0, shape.y0, shape.x1, shape.y1, shape.x2, shape.y2,
-        uv.x0, uv.y0, uv.x1, uv.y1, uv.x2, uv.y2
-    );
-    // clang-format on
-}
+// Called by a worker that has run out of tasks; waits for new tasks or for the pool to stop.
+static void pax_sasr_idle(pax_sasr_worker_t *worker) {
+    // Poll for a short while, new tasks often arrive right away.
+    for (int i = 0; i < PAX_SASR_SPIN_COUNT; i++) {
+        if (pax_sasr_has_work() || atomic_load_explicit(&pool_stop, memory_order_relaxed)) {
+            return;
+        }
+        sched_yield();
+    }
 
-// Draw an axis-aligned image with fractional scaling.
-void pax_mcrw1_scaled_image(
-    pax_buf_t *base, pax_buf_t const *top, pax_recti base_pos, pax_orientation_t top_orientation, bool assume_opaque
-) {
-    pax_sasr_scaled_image_impl(1, base, top, base_pos, top_orientation, assume_opaque);
+    // Go to sleep until a producer wakes us up.
+    pthread_mutex_lock(&worker->mtx);
+    atomic_store(&worker->sleeping, true);
+    // Pairs with the fence in `pax_sasr_queue` so that either side sees the other's write.
+    atomic_thread_fence(memory_order_seq_cst);
+    while (!pax_sasr_has_work() && !atomic_load(&pool_stop)) {
+        pthread_cond_wait(&worker->cond, &worker->mtx);
+    }
+    atomic_store_explicit(&worker->sleeping, false, memory_order_relaxed);
+    pthread_mutex_unlock(&worker->mtx);
 }
 
-// Draw a sprite; like a blit, but use color blending if applicable.
-void pax_mcrw1_sprite(
-    pax_buf_t *base, pax_buf_t const *top, pax_recti base_pos, pax_orientation_t top_orientation, pax_vec2i top_pos
-) {
-    pax_sasr_sprite_impl(1, base, top, base_pos, top_orientation, top_pos);
-}
+    #if CONFIG_PAX_USE_FREERTOS
+// Worker thread function for software async renderer.
+static void pax_sasr_worker(void *_args)
+    #else
+// Worker thread function for software async renderer.
+static void *pax_sasr_worker(void *_args)
+    #endif
+{
+    pax_sasr_worker_t *worker = _args;
+    PAX_STATS_WORKER_START(worker->index);
 
-// Perform a buffer copying operation with a PAX buffer.
-void pax_mcrw1_blit(
-    pax_buf_t *base, pax_buf_t const *top, pax_recti base_pos, pax_orientation_t top_orientation, pax_vec2i top_pos
-) {
-    pax_sasr_blit_impl(1, base, top, base_pos, top_orientation, top_pos);
-}
+    while (1) {
+        // Take turns between the render contexts so that one busy context can't starve the others.
+        bool busy  = false;
+        int  count = atomic_load_explicit(&n_contexts, memory_order_acquire);
+        for (int i = 0; i < count; i++) {
+            for (int j = worker->index; j < n_lanes; j += n_workers) {
+                busy |= pax_sasr_run_lane(contexts[i], j);
+            }
+        }
+        if (busy) {
+            continue;
+        }
 
-// Perform a buffer copying operation with an unmanaged user buffer.
-void pax_mcrw1_blit_raw(
-    pax_buf_t        *base,
-    void const       *top,
-    pax_vec2i         top_dims,
-    pax_recti         base_pos,
-    pax_orientation_t top_orientation,
-    pax_vec2i         top_pos
-) {
-    pax_sasr_blit_raw_impl(1, base, top, top_dims, base_pos, top_orientation, top_pos);
-}
+        // Out of tasks of our own; steal from the bands of other workers, starting with the next worker's.
+        for (int i = 0; i < count; i++) {
+            for (int j = 1; j < n_lanes; j++) {
+                busy |= pax_sasr_run_lane(contexts[i], (worker->index + j) % n_lanes);
+            }
+        }
+        if (busy) {
+            continue;
+        }
 
-// Blit one or more characters of text in the bitmapped format.
-void pax_mcrw1_blit_char(pax_buf_t *buf, pax_col_t color, pax_vec2i pos, int scale, pax_text_rsdata_t rsdata) {
-    pax_sasr_blit_char_impl(1, buf, color, pos, scale, rsdata);
-}
+        if (atomic_load(&pool_stop) && !pax_sasr_has_work()) {
+            break;
+        }
+        pax_sasr_idle(worker);
+    }
 
-// Draw a string of text in the bitmapped format.
-void pax_mcrw1_text(
-    pax_buf_t        *buf,
-    matrix_2d_t       matrix,
-    pax_col_t         color,
-    pax_font_t const *font,
-    float             font_size,
-    pax_vec2f         pos,
-    char const       *text,
-    size_t            text_len,
-    pax_align_t       halign,
-    pax_align_t       valign,
-    ptrdiff_t         cursorpos
-) {
-    pax_text_render_t ctx = {
-        .do_render   = true,
-        .renderfuncs = &pax_render_funcs_mcr_thread1,
-        .buf         = buf,
-        .color       = color,
-        .font        = font,
-        .font_size   = font_size,
-        .matrix      = matrix,
-    };
-    pax_internal_text_generic(&ctx, pos, text, text_len, cursorpos, halign, valign);
+    pthread_mutex_lock(&pool_mtx);
+    pool_running--;
+    pthread_cond_broadcast(&pool_cond);
+    pthread_mutex_unlock(&pool_mtx);
+    #if CONFIG_PAX_USE_FREERTOS
+    vTaskDelete(NULL);
+    #else
+    return NULL;
+    #endif
 }
 
-    #endif
 
 
 // Background fill.
@@ -1119,7 +1449,7 @@ void pax_sasr_background(pax_buf_t *buf, pax_col_t color) {
         .type   = PAX_TASK_BACKGROUND,
         .color  = color,
     };
-    pax_sasr_queue(&task);
+    pax_sasr_queue(pax_sasr_get(task.buffer), &task);
 }
 
 // Draw a solid-colored line.
@@ -1131,7 +1461,7 @@ void pax_sasr_unshaded_line(pax_buf_t *buf, pax_col_t color, pax_linef shape) {
         .use_shader  = false,
         .linef.shape = shape,
     };
-    pax_sasr_queue(&task);
+    pax_sasr_queue(pax_sasr_get(task.buffer), &task);
 }
 
 // Draw a solid-colored rectangle.
@@ -1143,7 +1473,7 @@ void pax_sasr_unshaded_rect(pax_buf_t *buf, pax_col_t color, pax_rectf shape) {
         .use_shader  = false,
         .rectf.shape = shape,
     };
-    pax_sasr_queue(&task);
+    pax_sasr_queue(pax_sasr_get(task.buffer), &task);
 }
 
 // Draw a solid-colored quad.
@@ -1155,7 +1485,7 @@ void pax_sasr_unshaded_quad(pax_buf_t *buf, pax_col_t color, pax_quadf shape) {
         .use_shader  = false,
         .quadf.shape = shape,
     };
-    pax_sasr_queue(&task);
+    pax_sasr_queue(pax_sasr_get(task.buffer), &task);
 }
 
 // Draw a solid-colored triangle.
@@ -1167,7 +1497,98 @@ void pax_sasr_unshaded_tri(pax_buf_t *buf, pax_col_t color, pax_trif shape) {
         .use_shader = false,
         .trif.shape = shape,
     };
-    pax_sasr_queue(&task);
+    pax_sasr_queue(pax_sasr_get(task.buffer), &task);
+}
+
+// Draw a solid-colored quad with anti-aliased edges.
+void pax_sasr_unshaded_quad_aa(pax_buf_t *buf, pax_col_t color, pax_quadf shape) {
+    pax_task_t task = {
+        .buffer      = buf,
+        .type        = PAX_TASK_QUAD,
+        .color       = color,
+        .use_shader  = false,
+        .antialias   = true,
+        .quadf.shape = shape,
+    };
+    pax_sasr_queue(pax_sasr_get(task.buffer), &task);
+}
+
+// Draw a solid-colored triangle with anti-aliased edges.
+void pax_sasr_unshaded_tri_aa(pax_buf_t *buf, pax_col_t color, pax_trif shape) {
+    pax_task_t task = {
+        .buffer     = buf,
+        .type       = PAX_TASK_TRI,
+        .color      = color,
+        .use_shader = false,
+        .antialias  = true,
+        .trif.shape = shape,
+    };
+    pax_sasr_queue(pax_sasr_get(task.buffer), &task);
+}
+
+// Draw a solid-colored polygon.
+// The points and contour lengths are copied to the arena, because `shape` only lives until this returns.
+void pax_sasr_unshaded_poly(pax_buf_t *buf, pax_col_t color, pax_polyf shape) {
+    pax_sasr_t *sasr     = pax_sasr_get(buf);
+    size_t      n_points = 0;
+    for (size_t i = 0; i < shape.n_contours; i++) {
+        n_points += shape.contour_lens[i];
+    }
+    // Keeps `pax_sasr_join` from resetting the arena until the task is queued.
+    atomic_fetch_add(&sasr->arena.producers, 1);
+    size_t *mem = pax_sasr_arena_alloc(sasr, shape.n_contours * sizeof(size_t) + n_points * sizeof(pax_vec2f));
+    if (!mem) {
+        pax_set_err(PAX_ERR_NOMEM);
+        atomic_fetch_sub(&sasr->arena.producers, 1);
+        return;
+    }
+    memcpy(mem, shape.contour_lens, shape.n_contours * sizeof(size_t));
+    memcpy(mem + shape.n_contours, shape.points, n_points * sizeof(pax_vec2f));
+    shape.contour_lens = mem;
+    shape.points       = (pax_vec2f const *)(mem + shape.n_contours);
+
+    pax_task_t task = {
+        .buffer = buf,
+        .type   = PAX_TASK_POLY,
+        .color  = color,
+        .polyf  = shape,
+    };
+    pax_sasr_queue(sasr, &task);
+    atomic_fetch_sub(&sasr->arena.producers, 1);
+}
+
+// Draw a solid-colored ellipse or elliptic ring.
+void pax_sasr_unshaded_ellipse(pax_buf_t *buf, pax_col_t color, pax_ellipsef shape) {
+    pax_task_t task = {
+        .buffer   = buf,
+        .type     = PAX_TASK_ELLIPSE,
+        .color    = color,
+        .ellipsef = shape,
+    };
+    pax_sasr_queue(pax_sasr_get(task.buffer), &task);
+}
+
+// Draw a solid-colored rectangle with rounded corners.
+void pax_sasr_unshaded_round_rect(pax_buf_t *buf, pax_col_t color, pax_round_rectf shape) {
+    pax_task_t task = {
+        .buffer      = buf,
+        .type        = PAX_TASK_ROUND_RECT,
+        .color       = color,
+        .round_rectf = shape,
+    };
+    pax_sasr_queue(pax_sasr_get(task.buffer), &task);
+}
+
+// Draw a solid-colored rectangle with rounded corners and anti-aliased edges.
+void pax_sasr_unshaded_round_rect_aa(pax_buf_t *buf, pax_col_t color, pax_round_rectf shape) {
+    pax_task_t task = {
+        .buffer      = buf,
+        .type        = PAX_TASK_ROUND_RECT,
+        .color       = color,
+        .antialias   = true,
+        .round_rectf = shape,
+    };
+    pax_sasr_queue(pax_sasr_get(task.buffer), &task);
 }
 
 
@@ -1182,7 +1603,7 @@ void pax_sasr_shaded_line(pax_buf_t *buf, pax_col_t color, pax_linef shape, pax_
         .linef.shape = shape,
         .linef.uvs   = uv,
     };
-    pax_sasr_queue(&task);
+    pax_sasr_queue(pax_sasr_get(task.buffer), &task);
 }
 
 // Draw a rectangle with a shader.
@@ -1196,7 +1617,7 @@ void pax_sasr_shaded_rect(pax_buf_t *buf, pax_col_t color, pax_rectf shape, pax_
         .rectf.shape = shape,
         .rectf.uvs   = uv,
     };
-    pax_sasr_queue(&task);
+    pax_sasr_queue(pax_sasr_get(task.buffer), &task);
 }
 
 // Draw a quad with a shader.
@@ -1210,7 +1631,7 @@ void pax_sasr_shaded_quad(pax_buf_t *buf, pax_col_t color, pax_quadf shape, pax_
         .quadf.shape = shape,
         .quadf.uvs   = uv,
     };
-    pax_sasr_queue(&task);
+    pax_sasr_queue(pax_sasr_get(task.buffer), &task);
 }
 
 // Draw a triangle with a shader.
@@ -1224,7 +1645,7 @@ void pax_sasr_shaded_tri(pax_buf_t *buf, pax_col_t color, pax_trif shape, pax_sh
         .trif.shape = shape,
         .trif.uvs   = uv,
     };
-    pax_sasr_queue(&task);
+    pax_sasr_queue(pax_sasr_get(task.buffer), &task);
 }
 
 
@@ -1243,7 +1664,7 @@ void pax_sasr_scaled_image(
             .assume_opaque   = assume_opaque,
         },
     };
-    pax_sasr_queue(&task);
+    pax_sasr_queue(pax_sasr_get(task.buffer), &task);
 }
 
 // Draw a sprite; like a blit, but use color blending if applicable.
@@ -1260,7 +1681,7 @@ void pax_sasr_sprite(
         },
         .blit.base_pos = base_pos,
     };
-    pax_sasr_queue(&task);
+    pax_sasr_queue(pax_sasr_get(task.buffer), &task);
 }
 
 // Perform a buffer copying operation with a PAX buffer.
@@ -1277,7 +1698,7 @@ void pax_sasr_blit(
         },
         .blit.base_pos = base_pos,
     };
-    pax_sasr_queue(&task);
+    pax_sasr_queue(pax_sasr_get(task.buffer), &task);
 }
 
 // Perform a buffer copying operation with an unmanaged user buffer.
@@ -1300,7 +1721,7 @@ void pax_sasr_blit_raw(
         },
         .blit.base_pos = base_pos,
     };
-    pax_sasr_queue(&task);
+    pax_sasr_queue(pax_sasr_get(task.buffer), &task);
 }
 
 // Blit one or more characters of text in the bitmapped format.
@@ -1315,10 +1736,60 @@ void pax_sasr_blit_char(pax_buf_t *buf, pax_col_t color, pax_vec2i pos, int scal
             .scale  = scale,
         },
     };
-    pax_sasr_queue(&task);
+    pax_sasr_queue(pax_sasr_get(task.buffer), &task);
+}
+
+// Add a glyph laid out by the text renderer to the glyph run being built by `pax_sasr_text`.
+static void pax_sasr_layout_glyph(void *args, pax_text_glyph_t const *glyph) {
+    pax_sasr_layout_t *layout = args;
+    if (!layout->run) {
+        return;
+    }
+    if (layout->tail->len >= layout->cap) {
+        pax_glyph_run_t *chunk = pax_sasr_arena_alloc(
+            layout->sasr,
+            sizeof(pax_glyph_run_t) + PAX_SASR_GLYPH_RUN_CAP * sizeof(pax_text_glyph_t)
+        );
+        if (!chunk) {
+            layout->run = NULL;
+            pax_set_err(PAX_ERR_NOMEM);
+            return;
+        }
+        chunk->next        = NULL;
+        chunk->len         = 0;
+        layout->tail->next = chunk;
+        layout->tail       = chunk;
+        layout->cap        = PAX_SASR_GLYPH_RUN_CAP;
+    }
+    layout->tail->glyphs[layout->tail->len++] = *glyph;
+
+    // Grow the bounds of the run to include this glyph.
+    pax_vec2f points[4];
+    size_t    n_points = 2;
+    if (glyph->type == PAX_GLYPH_BLIT_CHAR) {
+        pax_recti rect
+            = pax_sasr_blit_char_bounds(layout->buf, glyph->blit_char.pos, glyph->blit_char.scale, glyph->rsdata);
+        points[0] = (pax_vec2f){rect.x, rect.y};
+        points[1] = (pax_vec2f){rect.x + rect.w, rect.y + rect.h};
+    } else if (glyph->type == PAX_GLYPH_RECT) {
+        points[0] = (pax_vec2f){glyph->rect.x, glyph->rect.y};
+        points[1] = (pax_vec2f){glyph->rect.x + glyph->rect.w, glyph->rect.y + glyph->rect.h};
+    } else if (glyph->type == PAX_GLYPH_QUAD) {
+        memcpy(points, &glyph->quad, sizeof(pax_quadf));
+        n_points = 4;
+    } else {
+        memcpy(points, &glyph->line, sizeof(pax_linef));
+    }
+    for (size_t i = 0; i < n_points; i++) {
+        layout->min.x = fminf(layout->min.x, points[i].x);
+        layout->min.y = fminf(layout->min.y, points[i].y);
+        layout->max.x = fmaxf(layout->max.x, points[i].x);
+        layout->max.y = fmaxf(layout->max.y, points[i].y);
+    }
 }
 
 // Draw a string of text in the bitmapped format.
+// The text is laid out here, once, so the workers only need to rasterize the resulting glyphs.
 void pax_sasr_text(
     pax_buf_t        *buf,
     matrix_2d_t       matrix,
@@ -1332,104 +1803,221 @@ void pax_sasr_text(
     pax_align_t       valign,
     ptrdiff_t         cursorpos
 ) {
-    pax_task_str_t str;
-    str.len = text_len;
-    if (text_len <= PAX_SSO_BUF_LEN) {
-        memcpy(str.sso, text, text_len);
-    } else {
-        str.ptr = malloc(sizeof(pax_rcstr_t) + text_len);
-        memcpy(str.ptr->data, text, text_len);
-        atomic_store(&str.ptr->refcount, is_multithreaded + 1);
+    pax_sasr_t *sasr = pax_sasr_get(buf);
+    // Keeps `pax_sasr_join` from resetting the arena until the task is queued.
+    atomic_fetch_add(&sasr->arena.producers, 1);
+
+    // Every glyph takes at least one byte, plus there may be a cursor.
+    pax_sasr_layout_t layout = {
+        .buf   = buf,
+        .sasr  = sasr,
+        .cap   = text_len < PAX_SASR_GLYPH_RUN_CAP ? text_len + 1 : PAX_SASR_GLYPH_RUN_CAP,
+        .min   = {INFINITY, INFINITY},
+        .max   = {-INFINITY, -INFINITY},
+    };
+    layout.run = pax_sasr_arena_alloc(sasr, sizeof(pax_glyph_run_t) + layout.cap * sizeof(pax_text_glyph_t));
+    if (!layout.run) {
+        pax_set_err(PAX_ERR_NOMEM);
+        atomic_fetch_sub(&sasr->arena.producers, 1);
+        return;
     }
-    pax_task_t task = {
-        .buffer         = buf,
-        .type           = PAX_TASK_TEXT,
-        .color          = color,
-        .text_matrix    = matrix,
-        .text.font      = font,
-        .text.font_size = font_size,
-        .text.pos       = pos,
-        .text.halign    = halign,
-        .text.valign    = valign,
-        .text.cursorpos = cursorpos,
-        .text.str       = str,
+    layout.run->next = NULL;
+    layout.run->len  = 0;
+    layout.tail      = layout.run;
+
+    pax_text_render_t ctx = {
+        .do_render  = true,
+        .buf        = buf,
+        .color      = color,
+        .font       = font,
+        .font_size  = font_size,
+        .matrix     = matrix,
+        .glyph_cb   = pax_sasr_layout_glyph,
+        .glyph_args = &layout,
     };
-    pax_sasr_queue(&task);
+    pax_internal_text_generic(&ctx, pos, text, text_len, cursorpos, halign, valign);
+
+    if (layout.run) {
+        // Give back the room for glyphs that turned out not to be needed.
+        pax_sasr_arena_shrink(
+            &sasr->arena,
+            layout.tail,
+            sizeof(pax_glyph_run_t) + layout.cap * sizeof(pax_text_glyph_t),
+            sizeof(pax_glyph_run_t) + layout.tail->len * sizeof(pax_text_glyph_t)
+        );
+    }
+    if (layout.run && layout.run->len) {
+        pax_task_t task = {
+            .buffer = buf,
+            .type   = PAX_TASK_GLYPHS,
+            .color  = color,
+            .bounds = pax_sasr_points_bounds(buf, (pax_vec2f[]){layout.min, layout.max}, 2),
+            .glyphs = layout.run,
+        };
+        pax_sasr_queue(sasr, &task);
+    }
+    atomic_fetch_sub(&sasr->arena.producers, 1);
 }
 
 
 
+// Reset the arena of a render context, unless there are still tasks that might use it.
+static void pax_sasr_arena_reset(pax_sasr_t *sasr) {
+    pax_sasr_arena_t *arena = &sasr->arena;
+    pthread_mutex_lock(&arena->mtx);
+    // Producers stay counted until their tasks are queued, after which the lanes are no longer empty.
+    bool idle = !atomic_load(&arena->producers);
+    for (int i = 0; idle && i < n_lanes; i++) {
+        idle = atomic_load(&sasr->lanes[i].tail) == atomic_load(&sasr->lanes[i].written);
+    }
+    if (idle) {
+        for (pax_sasr_block_t *block = arena->blocks; block; block = block->next) {
+            block->used  = 0;
+            block->fence = 0;
+        }
+        // A fence may have just ended the frame, in which case there is no new one to count.
+        if (arena->stats.used) {
+            arena->stats.last_frame  = arena->stats.used;
+            arena->stats.used        = 0;
+            arena->stats.frames     += 1;
+        }
+    }
+    pthread_mutex_unlock(&arena->mtx);
+}
+
 // Wait for all pending draw calls to finish.
-void pax_sasr_join() {
-    pthread_mutex_lock(&joinmtx);
-    int count = atomic_exchange_explicit(&outstanding, 0, memory_order_relaxed);
-    while (count--) {
-        sem_wait(&complete_sem);
+// Only waits for the draw calls of this render context; workers notify it when they run out of its tasks.
+void pax_sasr_join(void *state) {
+    pax_sasr_t *sasr = state;
+    if (sasr->deferred) {
+        // Let the workers start on the tasks held back so far.
+        pthread_mutex_lock(&sasr->queuemtx);
+        for (int i = 0; i < n_lanes; i++) {
+            pax_sasr_publish(&sasr->lanes[i]);
+        }
+        pthread_mutex_unlock(&sasr->queuemtx);
+        atomic_thread_fence(memory_order_seq_cst);
+        for (int i = 0; i < n_workers; i++) {
+            pax_sasr_wake(&workers[i]);
+        }
+    }
+
+    size_t targets[PAX_SASR_MAX_LANES];
+    for (int i = 0; i < n_lanes; i++) {
+        targets[i] = atomic_load_explicit(&sasr->lanes[i].head, memory_order_relaxed);
+    }
+
+    pthread_mutex_lock(&sasr->joinmtx);
+    atomic_fetch_add(&sasr->join_waiting, 1);
+    for (int i = 0; i < n_lanes; i++) {
+        while (atomic_load_explicit(&sasr->lanes[i].tail, memory_order_acquire) < targets[i]) {
+            pthread_cond_wait(&sasr->joincond, &sasr->joinmtx);
+        }
     }
-    pthread_mutex_unlock(&joinmtx);
+    atomic_fetch_sub(&sasr->join_waiting, 1);
+    pthread_mutex_unlock(&sasr->joinmtx);
+
+    pax_sasr_arena_reset(sasr);
 }
 
+// Insert a fence after all draw calls queued so far.
+// The fence is queued to every lane; the last one to reach it completes it.
+uint64_t pax_sasr_insert_fence(void *state, pax_fence_cb_t callback, void *cookie) {
+    pax_sasr_t *sasr = state;
+    pthread_mutex_lock(&sasr->queuemtx);
 
+    // Wait for the fence that used this slot before to complete.
+    pax_sasr_fence_t *fence = &sasr->fences[sasr->n_fences++ % CONFIG_PAX_QUEUE_SIZE];
+    while (atomic_load_explicit(&fence->remaining, memory_order_acquire)) {
+        sched_yield();
+    }
+    uint64_t seq    = atomic_fetch_add(&fence_seq, 1) + 1;
+    fence->seq      = seq;
+    fence->callback = callback;
+    fence->cookie   = cookie;
+    atomic_store_explicit(&fence->remaining, n_lanes, memory_order_relaxed);
+    pax_sasr_arena_retire(sasr, seq);
+
+    // Publish the fence to every lane before waking any of the workers up.
+    pax_task_t task = {
+        .type  = PAX_TASK_FENCE,
+        .fence = fence,
+    };
+    for (int i = 0; i < n_lanes; i++) {
+        pax_sasr_push(sasr, i, &task);
+        // A deferred context holds tasks back only until the next fence.
+        pax_sasr_publish(&sasr->lanes[i]);
+    }
+    atomic_thread_fence(memory_order_seq_cst);
+    for (int i = 0; i < n_workers; i++) {
+        pax_sasr_wake(&workers[i]);
+    }
+
+    pthread_mutex_unlock(&sasr->queuemtx);
+    return seq;
+}
+
+// Check whether a fence has completed, first waiting for it to complete if `block` is true.
+bool pax_sasr_wait_fence(void *state, uint64_t fence, bool block) {
+    pax_sasr_t *sasr = state;
+    if (atomic_load(&sasr->fence_done) >= fence) {
+        return true;
+    } else if (!block) {
+        return false;
+    }
+
+    pthread_mutex_lock(&sasr->joinmtx);
+    atomic_fetch_add(&sasr->join_waiting, 1);
+    while (atomic_load(&sasr->fence_done) < fence) {
+        pthread_cond_wait(&sasr->joincond, &sasr->joinmtx);
+    }
+    atomic_fetch_sub(&sasr->join_waiting, 1);
+    pthread_mutex_unlock(&sasr->joinmtx);
+    return true;
+}
+
+// Get the arena statistics of a render context.
+// Returns `false` if `ctx` does not use the async renderer.
+bool pax_sasr_get_arena_stats(pax_render_ctx_t const *ctx, pax_sasr_arena_stats_t *out) {
+    if (!ctx || ctx->engine != &pax_render_engine_softasync) {
+        return false;
+    }
+    pax_sasr_arena_t *arena = &((pax_sasr_t *)ctx->state)->arena;
+    pthread_mutex_lock(&arena->mtx);
+    *out = arena->stats;
+    pthread_mutex_unlock(&arena->mtx);
+    return true;
+}
 
-// Async software rendering functions.
-pax_render_funcs_t const pax_render_funcs_softasync = {
-    .background    = pax_sasr_background,
-    .unshaded_line = pax_sasr_unshaded_line,
-    .unshaded_rect = pax_sasr_unshaded_rect,
-    .unshaded_quad = pax_sasr_unshaded_quad,
-    .unshaded_tri  = pax_sasr_unshaded_tri,
-    .shaded_line   = pax_sasr_shaded_line,
-    .shaded_rect   = pax_sasr_shaded_rect,
-    .shaded_quad   = pax_sasr_shaded_quad,
-    .shaded_tri    = pax_sasr_shaded_tri,
-    .scaled_image  = pax_sasr_scaled_image,
-    .sprite        = pax_sasr_sprite,
-    .blit          = pax_sasr_blit,
-    .blit_raw      = pax_sasr_blit_raw,
-    .blit_char     = pax_sasr_blit_char,
-    .join          = pax_sasr_join,
-    .text          = pax_sasr_text,
-};
 
-    #if CONFIG_PAX_COMPILE_ASYNC_RENDERER == 2
-// Async software rendering functions.
-pax_render_funcs_t const pax_render_funcs_mcr_thread0 = {
-    .background    = pax_mcrw0_background,
-    .unshaded_line = pax_mcrw0_unshaded_line,
-    .unshaded_rect = pax_mcrw0_unshaded_rect,
-    .unshaded_quad = pax_mcrw0_unshaded_quad,
-    .unshaded_tri  = pax_mcrw0_unshaded_tri,
-    .shaded_line   = pax_mcrw0_shaded_line,
-    .shaded_rect   = pax_mcrw0_shaded_rect,
-    .shaded_quad   = pax_mcrw0_shaded_quad,
-    .shaded_tri    = pax_mcrw0_shaded_tri,
-    .scaled_image  = pax_mcrw0_scaled_image,
-    .sprite        = pax_mcrw0_sprite,
-    .blit          = pax_mcrw0_blit,
-    .blit_raw      = pax_mcrw0_blit_raw,
-    .blit_char     = pax_mcrw0_blit_char,
-    .text          = pax_mcrw0_text,
-};
 
 // Async software rendering functions.
-pax_render_funcs_t const pax_render_funcs_mcr_thread1 = {
-    .background    = pax_mcrw1_background,
-    .unshaded_line = pax_mcrw1_unshaded_line,
-    .unshaded_rect = pax_mcrw1_unshaded_rect,
-    .unshaded_quad = pax_mcrw1_unshaded_quad,
-    .unshaded_tri  = pax_mcrw1_unshaded_tri,
-    .shaded_line   = pax_mcrw1_shaded_line,
-    .shaded_rect   = pax_mcrw1_shaded_rect,
-    .shaded_quad   = pax_mcrw1_shaded_quad,
-    .shaded_tri    = pax_mcrw1_shaded_tri,
-    .scaled_image  = pax_mcrw1_scaled_image,
-    .sprite        = pax_mcrw1_sprite,
-    .blit          = pax_mcrw1_blit,
-    .blit_raw      = pax_mcrw1_blit_raw,
-    .blit_char     = pax_mcrw1_blit_char,
-    .text          = pax_mcrw1_text,
+pax_render_funcs_t const pax_render_funcs_softasync = {
+    .background             = pax_sasr_background,
+    .unshaded_line          = pax_sasr_unshaded_line,
+    .unshaded_rect          = pax_sasr_unshaded_rect,
+    .unshaded_quad          = pax_sasr_unshaded_quad,
+    .unshaded_tri           = pax_sasr_unshaded_tri,
+    .unshaded_quad_aa       = pax_sasr_unshaded_quad_aa,
+    .unshaded_tri_aa        = pax_sasr_unshaded_tri_aa,
+    .unshaded_poly          = pax_sasr_unshaded_poly,
+    .unshaded_ellipse       = pax_sasr_unshaded_ellipse,
+    .unshaded_round_rect    = pax_sasr_unshaded_round_rect,
+    .unshaded_round_rect_aa = pax_sasr_unshaded_round_rect_aa,
+    .shaded_line            = pax_sasr_shaded_line,
+    .shaded_rect            = pax_sasr_shaded_rect,
+    .shaded_quad            = pax_sasr_shaded_quad,
+    .shaded_tri             = pax_sasr_shaded_tri,
+    .scaled_image           = pax_sasr_scaled_image,
+    .sprite                 = pax_sasr_sprite,
+    .blit                   = pax_sasr_blit,
+    .blit_raw               = pax_sasr_blit_raw,
+    .blit_char              = pax_sasr_blit_char,
+    .join                   = pax_sasr_join,
+    .text                   = pax_sasr_text,
+    .insert_fence           = pax_sasr_insert_fence,
+    .wait_fence             = pax_sasr_wait_fence,
 };
-    #endif
 
 // Async software rendering engine.
 pax_render_engine_t const pax_render_engine_softasync = {
@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: MIT
 
 #include "pax_internal.h"
+#include "pax_renderer.h"
 
 
 
@@ -24,37 +25,80 @@ static int pax_pick_circle(matrix_2d_t const *matrix, float r, pax_vec2f const *
     }
 }
 
+// Draw an ellipse or elliptic ring with the given center and axes, ignoring matrix transform.
+// Ellipses are filled exactly one row at a time, so they are round at any size.
+static void simple_ellipse(pax_buf_t *buf, pax_col_t color, pax_vec2f center, pax_vec2f u, pax_vec2f v, float inner) {
+    PAX_BUF_CHECK(buf);
+    if (!pax_do_draw_col(buf, color))
+        return;
+
+    if (!isfinite(center.x) || !isfinite(center.y) || !isfinite(u.x) || !isfinite(u.y) || !isfinite(v.x)
+        || !isfinite(v.y)) {
+        // We can't draw to infinity.
+        PAX_ERROR(PAX_ERR_INF);
+    }
+
+#if CONFIG_PAX_COMPILE_ORIENTATION
+    // Rotate the center as a point and the axes as directions.
+    pax_vec2f origin = pax_orient_det_vec2f(buf, (pax_vec2f){0, 0});
+    center           = pax_orient_det_vec2f(buf, center);
+    u                = pax_orient_det_vec2f(buf, u);
+    v                = pax_orient_det_vec2f(buf, v);
+    u                = (pax_vec2f){u.x - origin.x, u.y - origin.y};
+    v                = (pax_vec2f){v.x - origin.x, v.y - origin.y};
+#endif
+
+    pax_ellipsef shape = {
+        .x     = center.x,
+        .y     = center.y,
+        .ux    = u.x,
+        .uy    = u.y,
+        .vx    = v.x,
+        .vy    = v.y,
+        .inner = inner,
+    };
+    pax_dispatch_unshaded_ellipse(buf, color, shape);
+}
+
+// Draw an ellipse or elliptic ring with the given radii, applying the matrix transform.
+static void draw_ellipse(pax_buf_t *buf, pax_col_t color, float x, float y, float rx, float ry, float inner) {
+    PAX_BUF_CHECK(buf);
+    // Any transform of an ellipse is another ellipse, with its axes transformed like directions.
+    matrix_2d_t matrix = buf->stack_2d.value;
+    matrix_2d_transform(matrix, &x, &y);
+    pax_vec2f u = {matrix.a0 * rx, matrix.b0 * rx};
+    pax_vec2f v = {matrix.a1 * ry, matrix.b1 * ry};
+    simple_ellipse(buf, color, (pax_vec2f){x, y}, u, v, inner);
+}
+
 
 // Draw a circle, ignoring matrix transform.
 void pax_simple_circle(pax_buf_t *buf, pax_col_t color, float x, float y, float r) {
-    pax_simple_arc(buf, color, x, y, r, 0, M_PI * 2);
+    simple_ellipse(buf, color, (pax_vec2f){x, y}, (pax_vec2f){r, 0}, (pax_vec2f){0, r}, 0);
 }
 
 // Draw a circle.
 void pax_draw_circle(pax_buf_t *buf, pax_col_t color, float x, float y, float r) {
-    PAX_BUF_CHECK(buf);
-    if (!pax_do_draw_col(buf, color))
-        return;
-
-    // Use precalcualted circles for speed because the user can't tell anyway.
-    pax_vec2f const *preset;
-    pax_trif const  *uv_set;
-    size_t           size = pax_pick_circle(&buf->stack_2d.value, r, &preset, &uv_set);
-
-    // Use the builtin matrix stuff to our advantage.
-    pax_push_2d(buf);
-    pax_apply_2d(buf, matrix_2d_translate(x, y));
-    pax_apply_2d(buf, matrix_2d_scale(r, r));
-    // Plot all the triangles in the ROM.
-    for (size_t i = 0; i < size - 1; i++) {
-        pax_draw_tri(buf, color, preset[0].x, preset[0].y, preset[i].x, preset[i].y, preset[i + 1].x, preset[i + 1].y);
-    }
-    pax_pop_2d(buf);
+    draw_ellipse(buf, color, x, y, r, r, 0);
 }
 
 // Draw a hollow circle.
 void pax_draw_hollow_circle(pax_buf_t *buf, pax_col_t color, float x, float y, float radius0, float radius1) {
-    pax_draw_hollow_arc(buf, color, x, y, radius0, radius1, 0, M_PI * 2);
+    float outer = fmaxf(fabsf(radius0), fabsf(radius1));
+    float inner = fminf(fabsf(radius0), fabsf(radius1));
+    if (outer > 0) {
+        draw_ellipse(buf, color, x, y, outer, outer, inner / outer);
+    }
+}
+
+// Draw an ellipse, ignoring matrix transform.
+void pax_simple_ellipse(pax_buf_t *buf, pax_col_t color, float x, float y, float rx, float ry) {
+    simple_ellipse(buf, color, (pax_vec2f){x, y}, (pax_vec2f){rx, 0}, (pax_vec2f){0, ry}, 0);
+}
+
+// Draw an ellipse.
+void pax_draw_ellipse(pax_buf_t *buf, pax_col_t color, float x, float y, float rx, float ry) {
+    draw_ellipse(buf, color, x, y, rx, ry, 0);
 }
 
 
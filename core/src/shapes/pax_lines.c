@@ -43,9 +43,10 @@ void pax_draw_line(pax_buf_t *buf, pax_col_t color, float x0, float y0, float x1
     pax_simple_line(buf, color, x0, y0, x1, y1);
 }
 
-// Draw a thick line using a rectangle.
-// Note: Will look different than `pax_draw_line` even if `thickness == 1`.
-void pax_draw_thick_line(pax_buf_t *buf, pax_col_t color, float x0, float y0, float x1, float y1, float thickness) {
+// Draw a thick line using a rectangle, optionally with anti-aliased edges.
+static void thick_line(
+    pax_buf_t *buf, pax_col_t color, float x0, float y0, float x1, float y1, float thickness, bool antialias
+) {
     pax_vec2f direction  = {x1 - x0, y1 - y0};
     pax_vec2f tangent    = pax_vec2f_unify((pax_vec2f){-direction.y, direction.x});
     tangent.x           *= thickness * 0.5f;
@@ -59,20 +60,32 @@ void pax_draw_thick_line(pax_buf_t *buf, pax_col_t color, float x0, float y0, fl
     for (int i = 0; i < 4; i++) {
         vert[i] = matrix_2d_transform_alt(buf->stack_2d.value, vert[i]);
     }
-    pax_dispatch_unshaded_quad(
-        buf,
-        color,
-        (pax_quadf){
-            vert[0].x,
-            vert[0].y,
-            vert[1].x,
-            vert[1].y,
-            vert[2].x,
-            vert[2].y,
-            vert[3].x,
-            vert[3].y,
-        }
-    );
+    pax_quadf shape = {
+        vert[0].x,
+        vert[0].y,
+        vert[1].x,
+        vert[1].y,
+        vert[2].x,
+        vert[2].y,
+        vert[3].x,
+        vert[3].y,
+    };
+    if (antialias) {
+        pax_dispatch_unshaded_quad_aa(buf, color, shape);
+    } else {
+        pax_dispatch_unshaded_quad(buf, color, shape);
+    }
+}
+
+// Draw a thick line using a rectangle.
+// Note: Will look different than `pax_draw_line` even if `thickness == 1`.
+void pax_draw_thick_line(pax_buf_t *buf, pax_col_t color, float x0, float y0, float x1, float y1, float thickness) {
+    thick_line(buf, color, x0, y0, x1, y1, thickness, false);
+}
+
+// Draw a thick line with anti-aliased edges using a rectangle.
+void pax_draw_thick_line_aa(pax_buf_t *buf, pax_col_t color, float x0, float y0, float x1, float y1, float thickness) {
+    thick_line(buf, color, x0, y0, x1, y1, thickness, true);
 }
 
 
@@ -508,7 +508,7 @@ void pax_background(pax_buf_t *buf, pax_col_t color) {
 void pax_buf_scroll(pax_buf_t *buf, pax_col_t placeholder, int x, int y) {
     PAX_BUF_CHECK(buf);
 #if CONFIG_PAX_COMPILE_ASYNC_RENDERER
-    pax_join();
+    pax_buf_join(buf);
 #endif
     // TODO: Make into render callback.
 
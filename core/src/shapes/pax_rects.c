@@ -76,153 +76,206 @@ void pax_draw_rect(pax_buf_t *buf, pax_col_t color, float x, float y, float widt
     }
 }
 
-// Draw a rounded rectangle.
-void pax_draw_round_rect(pax_buf_t *buf, pax_col_t color, float x, float y, float width, float height, float radius) {
-    if (radius <= 0) {
-        pax_draw_rect(buf, color, x, y, width, height);
-        return;
-    } else if (width == height && radius >= width) {
-        pax_draw_circle(buf, color, x + width * 0.5, y + width * 0.5, width * 0.5);
+// Draw a rectangle with anti-aliased edges.
+void pax_draw_rect_aa(pax_buf_t *buf, pax_col_t color, float x, float y, float width, float height) {
+    PAX_BUF_CHECK(buf);
+    if (!pax_do_draw_col(buf, color))
         return;
-    }
-
-    // Clamp size.
-    if (width < 0) {
-        x     += width;
-        width  = -width;
-    }
-    if (height < 0) {
-        y      += height;
-        height  = -height;
-    }
 
-    // Clamp radius.
-    if (radius < 0) {
-        radius = 0;
-    } else {
-        if (radius > width / 2) {
-            radius = width / 2;
-        }
-        if (radius > height / 2) {
-            radius = height / 2;
+    // Edges that don't fall on pixel boundaries are partially covered even without rotation, so this is always a quad.
+    matrix_2d_t mtx       = buf->stack_2d.value;
+    pax_vec2f   vertex[4] = {
+        matrix_2d_transform_alt(mtx, (pax_vec2f){x, y}),
+        matrix_2d_transform_alt(mtx, (pax_vec2f){x + width, y}),
+        matrix_2d_transform_alt(mtx, (pax_vec2f){x + width, y + height}),
+        matrix_2d_transform_alt(mtx, (pax_vec2f){x, y + height}),
+    };
+#if CONFIG_PAX_COMPILE_ORIENTATION
+    vertex[0] = pax_orient_det_vec2f(buf, vertex[0]);
+    vertex[1] = pax_orient_det_vec2f(buf, vertex[1]);
+    vertex[2] = pax_orient_det_vec2f(buf, vertex[2]);
+    vertex[3] = pax_orient_det_vec2f(buf, vertex[3]);
+#endif
+    pax_dispatch_unshaded_quad_aa(
+        buf,
+        color,
+        (pax_quadf){
+            vertex[0].x,
+            vertex[0].y,
+            vertex[1].x,
+            vertex[1].y,
+            vertex[2].x,
+            vertex[2].y,
+            vertex[3].x,
+            vertex[3].y,
         }
-    }
+    );
+}
 
-    // Draw corners.
-    pax_draw_arc(buf, color, x + radius, y + radius, radius, M_PI * 0.5, M_PI * 1.0);
-    pax_draw_arc(buf, color, x + width - radius, y + radius, radius, M_PI * 0.0, M_PI * 0.5);
-    pax_draw_arc(buf, color, x + width - radius, y + height - radius, radius, M_PI * 0.0, M_PI * -0.5);
-    pax_draw_arc(buf, color, x + radius, y + height - radius, radius, M_PI * -0.5, M_PI * -1.0);
+// Whether a matrix maps axis-aligned rectangles with round corners to axis-aligned rectangles with round corners.
+static bool is_round_rect_preserving(matrix_2d_t matrix) {
+    return (matrix.a1 == 0 && matrix.b0 == 0 && fabsf(matrix.a0) == fabsf(matrix.b1))
+           || (matrix.a0 == 0 && matrix.b1 == 0 && fabsf(matrix.a1) == fabsf(matrix.b0));
+}
 
-    // Draw infill.
-    if (width > 2 * radius) {
-        pax_draw_rect(buf, color, x + radius, y, width - 2 * radius, radius);
-        pax_draw_rect(buf, color, x + radius, y + height - radius, width - 2 * radius, radius);
-    }
-    if (height > 2 * radius) {
-        pax_draw_rect(buf, color, x, y + radius, width, height - 2 * radius);
+// Draw a rounded rectangle as a polygon, for transforms that don't keep it axis-aligned.
+// The radii start top-left and go clockwise, and must fit in the rectangle.
+static void draw_round_rect_poly(pax_buf_t *buf, pax_col_t color, pax_rectf rect, float const radii[4]) {
+    // Quarter circle divisions like `pax_draw_arc`, at most 12 per corner.
+    matrix_2d_t matrix = buf->stack_2d.value;
+    float       scale  = sqrtf(fabsf(matrix.a0 * matrix.b1 - matrix.a1 * matrix.b0));
+    pax_vec2f   points[4 * 13];
+    size_t      n_points = 0;
+    for (int i = 0; i < 4; i++) {
+        float r  = radii[i];
+        float cx = i == 1 || i == 2 ? rect.x + rect.w - r : rect.x + r;
+        float cy = i >= 2 ? rect.y + rect.h - r : rect.y + r;
+        int   n_div;
+        if (r * scale > 30) {
+            n_div = 12;
+        } else if (r * scale > 7) {
+            n_div = 8;
+        } else {
+            n_div = r > 0 ? 4 : 0;
+        }
+        // Corners go clockwise from the left edge, which is at half a turn.
+        for (int j = 0; j <= n_div; j++) {
+            float a            = M_PI * (1 + i * 0.5f) + (n_div ? M_PI * 0.5f * j / n_div : 0);
+            points[n_points++] = (pax_vec2f){cx + r * cosf(a), cy + r * sinf(a)};
+        }
     }
+    pax_draw_shape(buf, color, n_points, points);
 }
 
-// Draw a rounded rectangle with different radii per corner.
+// Draw a rounded rectangle with different radii per corner, applying the matrix transform.
 // The radii start top-left and go clockwise.
-void pax_draw_round_rect4(
-    pax_buf_t *buf, pax_col_t color, float x, float y, float width, float height, float r0, float r1, float r2, float r3
+static void draw_round_rect(
+    pax_buf_t *buf, pax_col_t color, float x, float y, float width, float height, float const radii_in[4], bool aa
 ) {
-    if (r0 <= 0) {
-        r0 = 0;
-    }
-    if (r1 <= 0) {
-        r1 = 0;
-    }
-    if (r2 <= 0) {
-        r2 = 0;
-    }
-    if (r3 <= 0) {
-        r3 = 0;
-    }
-    if (r0 == r1 && r1 == r2 && r2 == r3) {
-        pax_draw_round_rect(buf, color, x, y, width, height, r0);
+    PAX_BUF_CHECK(buf);
+    if (!pax_do_draw_col(buf, color))
         return;
-    }
 
     // Clamp size.
+    float radii[4] = {radii_in[0], radii_in[1], radii_in[2], radii_in[3]};
     if (width < 0) {
-        PAX_SWAP(float, r0, r1);
-        PAX_SWAP(float, r3, r2);
+        PAX_SWAP(float, radii[0], radii[1]);
+        PAX_SWAP(float, radii[3], radii[2]);
         x     += width;
         width  = -width;
     }
     if (height < 0) {
-        PAX_SWAP(float, r0, r3);
-        PAX_SWAP(float, r1, r2);
+        PAX_SWAP(float, radii[0], radii[3]);
+        PAX_SWAP(float, radii[1], radii[2]);
         y      += height;
         height  = -height;
     }
 
     // Clamp radius.
-    if (r0 > width / 2) {
-        r0 = width / 2;
-    }
-    if (r1 > width / 2) {
-        r1 = width / 2;
-    }
-    if (r2 > width / 2) {
-        r2 = width / 2;
-    }
-    if (r3 > width / 2) {
-        r3 = width / 2;
-    }
-    if (r0 > height / 2) {
-        r0 = height / 2;
-    }
-    if (r1 > height / 2) {
-        r1 = height / 2;
-    }
-    if (r2 > height / 2) {
-        r2 = height / 2;
-    }
-    if (r3 > height / 2) {
-        r3 = height / 2;
+    float max_radius = fminf(width, height) / 2;
+    for (int i = 0; i < 4; i++) {
+        radii[i] = radii[i] > 0 ? fminf(radii[i], max_radius) : 0;
     }
 
-    // Draw corners.
-    if (r0) {
-        pax_draw_arc(buf, color, x + r0, y + r0, r0, M_PI * 0.5, M_PI * 1.0);
-    }
-    if (r1) {
-        pax_draw_arc(buf, color, x + width - r1, y + r1, r1, M_PI * 0.0, M_PI * 0.5);
-    }
-    if (r2) {
-        pax_draw_arc(buf, color, x + width - r2, y + height - r2, r2, M_PI * 0.0, M_PI * -0.5);
-    }
-    if (r3) {
-        pax_draw_arc(buf, color, x + r3, y + height - r3, r3, M_PI * -0.5, M_PI * -1.0);
+    matrix_2d_t matrix = buf->stack_2d.value;
+    if (!is_round_rect_preserving(matrix)) {
+        // Anything else is no longer a rounded rectangle on screen, so it is drawn as a polygon without anti-aliasing.
+        draw_round_rect_poly(buf, color, (pax_rectf){x, y, width, height}, radii);
+        return;
     }
 
-    // Draw infill.
-    if (r0 && r1) {
-        pax_draw_rect(buf, color, x + r0, y, width - r0 - r1, fminf(r0, r1));
-    }
-    if (r0 != r1) {
-        pax_draw_rect(buf, color, r0 < r1 ? x : x + r0, y + fminf(r0, r1), width - fmaxf(r0, r1), fabsf(r0 - r1));
+    // Transform the corners, which may swap them around.
+    pax_vec2f corners[4] = {
+        matrix_2d_transform_alt(matrix, (pax_vec2f){x, y}),
+        matrix_2d_transform_alt(matrix, (pax_vec2f){x + width, y}),
+        matrix_2d_transform_alt(matrix, (pax_vec2f){x + width, y + height}),
+        matrix_2d_transform_alt(matrix, (pax_vec2f){x, y + height}),
+    };
+#if CONFIG_PAX_COMPILE_ORIENTATION
+    for (int i = 0; i < 4; i++) {
+        corners[i] = pax_orient_det_vec2f(buf, corners[i]);
     }
-    if (fmaxf(r0, r1) + fmaxf(r2, r3) < height) {
-        pax_draw_rect(buf, color, x, y + fmaxf(r0, r1), width, height - fmaxf(r0, r1) - fmaxf(r2, r3));
+#endif
+    float x0 = fminf(corners[0].x, corners[2].x);
+    float y0 = fminf(corners[0].y, corners[2].y);
+    float x1 = fmaxf(corners[0].x, corners[2].x);
+    float y1 = fmaxf(corners[0].y, corners[2].y);
+
+    // Give every radius to the corner it ended up at.
+    float scale = hypotf(matrix.a0, matrix.b0);
+    float r[4]  = {0};
+    for (int i = 0; i < 4; i++) {
+        bool right  = corners[i].x > (x0 + x1) * 0.5f;
+        bool bottom = corners[i].y > (y0 + y1) * 0.5f;
+        r[bottom ? 3 - right : right] = radii[i] * scale;
+    }
+
+    pax_round_rectf shape = {
+        .x  = x0,
+        .y  = y0,
+        .w  = x1 - x0,
+        .h  = y1 - y0,
+        .r0 = r[0],
+        .r1 = r[1],
+        .r2 = r[2],
+        .r3 = r[3],
+    };
+    if (!isfinite(shape.x) || !isfinite(shape.y) || !isfinite(shape.w) || !isfinite(shape.h) || !isfinite(scale)) {
+        // We can't draw to infinity.
+        PAX_ERROR(PAX_ERR_INF);
+    }
+    // Rounding may leave a radius just over half the transformed size.
+    max_radius = fminf(shape.w, shape.h) / 2;
+    shape.r0   = fminf(shape.r0, max_radius);
+    shape.r1   = fminf(shape.r1, max_radius);
+    shape.r2   = fminf(shape.r2, max_radius);
+    shape.r3   = fminf(shape.r3, max_radius);
+
+    if (aa) {
+        pax_dispatch_unshaded_round_rect_aa(buf, color, shape);
+    } else {
+        pax_dispatch_unshaded_round_rect(buf, color, shape);
     }
-    if (r3 != r2) {
-        pax_draw_rect(
-            buf,
-            color,
-            r3 < r2 ? x : x + r3,
-            y + height - fmaxf(r3, r2),
-            height - fmaxf(r3, r2),
-            fabsf(r3 - r2)
-        );
+}
+
+// Draw a rounded rectangle.
+void pax_draw_round_rect(pax_buf_t *buf, pax_col_t color, float x, float y, float width, float height, float radius) {
+    if (radius <= 0) {
+        pax_draw_rect(buf, color, x, y, width, height);
+        return;
     }
-    if (r2 && r3) {
-        pax_draw_rect(buf, color, x + r3, y + height - fminf(r3, r2), width - r3 - r2, fminf(r3, r2));
+    float radii[4] = {radius, radius, radius, radius};
+    draw_round_rect(buf, color, x, y, width, height, radii, false);
+}
+
+// Draw a rounded rectangle with different radii per corner.
+// The radii start top-left and go clockwise.
+void pax_draw_round_rect4(
+    pax_buf_t *buf, pax_col_t color, float x, float y, float width, float height, float r0, float r1, float r2, float r3
+) {
+    float radii[4] = {r0, r1, r2, r3};
+    draw_round_rect(buf, color, x, y, width, height, radii, false);
+}
+
+// Draw a rounded rectangle with anti-aliased edges.
+void pax_draw_round_rect_aa(
+    pax_buf_t *buf, pax_col_t color, float x, float y, float width, float height, float radius
+) {
+    if (radius <= 0) {
+        pax_draw_rect_aa(buf, color, x, y, width, height);
+        return;
     }
+    float radii[4] = {radius, radius, radius, radius};
+    draw_round_rect(buf, color, x, y, width, height, radii, true);
+}
+
+// Draw a rounded rectangle with different radii per corner and anti-aliased edges.
+// The radii start top-left and go clockwise.
+void pax_draw_round_rect4_aa(
+    pax_buf_t *buf, pax_col_t color, float x, float y, float width, float height, float r0, float r1, float r2, float r3
+) {
+    float radii[4] = {r0, r1, r2, r3};
+    draw_round_rect(buf, color, x, y, width, height, radii, true);
 }
 
 
@@ -9,8 +9,10 @@ static pax_trif const dummy_tri_uvs = {.x0 = 0, .y0 = 0, .x1 = 1, .y1 = 0, .x2 =
 
 
 
-// Draw a triangle, ignoring matrix transform.
-void pax_simple_tri(pax_buf_t *buf, pax_col_t color, float x0, float y0, float x1, float y1, float x2, float y2) {
+// Draw a triangle, ignoring matrix transform, optionally with anti-aliased edges.
+static void simple_tri(
+    pax_buf_t *buf, pax_col_t color, float x0, float y0, float x1, float y1, float x2, float y2, bool antialias
+) {
     PAX_BUF_CHECK(buf);
     if (!pax_do_draw_col(buf, color))
         return;
@@ -38,7 +40,21 @@ void pax_simple_tri(pax_buf_t *buf, pax_col_t color, float x0, float y0, float x
     y2             = tmp.y;
 #endif
 
-    pax_dispatch_unshaded_tri(buf, color, (pax_trif){x0, y0, x1, y1, x2, y2});
+    if (antialias) {
+        pax_dispatch_unshaded_tri_aa(buf, color, (pax_trif){x0, y0, x1, y1, x2, y2});
+    } else {
+        pax_dispatch_unshaded_tri(buf, color, (pax_trif){x0, y0, x1, y1, x2, y2});
+    }
+}
+
+// Draw a triangle, ignoring matrix transform.
+void pax_simple_tri(pax_buf_t *buf, pax_col_t color, float x0, float y0, float x1, float y1, float x2, float y2) {
+    simple_tri(buf, color, x0, y0, x1, y1, x2, y2, false);
+}
+
+// Draw a triangle with anti-aliased edges, ignoring matrix transform.
+void pax_simple_tri_aa(pax_buf_t *buf, pax_col_t color, float x0, float y0, float x1, float y1, float x2, float y2) {
+    simple_tri(buf, color, x0, y0, x1, y1, x2, y2, true);
 }
 
 
@@ -55,6 +71,19 @@ void pax_draw_tri(pax_buf_t *buf, pax_col_t color, float x0, float y0, float x1,
     pax_simple_tri(buf, color, x0, y0, x1, y1, x2, y2);
 }
 
+// Draw a triangle with anti-aliased edges.
+void pax_draw_tri_aa(pax_buf_t *buf, pax_col_t color, float x0, float y0, float x1, float y1, float x2, float y2) {
+    PAX_BUF_CHECK(buf);
+    if (!pax_do_draw_col(buf, color))
+        return;
+    // Apply the transforms.
+    matrix_2d_transform(buf->stack_2d.value, &x0, &y0);
+    matrix_2d_transform(buf->stack_2d.value, &x1, &y1);
+    matrix_2d_transform(buf->stack_2d.value, &x2, &y2);
+    // Draw the triangle.
+    pax_simple_tri_aa(buf, color, x0, y0, x1, y1, x2, y2);
+}
+
 // Draw a triangle outline.
 void pax_outline_tri(pax_buf_t *buf, pax_col_t color, float x0, float y0, float x1, float y1, float x2, float y2) {
     pax_draw_line(buf, color, x0, y0, x1, y1);